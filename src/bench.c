@@ -0,0 +1,687 @@
+#include "bench.h"
+#include "game/paddle.h"
+#include "game/ball.h"
+#include "game/stage.h"
+#include "game/score.h"
+#include "game/collision.h"
+#include "game/trajectory.h"
+#include "game/powerup.h"
+#include "states/game_state.h"
+#include "systems/snapshot.h"
+#include "systems/persist.h"
+#include "systems/audio.h"
+#include "systems/alloc_track.h"
+#include "systems/timer_wheel.h"
+#include "systems/task.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define FIXED_DT (1.0f / 60.0f)
+#define BENCH_SEED 1
+#define BENCH_BRICK_ROW_Y 150      // Stand-in brick row for the physics benchmark
+#define BENCH_SPEED_RESET 40       // Bounces between speed resets, keeps the ramp in use
+#define BENCH_PERSIST_FILE "bench_progress.bin"
+#define BENCH_PERSIST_BURST 500    // Requests per burst, one frame apart
+#define BENCH_AUDIO_TARGET_MS 10.0 // Event-to-sound budget
+#define BENCH_TRAJECTORY_BOUNCES 12
+#define BENCH_TRAJECTORY_TURN 0.05f    // What-if query: velocity turned by this many radians
+#define BENCH_TIMER_MAX_DELAY 36000    // Ticks (10 minutes at 60 Hz)
+#define BENCH_TASK_MAX_DELAY 300       // Ticks a task script sleeps (5 seconds)
+#define BENCH_TASK_EVENT_TYPES 4
+#define BENCH_TASK_EVENT_INTERVAL 3    // Ticks between events
+
+static GameContext bench_ctx;
+static Renderer bench_renderer;
+static Paddle bench_paddle;
+static Ball bench_ball;
+static Stage bench_stage;
+static EntityStore bench_entities;
+
+// Fresh gameplay session on a headless backend, identical on every run
+static bool bench_setup(RenderBackendType type) {
+    memset(&bench_ctx, 0, sizeof(bench_ctx));
+    if (!render_create(&bench_renderer, type, NULL)) {
+        return false;
+    }
+
+    // Fonts stay NULL: headless backends record text draws without rasterizing
+    bench_ctx.renderer = &bench_renderer;
+    bench_ctx.text_renderer.renderer = &bench_renderer;
+    bench_ctx.paddle = &bench_paddle;
+    bench_ctx.ball = &bench_ball;
+    bench_ctx.stage = &bench_stage;
+    bench_ctx.entities = &bench_entities;
+
+    sprite_init(&bench_renderer);
+    state_init(&bench_ctx);
+    bench_ctx.endless_mode = true;
+    bench_ctx.current_state = STATE_GAMEPLAY;
+
+    srand(BENCH_SEED);
+    score_init();
+    paddle_init(&bench_paddle, SCREEN_WIDTH / 2, SCREEN_HEIGHT - 40);
+    ball_init(&bench_ball, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+    bench_stage.seed = BENCH_SEED;
+    stage_init(&bench_stage, bench_ctx.current_stage);
+    entity_store_init(&bench_entities);
+    powerup_reset(&bench_entities);
+    return true;
+}
+
+// Keep the paddle under the ball and relaunch after stage clears so the run never idles.
+// The paddle offset drifts with the frame number to vary bounce angles.
+static void bench_autopilot(GameContext* ctx, int frame) {
+    if (!ctx->ball_launched) {
+        ball_launch(ctx->ball, (float)(-M_PI / 3.0));
+        ctx->ball_launched = true;
+    }
+    ctx->paddle->x = phys_to_float(ctx->ball->x) + (float)((frame / 120) % 7 - 3) * 12.0f;
+    paddle_move(ctx->paddle, 0.0f, 0.0f);  // Clamps to the screen
+}
+
+static bool bench_render_backend(RenderBackendType type, int frames) {
+    if (!bench_setup(type)) {
+        return false;
+    }
+
+    Uint64 update_ticks = 0;
+    Uint64 render_ticks = 0;
+    Uint64 present_ticks = 0;
+    RenderStats totals;
+    Uint64 run_hash = 14695981039346656037ULL;
+    memset(&totals, 0, sizeof(totals));
+
+    for (int i = 0; i < frames; i++) {
+        bench_autopilot(&bench_ctx, i);
+
+        Uint64 start = SDL_GetPerformanceCounter();
+        state_update(&bench_ctx, FIXED_DT);
+        Uint64 updated = SDL_GetPerformanceCounter();
+        state_render(&bench_ctx);
+        Uint64 rendered = SDL_GetPerformanceCounter();
+
+        update_ticks += updated - start;
+        render_ticks += (rendered - updated) - bench_renderer.present_ticks;
+        present_ticks += bench_renderer.present_ticks;
+
+        RenderStats* frame = &bench_renderer.last_frame;
+        totals.commands += frame->commands;
+        totals.fill_rects += frame->fill_rects;
+        totals.geometry_calls += frame->geometry_calls;
+        totals.vertices += frame->vertices;
+        totals.texts += frame->texts;
+
+        run_hash = (run_hash ^ bench_renderer.last_frame_hash) * 1099511628211ULL;
+    }
+
+    double us = 1000000.0 / (double)SDL_GetPerformanceFrequency() / frames;
+    printf("Render benchmark: %s backend, %d frames (reached stage %d, score %d)\n",
+           render_backend_name(type), frames, bench_ctx.current_stage, bench_ctx.score);
+    printf("  per frame: update %.2f us, render %.2f us, present %.2f us\n",
+           update_ticks * us, render_ticks * us, present_ticks * us);
+    printf("  commands/frame %.1f: %.2f geometry (%.1f vertices), %.2f fill rects, %.2f text\n",
+           (double)totals.commands / frames, (double)totals.geometry_calls / frames,
+           (double)totals.vertices / frames, (double)totals.fill_rects / frames,
+           (double)totals.texts / frames);
+    if (type == RENDER_BACKEND_RECORD) {
+        printf("  run hash %016llx\n", (unsigned long long)run_hash);
+    }
+
+    sprite_cleanup();
+    render_destroy(&bench_renderer);
+    return true;
+}
+
+bool bench_render(int frames) {
+    return bench_render_backend(RENDER_BACKEND_NULL, frames) &&
+           bench_render_backend(RENDER_BACKEND_RECORD, frames);
+}
+
+static Uint64 bench_hash_ball(Uint64 hash, const Ball* ball) {
+    phys_t state[4] = {ball->x, ball->y, ball->vx, ball->vy};
+    const Uint8* bytes = (const Uint8*)state;
+    for (size_t i = 0; i < sizeof(state); i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool bench_physics(int ticks) {
+    Paddle paddle;
+    Ball ball;
+    paddle_init(&paddle, SCREEN_WIDTH / 2, SCREEN_HEIGHT - 40);
+    ball_init(&ball, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+    ball_launch(&ball, (float)(-M_PI / 3.0));
+
+    phys_t brick_row = PHYS_FROM_INT(BENCH_BRICK_ROW_Y);
+    phys_t floor = PHYS_FROM_INT(SCREEN_HEIGHT);
+    Uint64 hash = 14695981039346656037ULL;
+    int bounces = 0;
+    int lost = 0;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < ticks; i++) {
+        int collisions = ball.collision_count;
+
+        ball_update(&ball, FIXED_DT);
+        collision_ball_walls(&ball, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+        paddle.x = phys_to_float(ball.x) + (float)((i / 600) % 7 - 3) * 12.0f;
+        paddle_move(&paddle, 0.0f, 0.0f);  // Clamps and updates bounds
+        if (collision_ball_paddle(&ball, &paddle)) {
+            collision_paddle_bounce(&ball, &paddle);
+        }
+
+        if (ball.y - ball.radius < brick_row && ball.vy < 0) {
+            collision_reflect_vertical(&ball);
+            ball_on_collision(&ball);
+        }
+
+        if (ball.y - ball.radius > floor) {
+            ball_reset(&ball, paddle.x);
+            ball_launch(&ball, (float)(-M_PI / 3.0));
+            lost++;
+        }
+
+        if (ball.collision_count != collisions) {
+            hash = bench_hash_ball(hash, &ball);
+            if (++bounces % BENCH_SPEED_RESET == 0) {
+                ball_reset_speed(&ball);
+            }
+        }
+    }
+    Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+
+#ifdef PHYSICS_FIXED
+    const char* mode = "fixed Q16.16";
+#else
+    const char* mode = "float";
+#endif
+    printf("Physics benchmark: %s, %d ticks, %d bounces, %d balls lost\n", mode, ticks, bounces, lost);
+    printf("  %.1f ns per tick\n", elapsed * 1000000000.0 / (double)SDL_GetPerformanceFrequency() / ticks);
+    printf("  state hash %016llx\n", (unsigned long long)hash);
+    return true;
+}
+
+// Full copies of recent ticks, to check what the rewind ring reconstructs
+static Snapshot bench_history[REWIND_MAX_TICKS + 1];
+
+bool bench_snapshot(int frames) {
+    if (!bench_setup(RENDER_BACKEND_NULL)) {
+        return false;
+    }
+    rewind_reset();
+
+    Uint64 capture_ticks = 0;
+    Uint64 push_ticks = 0;
+    Snapshot snap;
+    for (int i = 0; i < frames; i++) {
+        bench_autopilot(&bench_ctx, i);
+        state_update(&bench_ctx, FIXED_DT);
+
+        Uint64 start = SDL_GetPerformanceCounter();
+        snapshot_capture(&bench_ctx, &snap);
+        Uint64 captured = SDL_GetPerformanceCounter();
+        rewind_push(&snap);
+        push_ticks += SDL_GetPerformanceCounter() - captured;
+        capture_ticks += captured - start;
+
+        bench_history[i % (REWIND_MAX_TICKS + 1)] = snap;
+    }
+
+    int depth = rewind_depth();
+    int bytes = rewind_bytes_used();
+
+    // File round trip of the newest state
+    const char* path = "bench_snapshot.bin";
+    Uint64 start = SDL_GetPerformanceCounter();
+    bool saved = snapshot_save(&snap, path);
+    Uint64 save_ticks = SDL_GetPerformanceCounter() - start;
+    Snapshot loaded;
+    start = SDL_GetPerformanceCounter();
+    bool file_ok = saved && snapshot_load(path, &loaded) && memcmp(&loaded, &snap, sizeof(snap)) == 0;
+    Uint64 load_ticks = SDL_GetPerformanceCounter() - start;
+    remove(path);
+
+    // Step all the way back, applying each tick like the gameplay state does
+    Uint64 pop_ticks = 0;
+    Uint64 apply_ticks = 0;
+    int popped = 0;
+    while (true) {
+        start = SDL_GetPerformanceCounter();
+        bool more = rewind_pop(&snap);
+        Uint64 done = SDL_GetPerformanceCounter();
+        if (!more) {
+            break;
+        }
+        snapshot_apply(&bench_ctx, &snap);
+        apply_ticks += SDL_GetPerformanceCounter() - done;
+        pop_ticks += done - start;
+        popped++;
+    }
+
+    int oldest = frames - 1 - depth;
+    bool rewind_ok = oldest >= 0 &&
+        memcmp(&snap, &bench_history[oldest % (REWIND_MAX_TICKS + 1)], sizeof(snap)) == 0;
+
+    // Applying a snapshot has to restore everything it captured
+    Snapshot restored;
+    snapshot_capture(&bench_ctx, &restored);
+    bool apply_ok = memcmp(&restored, &snap, sizeof(snap)) == 0;
+
+    double us = 1000000.0 / (double)SDL_GetPerformanceFrequency();
+    printf("Snapshot benchmark: %d frames, %d bytes per snapshot\n", frames, (int)sizeof(Snapshot));
+    printf("  capture %.3f us, apply %.3f us, rewind push %.3f us, pop %.3f us\n",
+           capture_ticks * us / frames, popped ? apply_ticks * us / popped : 0.0,
+           push_ticks * us / frames, popped ? pop_ticks * us / popped : 0.0);
+    printf("  file save %.1f us, load %.1f us (%s)\n",
+           save_ticks * us, load_ticks * us, file_ok ? "ok" : "FAILED");
+    printf("  rewind ring: %d ticks (%.1f s) in %d of %d bytes, %.1f bytes per tick\n",
+           depth, depth / 60.0, bytes, REWIND_BUFFER_BYTES, depth ? (double)bytes / depth : 0.0);
+    printf("  rewind to tick %d: %s, state after apply: %s\n", oldest, rewind_ok ? "ok" : "MISMATCH",
+           apply_ok ? "ok" : "MISMATCH");
+
+    sprite_cleanup();
+    render_destroy(&bench_renderer);
+    return file_ok && rewind_ok && apply_ok;
+}
+
+bool bench_persist(int requests) {
+    remove(BENCH_PERSIST_FILE);
+    persist_init(BENCH_PERSIST_FILE);
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < requests; i++) {
+        persist_record_game(i, 1 + i % 10, i % 3 == 0);
+        if (i % BENCH_PERSIST_BURST == BENCH_PERSIST_BURST - 1) {
+            SDL_Delay(16);
+        }
+    }
+    double seconds = (SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+
+    PersistStats stats = persist_get_stats();
+    persist_shutdown();
+    stats.writes = persist_get_stats().writes;
+
+    // Reload: the file must hold the last request's state
+    persist_init(BENCH_PERSIST_FILE);
+    const SaveData* save = persist_data();
+    bool ok = save->games_played == requests && save->high_score == requests - 1 &&
+              save->games_completed == (requests + 2) / 3;
+    persist_shutdown();
+    remove(BENCH_PERSIST_FILE);
+
+    printf("Persist benchmark: %d requests in %.2f s, %d written\n", requests, seconds, stats.writes);
+    printf("  enqueue max %.2f us, avg %.3f us\n", stats.enqueue_max_us, stats.enqueue_avg_us);
+    printf("  reload: %s\n", ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+bool bench_audio(int events) {
+    if (!audio_init()) {
+        return false;
+    }
+
+    // Events at uneven gaps so they land all over the callback period, with
+    // an occasional burst to exercise voice stealing
+    Uint32 seed = 1;
+    for (int i = 0; i < events; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int burst = (seed >> 16) % 10 == 0 ? AUDIO_VOICES + 2 : 1;
+        for (int j = 0; j < burst; j++) {
+            audio_play((SoundId)((i + j) % SOUND_COUNT), SDL_MIX_MAXVOLUME, (int)((seed >> 8) % 257) - 128);
+        }
+        SDL_Delay(1 + (seed >> 20) % 12);
+    }
+    SDL_Delay(500);     // Let the last sounds play out
+
+    AudioStats stats = audio_get_stats();
+    audio_shutdown();
+
+    double p99_ms = stats.pickup_p99_ms + stats.buffer_ms;
+    bool mixed = stats.played > 0 && stats.peak > 0;
+    bool ok = mixed && p99_ms < BENCH_AUDIO_TARGET_MS;
+    printf("Audio benchmark: %d Hz, %d channels, %d-frame buffer (%.2f ms), %d callbacks\n",
+           stats.frequency, stats.channels, stats.samples, stats.buffer_ms, stats.callbacks);
+    printf("  %d played, %d dropped, %d voices stolen, peak %d\n",
+           stats.played, stats.dropped, stats.stolen, stats.peak);
+    printf("  pickup avg %.2f ms, p99 %.2f ms, max %.2f ms\n",
+           stats.pickup_avg_ms, stats.pickup_p99_ms, stats.pickup_max_ms);
+    printf("  event-to-sound p99 %.2f ms (%s %.0f ms), worst %.2f ms\n",
+           p99_ms, p99_ms < BENCH_AUDIO_TARGET_MS ? "under" : "OVER", BENCH_AUDIO_TARGET_MS,
+           stats.pickup_max_ms + stats.buffer_ms);
+    printf("  mixer: %s\n", mixed ? "ok" : "NO OUTPUT");
+    if (mixed && !ok) {
+        printf("  FAIL: event-to-sound p99 over the %.0f ms target\n", BENCH_AUDIO_TARGET_MS);
+    }
+    return ok;
+}
+
+typedef struct {
+    Uint64 hit_ticks;
+    Uint64 cast_ticks;
+    int hits;
+    int casts;
+} BenchTrajectoryTimes;
+
+static const Trajectory* bench_trajectory_query(const Ball* ball, BenchTrajectoryTimes* times) {
+    int casts_before = trajectory_get_stats().casts;
+    Uint64 start = SDL_GetPerformanceCounter();
+    const Trajectory* path = trajectory_predict(ball, &bench_stage, &bench_paddle,
+                                                BENCH_TRAJECTORY_BOUNCES);
+    Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+    if (trajectory_get_stats().casts > casts_before) {
+        times->cast_ticks += elapsed;
+        times->casts++;
+    } else {
+        times->hit_ticks += elapsed;
+        times->hits++;
+    }
+    return path;
+}
+
+bool bench_trajectory(int frames) {
+    if (!bench_setup(RENDER_BACKEND_NULL)) {
+        return false;
+    }
+    trajectory_cache_clear();
+
+    BenchTrajectoryTimes times = {0, 0, 0, 0};
+    int gameplay_hits = 0;
+
+    // Paddle contact predicted from the first query after a paddle bounce or launch
+    bool predicting = true;
+    bool have_prediction = false;
+    float predicted_x = 0.0f;
+    int checked = 0;
+    int within_paddle = 0;
+    double error_sum = 0.0;
+    float error_max = 0.0f;
+
+    for (int i = 0; i < frames; i++) {
+        bench_autopilot(&bench_ctx, i);
+
+        int hits_before = times.hits;
+        const Trajectory* path = bench_trajectory_query(&bench_ball, &times);
+        gameplay_hits += times.hits - hits_before;
+
+        // Predict once the ball has left the paddle (it can bounce on it for a few ticks)
+        if (predicting && bench_ctx.ball_launched &&
+            bench_ball.y + bench_ball.radius < PHYS_FROM_INT(bench_paddle.bounds.y)) {
+            predicting = false;
+            have_prediction = path->reaches_paddle;
+            if (have_prediction) {
+                predicted_x = path->contacts[path->count - 1].x;
+            }
+        }
+
+        // What-if: the same ball with its velocity turned a little
+        Ball turned = bench_ball;
+        float c = cosf(BENCH_TRAJECTORY_TURN);
+        float s = sinf(BENCH_TRAJECTORY_TURN);
+        float vx = phys_to_float(bench_ball.vx);
+        float vy = phys_to_float(bench_ball.vy);
+        turned.vx = phys_from_float(vx * c - vy * s);
+        turned.vy = phys_from_float(vx * s + vy * c);
+        bench_trajectory_query(&turned, &times);
+
+        bool falling = bench_ball.vy > 0;
+        state_update(&bench_ctx, FIXED_DT);
+
+        // Paddle bounce: score the prediction, then predict the next one
+        if (falling && bench_ball.vy < 0 && bench_ball.y > PHYS_FROM_INT(SCREEN_HEIGHT / 2)) {
+            if (have_prediction) {
+                float error = fabsf(phys_to_float(bench_ball.x) - predicted_x);
+                error_sum += error;
+                if (error > error_max) {
+                    error_max = error;
+                }
+                if (error < bench_paddle.width / 2.0f) {
+                    within_paddle++;
+                }
+                checked++;
+            }
+            predicting = true;
+            have_prediction = false;
+        }
+
+        // Lost ball or cleared stage: the ball is relaunched from the paddle
+        if (!bench_ctx.ball_launched) {
+            predicting = true;
+            have_prediction = false;
+        }
+    }
+
+    sprite_cleanup();
+    render_destroy(&bench_renderer);
+
+    double us = 1000000.0 / (double)SDL_GetPerformanceFrequency();
+    TrajectoryStats stats = trajectory_get_stats();
+    printf("Trajectory benchmark: %d frames, %d bounces per query (reached stage %d)\n",
+           frames, BENCH_TRAJECTORY_BOUNCES, bench_ctx.current_stage);
+    printf("  per query: cache hit %.3f us, cast %.2f us\n",
+           times.hits > 0 ? times.hit_ticks * us / times.hits : 0.0,
+           times.casts > 0 ? times.cast_ticks * us / times.casts : 0.0);
+    printf("  %d queries, %d casts; gameplay queries hit the cache %.1f%% of the time\n",
+           stats.queries, stats.casts, frames > 0 ? 100.0 * gameplay_hits / frames : 0.0);
+    if (checked > 0) {
+        printf("  paddle contact: %d predictions, mean error %.1f px, max %.1f px, %.1f%% within half a paddle\n",
+               checked, error_sum / checked, error_max, 100.0 * within_paddle / checked);
+    }
+    return true;
+}
+
+bool bench_alloc(int frames) {
+    if (!alloc_track_installed()) {
+        printf("Allocation tracking is not installed\n");
+        return false;
+    }
+    if (!bench_setup(RENDER_BACKEND_NULL)) {
+        return false;
+    }
+
+    // Warm-up: first-use allocations (stdout buffer, caches) happen here
+    for (int i = 0; i < BENCH_ALLOC_WARMUP; i++) {
+        bench_autopilot(&bench_ctx, i);
+        state_update(&bench_ctx, FIXED_DT);
+        state_render(&bench_ctx);
+    }
+    alloc_track_reset();
+
+    int first_frame = -1;
+    AllocCounts first_counts = {0, 0};
+    for (int i = 0; i < frames; i++) {
+        bench_autopilot(&bench_ctx, BENCH_ALLOC_WARMUP + i);
+        alloc_track_phase(ALLOC_PHASE_UPDATE);
+        state_update(&bench_ctx, FIXED_DT);
+        alloc_track_phase(ALLOC_PHASE_RENDER);
+        state_render(&bench_ctx);
+        alloc_track_frame_end();
+
+        AllocCounts frame = alloc_track_last_frame();
+        if (frame.count > 0 && first_frame < 0) {
+            first_frame = i;
+            first_counts = frame;
+        }
+    }
+
+    sprite_cleanup();
+    render_destroy(&bench_renderer);
+
+    printf("Allocation test: %d frames after %d warm-up (reached stage %d)\n",
+           frames, BENCH_ALLOC_WARMUP, bench_ctx.current_stage);
+    alloc_track_report();
+    if (first_frame >= 0) {
+        printf("  FAIL: frame %d allocated %llu times (%llu bytes)\n", first_frame,
+               (unsigned long long)first_counts.count, (unsigned long long)first_counts.bytes);
+        return false;
+    }
+    printf("  PASS: no allocations\n");
+    return true;
+}
+
+static TimerWheel bench_wheel;
+static int bench_timer_firings[BENCH_TIMER_COUNT];
+static Uint32 bench_timer_countdowns[BENCH_TIMER_COUNT];
+static int bench_timer_fired = 0;
+
+// Same delay sequence per timer in both runs
+static Uint32 bench_timer_delay(int index, int firing) {
+    Uint32 h = ((Uint32)index * 2654435761u) ^ ((Uint32)firing * 2246822519u) ^ BENCH_SEED;
+    h ^= h >> 15;
+    h *= 2654435761u;
+    h ^= h >> 13;
+    return 1 + h % BENCH_TIMER_MAX_DELAY;
+}
+
+static void bench_timer_fire(void* userdata, int index) {
+    bench_timer_fired++;
+    int firing = ++bench_timer_firings[index];
+    timer_wheel_schedule(&bench_wheel, bench_timer_delay(index, firing), bench_timer_fire, NULL, index);
+}
+
+bool bench_timers(int ticks) {
+    double us = 1000000.0 / SDL_GetPerformanceFrequency();
+
+    // Timer wheel: every timer re-arms itself when it fires
+    timer_wheel_init(&bench_wheel);
+    memset(bench_timer_firings, 0, sizeof(bench_timer_firings));
+    bench_timer_fired = 0;
+    for (int i = 0; i < BENCH_TIMER_COUNT; i++) {
+        timer_wheel_schedule(&bench_wheel, bench_timer_delay(i, 0), bench_timer_fire, NULL, i);
+    }
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int t = 0; t < ticks; t++) {
+        timer_wheel_tick(&bench_wheel);
+    }
+    Uint64 wheel_ticks = SDL_GetPerformanceCounter() - start;
+    int wheel_fired = bench_timer_fired;
+    TimerWheelStats stats = timer_wheel_get_stats(&bench_wheel);
+
+    // Reference: a countdown per timer, all decremented every tick
+    memset(bench_timer_firings, 0, sizeof(bench_timer_firings));
+    int scan_fired = 0;
+    for (int i = 0; i < BENCH_TIMER_COUNT; i++) {
+        bench_timer_countdowns[i] = bench_timer_delay(i, 0);
+    }
+    start = SDL_GetPerformanceCounter();
+    for (int t = 0; t < ticks; t++) {
+        for (int i = 0; i < BENCH_TIMER_COUNT; i++) {
+            if (--bench_timer_countdowns[i] == 0) {
+                scan_fired++;
+                bench_timer_countdowns[i] = bench_timer_delay(i, ++bench_timer_firings[i]);
+            }
+        }
+    }
+    Uint64 scan_ticks = SDL_GetPerformanceCounter() - start;
+
+    printf("Timer benchmark: %d timers re-arming with delays up to %d ticks, %d ticks\n",
+           BENCH_TIMER_COUNT, BENCH_TIMER_MAX_DELAY, ticks);
+    printf("  timer wheel: %.3f us/tick, %d fired, %.2f cascaded per tick, peak %d pending\n",
+           wheel_ticks * us / ticks, wheel_fired, (double)stats.cascaded / ticks, stats.peak);
+    printf("  linear scan: %.3f us/tick, %d fired\n", scan_ticks * us / ticks, scan_fired);
+    if (wheel_fired != scan_fired) {
+        printf("  FAIL: the timer wheel fired %d timers, the reference %d\n", wheel_fired, scan_fired);
+        return false;
+    }
+    return true;
+}
+
+static TaskScheduler bench_scheduler;
+static int bench_task_steps = 0;
+
+// Sleep, then wait for event type (index % 4); locals[0] counts the sleeps
+static Uint32 bench_task_delay(int index, int sleep) {
+    return 1 + bench_timer_delay(index, sleep) % BENCH_TASK_MAX_DELAY;
+}
+
+static TaskStatus bench_task_script(TaskScheduler* sched, Task* task) {
+    TASK_BEGIN(task);
+    while (true) {
+        TASK_WAIT_TICKS(task, bench_task_delay(task->arg, task->locals[0]));
+        task->locals[0]++;
+        bench_task_steps++;
+        TASK_WAIT_EVENT(task, 1u << (task->arg % BENCH_TASK_EVENT_TYPES));
+        bench_task_steps++;
+    }
+    TASK_END(task);
+}
+
+typedef struct {
+    bool sleeping;
+    Uint32 countdown;
+    int sleeps;
+} BenchTaskState;
+
+static BenchTaskState bench_task_states[BENCH_TASK_COUNT];
+
+bool bench_tasks(int ticks) {
+    double us = 1000000.0 / SDL_GetPerformanceFrequency();
+
+    // Scheduler: tasks cost nothing until their tick or event comes up
+    task_scheduler_init(&bench_scheduler);
+    bench_task_steps = 0;
+    for (int i = 0; i < BENCH_TASK_COUNT; i++) {
+        task_spawn(&bench_scheduler, bench_task_script, NULL, i);
+    }
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int t = 1; t <= ticks; t++) {
+        task_scheduler_tick(&bench_scheduler);
+        if (t % BENCH_TASK_EVENT_INTERVAL == 0) {
+            int type = (t / BENCH_TASK_EVENT_INTERVAL) % BENCH_TASK_EVENT_TYPES;
+            task_scheduler_notify(&bench_scheduler, type, NULL);
+        }
+    }
+    Uint64 task_ticks = SDL_GetPerformanceCounter() - start;
+    int task_steps = bench_task_steps;
+    TaskStats stats = task_scheduler_get_stats(&bench_scheduler);
+
+    // Reference: the same scripts as hand-written per-task state, all polled
+    // every tick (the first sleep starts on tick 1, like a spawned task's)
+    int scan_steps = 0;
+    for (int i = 0; i < BENCH_TASK_COUNT; i++) {
+        bench_task_states[i].sleeping = true;
+        bench_task_states[i].countdown = bench_task_delay(i, 0) + 1;
+        bench_task_states[i].sleeps = 0;
+    }
+    start = SDL_GetPerformanceCounter();
+    for (int t = 1; t <= ticks; t++) {
+        for (int i = 0; i < BENCH_TASK_COUNT; i++) {
+            BenchTaskState* state = &bench_task_states[i];
+            if (state->sleeping && --state->countdown == 0) {
+                state->sleeping = false;
+                state->sleeps++;
+                scan_steps++;
+            }
+        }
+        if (t % BENCH_TASK_EVENT_INTERVAL == 0) {
+            int type = (t / BENCH_TASK_EVENT_INTERVAL) % BENCH_TASK_EVENT_TYPES;
+            for (int i = 0; i < BENCH_TASK_COUNT; i++) {
+                BenchTaskState* state = &bench_task_states[i];
+                if (!state->sleeping && i % BENCH_TASK_EVENT_TYPES == type) {
+                    state->sleeping = true;
+                    state->countdown = bench_task_delay(i, state->sleeps);
+                    scan_steps++;
+                }
+            }
+        }
+    }
+    Uint64 scan_ticks = SDL_GetPerformanceCounter() - start;
+
+    printf("Task benchmark: %d tasks sleeping up to %d ticks and waiting for %d event types, %d ticks\n",
+           BENCH_TASK_COUNT, BENCH_TASK_MAX_DELAY, BENCH_TASK_EVENT_TYPES, ticks);
+    printf("  scheduler: %.3f us/tick, %d steps, %.1f resumes per tick, peak %d tasks\n",
+           task_ticks * us / ticks, task_steps, (double)stats.resumed / ticks, stats.peak);
+    printf("  polling:   %.3f us/tick, %d steps\n", scan_ticks * us / ticks, scan_steps);
+    if (task_steps != scan_steps) {
+        printf("  FAIL: the scheduler stepped the scripts %d times, the reference %d\n", task_steps, scan_steps);
+        return false;
+    }
+    return true;
+}
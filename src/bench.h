@@ -0,0 +1,77 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdbool.h>
+
+// Headless benchmarks run from the command line (no window or GPU needed)
+
+#define BENCH_RENDER_FRAMES 10000
+#define BENCH_PHYSICS_TICKS 1000000
+#define BENCH_SNAPSHOT_FRAMES 5000
+#define BENCH_PERSIST_REQUESTS 20000
+#define BENCH_AUDIO_EVENTS 1000
+#define BENCH_ALLOC_WARMUP 600
+#define BENCH_ALLOC_FRAMES 3000
+#define BENCH_TRAJECTORY_FRAMES 20000
+#define BENCH_TIMER_COUNT 4000
+#define BENCH_TIMER_TICKS 216000            // An hour of fixed ticks
+#define BENCH_TASK_COUNT 4000
+#define BENCH_TASK_TICKS 216000
+
+// Play gameplay frames with an autopilot paddle on the null and record
+// render backends. Prints update, render (command generation) and present
+// cost per frame, command counts, and the record backend's run hash for
+// regression checks.
+bool bench_render(int frames);
+
+// Step the ball alone (walls, autopilot paddle, a stand-in brick row) at the
+// fixed timestep. Prints the cost per tick and a hash of the ball state at
+// every bounce; build with and without PHYSICS_FIXED to compare the paths.
+// The fixed-point hash is the same on every platform.
+bool bench_physics(int ticks);
+
+// Play headless gameplay while recording a snapshot per tick into the rewind
+// ring. Prints capture/apply/push/pop and file save/load cost, the ring's
+// depth and memory use, then rewinds all the way back and checks the result
+// against a full copy taken on that tick.
+bool bench_snapshot(int frames);
+
+// Hammer the save queue with bursts of requests while the writer thread
+// writes to a scratch file. Prints worst-case and average enqueue latency
+// and how many requests coalesced, then reloads the file to check it holds
+// the final state.
+bool bench_persist(int requests);
+
+// Open the audio device and fire sound events at uneven intervals. Prints
+// the time from audio_play() to the callback that starts the sound, the
+// device buffer length, and voice stealing. Fails if nothing was mixed or
+// the p99 event-to-sound latency misses the 10 ms target. Run with
+// SDL_AUDIODRIVER=dummy or disk to measure without a sound card.
+bool bench_audio(int events);
+
+// Play headless gameplay querying the ball's predicted path every tick, plus
+// a what-if query with a slightly turned velocity. Prints query cost for
+// cache hits and casts, the hit rate, and how far the paddle contact
+// predicted as the ball leaves the paddle was from the real one.
+bool bench_trajectory(int frames);
+
+// Zero-allocation check: play BENCH_ALLOC_WARMUP headless gameplay frames,
+// then fail if any of the next frames allocates on the main thread (needs
+// allocation tracking installed, see --test-alloc). Prints counts per phase
+// and the first offending frame.
+bool bench_alloc(int frames);
+
+// Keep BENCH_TIMER_COUNT timers pending on the power-up timer wheel (each
+// re-arms itself with a new delay when it fires) and step it one fixed tick
+// at a time. Prints the cost per tick next to a per-timer countdown scan
+// and fails if the two fire a different number of timers.
+bool bench_timers(int ticks);
+
+// Keep BENCH_TASK_COUNT scripted tasks running on the task scheduler, each
+// looping "sleep a few seconds, then wait for one of four event types",
+// with an event every few ticks. Prints the cost per tick next to per-task
+// countdowns and event checks polled every tick, and fails if the two step
+// the scripts a different number of times.
+bool bench_tasks(int ticks);
+
+#endif // BENCH_H
@@ -0,0 +1,383 @@
+#include "fuzz.h"
+#include "game/paddle.h"
+#include "game/ball.h"
+#include "game/stage.h"
+#include "game/collision.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define FUZZ_DT (1.0f / 60.0f)
+#define FUZZ_BASE_SEED 0x5EED0001u
+#define FUZZ_SPIKE_ODDS 64              // One frame in this many is a hitch
+#define FUZZ_SPIKE_MAX_TICKS 15         // main_loop clamps frame time to 0.25 s
+#define FUZZ_INPUT_HOLD_MAX 30          // Frames an input is held
+#define FUZZ_STAGES_GENERATED 20        // Generated stage numbers tried
+#define FUZZ_STUCK_HITS 3               // Consecutive hits on one brick
+#define FUZZ_WALL_EPSILON 0.01f         // Pixels
+#define FUZZ_SPEED_TOLERANCE 0.005f     // Rounding in the fixed-point build
+#define FUZZ_MIN_VERTICAL 0.01f         // Share of the speed that has to be vertical
+#define FUZZ_TRACE_TICKS 8
+
+static const char* invariant_names[FUZZ_INVARIANT_COUNT] = {
+    "ok", "not finite", "outside walls", "over speed", "stuck in brick", "no vertical motion",
+    "paddle outside"
+};
+
+typedef struct {
+    int tick;
+    Ball ball;
+    float paddle_x;
+    float direction;
+    int brick;
+} FuzzTrace;
+
+// Everything one worker touches
+typedef struct {
+    Ball ball;
+    Paddle paddle;
+    Stage stage;
+    int scratch[STAGE_SCRATCH_INTS];
+    Uint32 rng;
+    Uint64 ticks_run;
+    FuzzTrace trace[FUZZ_TRACE_TICKS];
+} FuzzWorld;
+
+static FuzzWorld s_worlds[FUZZ_MAX_THREADS];
+
+// Shared between workers
+static SDL_atomic_t s_next_case;
+static int s_case_count = 0;
+static SDL_mutex* s_lock = NULL;
+static int s_failures[FUZZ_INVARIANT_COUNT];
+static int s_kept[FUZZ_INVARIANT_COUNT];    // Reproducers claimed per invariant
+static FuzzCase s_repros[FUZZ_MAX_REPROS];
+static FuzzInvariant s_repro_invariants[FUZZ_MAX_REPROS];
+static int s_repro_count = 0;
+
+static Uint32 fuzz_random(Uint32* state) {
+    Uint32 x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static Uint32 fuzz_case_seed(int index) {
+    Uint32 h = FUZZ_BASE_SEED ^ ((Uint32)index * 2654435761u);
+    h ^= h >> 16;
+    h *= 2246822519u;
+    h ^= h >> 13;
+    return h ? h : 1;
+}
+
+// Built-in layouts only, so a seed means the same case from any directory
+// and workers never touch the file system
+static void fuzz_new_stage(FuzzWorld* world, const FuzzCase* fuzz_case) {
+    int number = (fuzz_case->features & FUZZ_GENERATED_STAGE)
+        ? STAGE_HANDBUILT_COUNT + 1 + (int)(fuzz_random(&world->rng) % FUZZ_STAGES_GENERATED)
+        : 1 + (int)(fuzz_random(&world->rng) % STAGE_HANDBUILT_COUNT);
+    world->stage.seed = fuzz_random(&world->rng);
+    stage_build_builtin(&world->stage, number, world->scratch);
+}
+
+static void fuzz_launch(FuzzWorld* world, const FuzzCase* fuzz_case) {
+    float angle = (float)(-M_PI / 3.0);
+    if (fuzz_case->features & FUZZ_RANDOM_ANGLES) {
+        int degrees = (int)(fuzz_random(&world->rng) % 121) - 60;
+        angle = (float)(-M_PI / 2.0 + degrees * M_PI / 180.0);
+    }
+    ball_reset(&world->ball, world->paddle.x);
+    ball_reset_speed(&world->ball);
+    ball_launch(&world->ball, angle);
+
+    if (fuzz_case->features & FUZZ_FAST_LAUNCH) {
+        int steps = (int)(fuzz_random(&world->rng) % (BALL_SPEED_STEPS + 4));
+        for (int i = 0; i < steps; i++) {
+            ball_on_collision(&world->ball);
+        }
+    }
+}
+
+static FuzzInvariant fuzz_check(const FuzzWorld* world, int same_brick_hits) {
+    const Ball* ball = &world->ball;
+    float x = phys_to_float(ball->x);
+    float y = phys_to_float(ball->y);
+    float vx = phys_to_float(ball->vx);
+    float vy = phys_to_float(ball->vy);
+    float radius = phys_to_float(ball->radius);
+    if (!isfinite(x) || !isfinite(y) || !isfinite(vx) || !isfinite(vy)) {
+        return FUZZ_NOT_FINITE;
+    }
+    if (x - radius < -FUZZ_WALL_EPSILON || x + radius > SCREEN_WIDTH + FUZZ_WALL_EPSILON ||
+        y - radius < -FUZZ_WALL_EPSILON) {
+        return FUZZ_OUTSIDE_WALLS;
+    }
+
+    float speed = sqrtf(vx * vx + vy * vy);
+    float max_speed = phys_to_float(ball->base_speed) * BALL_MAX_SPEED_MULTIPLIER;
+    if (speed > max_speed * (1.0f + FUZZ_SPEED_TOLERANCE)) {
+        return FUZZ_OVER_SPEED;
+    }
+    if (same_brick_hits >= FUZZ_STUCK_HITS) {
+        return FUZZ_STUCK_IN_BRICK;
+    }
+    if (fabsf(vy) < speed * FUZZ_MIN_VERTICAL) {
+        return FUZZ_NO_VERTICAL;
+    }
+
+    const SDL_Rect* paddle = &world->paddle.bounds;
+    if (paddle->x < 0 || paddle->x + paddle->w > SCREEN_WIDTH) {
+        return FUZZ_PADDLE_OUTSIDE;
+    }
+    return FUZZ_OK;
+}
+
+// Run a case until it fails (returns the invariant, *fail_tick set) or ends
+static FuzzInvariant fuzz_run(FuzzWorld* world, const FuzzCase* fuzz_case, int* fail_tick, bool trace) {
+    world->rng = fuzz_case->seed ? fuzz_case->seed : 1;
+    fuzz_new_stage(world, fuzz_case);
+    paddle_init(&world->paddle, SCREEN_WIDTH / 2, SCREEN_HEIGHT - 40);
+    ball_init(&world->ball, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+    fuzz_launch(world, fuzz_case);
+
+    float direction = 0.0f;
+    int hold = 0;
+    int mode = 0;
+    int last_brick = -1;
+    int same_brick_hits = 0;
+    int tick = 0;
+    while (tick < fuzz_case->ticks) {
+        // A hitch: main_loop catches up with several ticks on one input sample
+        int frame_ticks = 1;
+        if ((fuzz_case->features & FUZZ_FRAME_SPIKES) && fuzz_random(&world->rng) % FUZZ_SPIKE_ODDS == 0) {
+            frame_ticks = 2 + (int)(fuzz_random(&world->rng) % (FUZZ_SPIKE_MAX_TICKS - 1));
+        }
+
+        // Held left, right or still, or chasing the ball (which keeps it in play)
+        if (fuzz_case->features & FUZZ_PADDLE_INPUT) {
+            if (--hold <= 0) {
+                Uint32 roll = fuzz_random(&world->rng);
+                hold = 1 + (int)(roll % FUZZ_INPUT_HOLD_MAX);
+                mode = (int)((roll >> 8) % 4);
+            }
+            float ball_x = phys_to_float(world->ball.x);
+            direction = mode == 0 ? -1.0f : mode == 1 ? 1.0f : mode == 2 ? 0.0f
+                      : ball_x < world->paddle.x ? -1.0f : 1.0f;
+        }
+
+        for (int i = 0; i < frame_ticks && tick < fuzz_case->ticks; i++, tick++) {
+            paddle_move(&world->paddle, direction, FUZZ_DT);
+            paddle_update(&world->paddle, FUZZ_DT);
+
+            CollisionStep step;
+            collision_step(&world->ball, &world->paddle, &world->stage, SCREEN_WIDTH, SCREEN_HEIGHT,
+                           FUZZ_DT, &step);
+            same_brick_hits = step.brick >= 0 && step.brick == last_brick ? same_brick_hits + 1 : 0;
+            last_brick = step.brick;
+
+            if (trace) {
+                FuzzTrace* entry = &world->trace[tick % FUZZ_TRACE_TICKS];
+                entry->tick = tick;
+                entry->ball = world->ball;
+                entry->paddle_x = world->paddle.x;
+                entry->direction = direction;
+                entry->brick = step.brick;
+            }
+
+            FuzzInvariant invariant = fuzz_check(world, same_brick_hits);
+            if (invariant != FUZZ_OK) {
+                *fail_tick = tick;
+                return invariant;
+            }
+
+            if (step.lost) {
+                fuzz_launch(world, fuzz_case);
+                last_brick = -1;
+            } else if (step.brick_destroyed && stage_is_cleared(&world->stage)) {
+                fuzz_new_stage(world, fuzz_case);
+                fuzz_launch(world, fuzz_case);
+                last_brick = -1;
+            }
+        }
+    }
+    return FUZZ_OK;
+}
+
+// Switch off every feature the failure doesn't need, and end at the failure
+static FuzzCase fuzz_shrink(FuzzWorld* world, FuzzCase fuzz_case, FuzzInvariant invariant, int fail_tick) {
+    fuzz_case.ticks = fail_tick + 1;
+    for (Uint32 feature = 1; feature & FUZZ_ALL_FEATURES; feature <<= 1) {
+        if (!(fuzz_case.features & feature)) {
+            continue;
+        }
+        FuzzCase simpler = {fuzz_case.seed, fuzz_case.features & ~feature, FUZZ_CASE_TICKS};
+        int tick;
+        if (fuzz_run(world, &simpler, &tick, false) == invariant) {
+            simpler.ticks = tick + 1;
+            fuzz_case = simpler;
+        }
+    }
+    return fuzz_case;
+}
+
+static int fuzz_worker(void* data) {
+    FuzzWorld* world = (FuzzWorld*)data;
+    while (true) {
+        int index = SDL_AtomicAdd(&s_next_case, 1);
+        if (index >= s_case_count) {
+            break;
+        }
+
+        FuzzCase fuzz_case = {fuzz_case_seed(index), FUZZ_ALL_FEATURES, FUZZ_CASE_TICKS};
+        int tick = 0;
+        FuzzInvariant invariant = fuzz_run(world, &fuzz_case, &tick, false);
+        world->ticks_run += invariant == FUZZ_OK ? (Uint64)fuzz_case.ticks : (Uint64)tick + 1;
+        if (invariant == FUZZ_OK) {
+            continue;
+        }
+
+        SDL_LockMutex(s_lock);
+        bool keep = s_kept[invariant] < FUZZ_REPROS_PER_INVARIANT;
+        if (keep) {
+            s_kept[invariant]++;
+        }
+        s_failures[invariant]++;
+        SDL_UnlockMutex(s_lock);
+        if (!keep) {
+            continue;
+        }
+
+        // Shrinking reruns the case a few times: only for failures that are kept
+        FuzzCase repro = fuzz_shrink(world, fuzz_case, invariant, tick);
+        SDL_LockMutex(s_lock);
+        s_repros[s_repro_count] = repro;
+        s_repro_invariants[s_repro_count] = invariant;
+        s_repro_count++;
+        SDL_UnlockMutex(s_lock);
+    }
+    return 0;
+}
+
+bool fuzz_physics(int cases) {
+    int threads = SDL_GetCPUCount();
+    if (threads < 1) {
+        threads = 1;
+    } else if (threads > FUZZ_MAX_THREADS) {
+        threads = FUZZ_MAX_THREADS;
+    }
+
+    SDL_AtomicSet(&s_next_case, 0);
+    s_case_count = cases;
+    memset(s_failures, 0, sizeof(s_failures));
+    memset(s_kept, 0, sizeof(s_kept));
+    s_repro_count = 0;
+    s_lock = SDL_CreateMutex();
+    for (int i = 0; i < threads; i++) {
+        s_worlds[i].ticks_run = 0;
+    }
+
+    // Without threads (or a mutex) the calling thread does all the work
+    SDL_Thread* workers[FUZZ_MAX_THREADS];
+    int started = 0;
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 0; s_lock && i < threads; i++) {
+        workers[started] = SDL_CreateThread(fuzz_worker, "fuzz", &s_worlds[started]);
+        if (workers[started]) {
+            started++;
+        }
+    }
+    if (started == 0) {
+        fuzz_worker(&s_worlds[0]);
+    }
+    for (int i = 0; i < started; i++) {
+        SDL_WaitThread(workers[i], NULL);
+    }
+    double seconds = (SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+    if (s_lock) {
+        SDL_DestroyMutex(s_lock);
+        s_lock = NULL;
+    }
+
+    Uint64 ticks = 0;
+    int failed = 0;
+    for (int i = 0; i < FUZZ_MAX_THREADS; i++) {
+        ticks += s_worlds[i].ticks_run;
+    }
+    for (int i = 1; i < FUZZ_INVARIANT_COUNT; i++) {
+        failed += s_failures[i];
+    }
+
+#ifdef PHYSICS_FIXED
+    const char* mode = "fixed Q16.16";
+#else
+    const char* mode = "float";
+#endif
+    printf("Physics fuzzer: %s, %d cases of up to %d ticks on %d threads\n",
+           mode, cases, FUZZ_CASE_TICKS, started > 0 ? started : 1);
+    printf("  %llu ticks in %.2f s (%.1f M ticks/s)\n", (unsigned long long)ticks, seconds,
+           ticks / seconds / 1000000.0);
+    for (int i = 1; i < FUZZ_INVARIANT_COUNT; i++) {
+        if (s_failures[i] > 0) {
+            printf("  %-20s %d cases\n", invariant_names[i], s_failures[i]);
+        }
+    }
+    if (failed == 0) {
+        printf("  PASS: no invariant broken\n");
+        remove(FUZZ_REPRO_FILE);
+        return true;
+    }
+
+    FILE* file = fopen(FUZZ_REPRO_FILE, "w");
+    for (int i = 0; file && i < s_repro_count; i++) {
+        fprintf(file, "%08x:%02x:%d %s\n", (unsigned)s_repros[i].seed, (unsigned)s_repros[i].features,
+                s_repros[i].ticks, invariant_names[s_repro_invariants[i]]);
+    }
+    if (file) {
+        fclose(file);
+    }
+    printf("  FAIL: %d of %d cases; %d shrunk reproducers in %s (run one with --fuzz-replay=<first column>)\n",
+           failed, cases, s_repro_count, FUZZ_REPRO_FILE);
+    return false;
+}
+
+bool fuzz_replay(const char* spec) {
+    FuzzCase fuzz_case;
+    unsigned seed, features;
+    if (sscanf(spec, "%x:%x:%d", &seed, &features, &fuzz_case.ticks) != 3 || fuzz_case.ticks <= 0) {
+        printf("Invalid fuzz case '%s' (seed:features:ticks, as in %s)\n", spec, FUZZ_REPRO_FILE);
+        return false;
+    }
+    fuzz_case.seed = seed;
+    fuzz_case.features = features & FUZZ_ALL_FEATURES;
+
+    FuzzWorld* world = &s_worlds[0];
+    int tick = 0;
+    FuzzInvariant invariant = fuzz_run(world, &fuzz_case, &tick, true);
+    printf("Fuzz case %08x:%02x:%d (ended on stage %d)\n", seed, (unsigned)fuzz_case.features, fuzz_case.ticks,
+           world->stage.stage_number);
+    if (invariant == FUZZ_OK) {
+        printf("  PASS: no invariant broken\n");
+        return true;
+    }
+
+    int first = tick + 1 > FUZZ_TRACE_TICKS ? tick + 1 - FUZZ_TRACE_TICKS : 0;
+    for (int t = first; t <= tick; t++) {
+        const FuzzTrace* entry = &world->trace[t % FUZZ_TRACE_TICKS];
+        printf("  tick %6d: ball (%.2f, %.2f) v (%.2f, %.2f), paddle %.1f (%+.0f), brick %d\n",
+               entry->tick, phys_to_float(entry->ball.x), phys_to_float(entry->ball.y),
+               phys_to_float(entry->ball.vx), phys_to_float(entry->ball.vy),
+               entry->paddle_x, entry->direction, entry->brick);
+    }
+    printf("  FAIL: %s at tick %d\n", invariant_names[invariant], tick);
+    return false;
+}
+
+const char* fuzz_invariant_name(FuzzInvariant invariant) {
+    return invariant >= 0 && invariant < FUZZ_INVARIANT_COUNT ? invariant_names[invariant] : "?";
+}
@@ -0,0 +1,67 @@
+#ifndef FUZZ_H
+#define FUZZ_H
+
+#include <stdbool.h>
+
+#if defined(__EMSCRIPTEN__) || defined(_WIN32)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+
+// Physics invariant fuzzer (headless, one worker per core)
+//
+// Each case is a seed that drives the gameplay physics step (collision_step
+// plus the rules around it: paddle input, losing and relaunching the ball,
+// clearing a stage) with a randomized stage, launch angles, paddle input
+// and frame-time spikes, which replay what main_loop does after a hitch:
+// a run of catch-up ticks with one input sample. Invariants are checked
+// after every tick. A failing case is shrunk (features it doesn't need are
+// switched off, ticks after the failure dropped) and written out as a
+// reproducer that --fuzz-replay runs again with a trace of the last ticks.
+
+#define FUZZ_CASES 4000
+#define FUZZ_CASE_TICKS 20000               // About 5.5 minutes of play per case
+#define FUZZ_MAX_THREADS 16
+#define FUZZ_REPROS_PER_INVARIANT 8         // Reproducers kept per broken invariant
+#define FUZZ_REPRO_FILE "fuzz_repro.txt"
+
+// What a case varies; switched off one at a time while shrinking
+typedef enum {
+    FUZZ_GENERATED_STAGE = 1 << 0,  // Generated layouts instead of the hand-built stages
+    FUZZ_RANDOM_ANGLES = 1 << 1,    // Launch anywhere within 60 degrees of straight up
+    FUZZ_PADDLE_INPUT = 1 << 2,     // Scripted input instead of a still paddle
+    FUZZ_FRAME_SPIKES = 1 << 3,     // Occasional frames of up to 15 catch-up ticks
+    FUZZ_FAST_LAUNCH = 1 << 4,      // Lives start part-way up the speed ramp
+    FUZZ_ALL_FEATURES = (1 << 5) - 1
+} FuzzFeature;
+
+typedef enum {
+    FUZZ_OK = 0,
+    FUZZ_NOT_FINITE,                // Position or velocity NaN or infinite
+    FUZZ_OUTSIDE_WALLS,             // Ball past the left, right or top wall
+    FUZZ_OVER_SPEED,                // Faster than BALL_MAX_SPEED_MULTIPLIER allows
+    FUZZ_STUCK_IN_BRICK,            // Same brick hit on consecutive ticks
+    FUZZ_NO_VERTICAL,               // Ball only moves sideways (never comes down)
+    FUZZ_PADDLE_OUTSIDE,            // Paddle left the screen
+    FUZZ_INVARIANT_COUNT
+} FuzzInvariant;
+
+#define FUZZ_MAX_REPROS (FUZZ_REPROS_PER_INVARIANT * FUZZ_INVARIANT_COUNT)
+
+typedef struct {
+    Uint32 seed;
+    Uint32 features;            // FuzzFeature bits
+    int ticks;
+} FuzzCase;
+
+// Run cases on every core and write FUZZ_REPRO_FILE; false if any failed
+bool fuzz_physics(int cases);
+
+// Run one case given as seed:features:ticks (hex, hex, decimal), as written
+// to FUZZ_REPRO_FILE, and print the ticks leading up to a failure
+bool fuzz_replay(const char* spec);
+
+const char* fuzz_invariant_name(FuzzInvariant invariant);
+
+#endif // FUZZ_H
@@ -6,32 +6,70 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+#ifdef PHYSICS_FIXED
+// BALL_SPEED_INCREMENT^n in Q16.16, with the last entry at the 2x cap
+static const phys_t speed_scale[BALL_SPEED_STEPS] = {
+    65536, 66847, 68184, 69547, 70938, 72357, 73804, 75280,
+    76786, 78322, 79888, 81486, 83115, 84778, 86473, 88203,
+    89967, 91766, 93602, 95474, 97383, 99331, 101317, 103344,
+    105411, 107519, 109669, 111863, 114100, 116382, 118709, 121084,
+    123505, 125975, 128495, 131065, 131072
+};
+
+// sin(0..90 degrees) in Q16.16
+static const phys_t sin_table[91] = {
+    0, 1144, 2287, 3430, 4572, 5712, 6850, 7987,
+    9121, 10252, 11380, 12505, 13626, 14742, 15855, 16962,
+    18064, 19161, 20252, 21336, 22415, 23486, 24550, 25607,
+    26656, 27697, 28729, 29753, 30767, 31772, 32768, 33754,
+    34729, 35693, 36647, 37590, 38521, 39441, 40348, 41243,
+    42126, 42995, 43852, 44695, 45525, 46341, 47143, 47930,
+    48703, 49461, 50203, 50931, 51643, 52339, 53020, 53684,
+    54332, 54963, 55578, 56175, 56756, 57319, 57865, 58393,
+    58903, 59396, 59870, 60326, 60764, 61183, 61584, 61966,
+    62328, 62672, 62997, 63303, 63589, 63856, 64104, 64332,
+    64540, 64729, 64898, 65048, 65177, 65287, 65376, 65446,
+    65496, 65526, 65536
+};
+
+// Sine of a whole-degree angle, any sign or range
+static phys_t ball_sin_deg(int degrees) {
+    degrees %= 360;
+    if (degrees < 0) degrees += 360;
+    if (degrees <= 90) return sin_table[degrees];
+    if (degrees <= 180) return sin_table[180 - degrees];
+    if (degrees <= 270) return -sin_table[degrees - 180];
+    return -sin_table[360 - degrees];
+}
+#endif
+
 void ball_init(Ball* ball, float x, float y) {
-    ball->x = x;
-    ball->y = y;
-    ball->vx = 0.0f;
-    ball->vy = 0.0f;
-    ball->base_speed = BALL_BASE_SPEED;
-    ball->current_speed = BALL_BASE_SPEED;
+    ball->x = phys_from_float(x);
+    ball->y = phys_from_float(y);
+    ball->vx = 0;
+    ball->vy = 0;
+    ball->base_speed = PHYS_CONST(BALL_BASE_SPEED);
+    ball->current_speed = ball->base_speed;
     ball->collision_count = 0;
-    ball->radius = BALL_RADIUS;
+    ball->radius = PHYS_CONST(BALL_RADIUS);
     ball->active = true;
-    ball->texture = NULL;  // Stage 1: no textures yet
+    ball->sprite = sprite_get(SPRITE_BALL);
 }
 
 void ball_update(Ball* ball, float dt) {
     if (!ball->active) return;
 
     // Update position
-    ball->x += ball->vx * dt;
-    ball->y += ball->vy * dt;
+    phys_t step = phys_from_float(dt);
+    ball->x += phys_mul(ball->vx, step);
+    ball->y += phys_mul(ball->vy, step);
 }
 
 void ball_reset(Ball* ball, float paddle_x) {
-    ball->x = paddle_x;
-    ball->y = 400.0f;  // Above paddle
-    ball->vx = 0.0f;
-    ball->vy = 0.0f;
+    ball->x = phys_from_float(paddle_x);
+    ball->y = PHYS_FROM_INT(400);  // Above paddle
+    ball->vx = 0;
+    ball->vy = 0;
     ball->active = true;
     ball->collision_count = 0;
     ball->current_speed = ball->base_speed;
@@ -40,37 +78,47 @@ void ball_reset(Ball* ball, float paddle_x) {
 void ball_launch(Ball* ball, float angle) {
     // angle in radians, typically -45 to -135 degrees (upward)
     ball->current_speed = ball->base_speed;
+#ifdef PHYSICS_FIXED
+    // Launch angles are whole degrees, so the table loses nothing
+    int degrees = (int)lroundf(angle * (float)(180.0 / M_PI));
+    ball->vx = phys_mul(ball->current_speed, ball_sin_deg(degrees + 90));
+    ball->vy = phys_mul(ball->current_speed, ball_sin_deg(degrees));
+#else
     ball->vx = ball->current_speed * cosf(angle);
     ball->vy = ball->current_speed * sinf(angle);
+#endif
 }
 
 void ball_on_collision(Ball* ball) {
     ball->collision_count++;
 
     // Increase speed by 2% per collision, cap at 2x base speed
+#ifdef PHYSICS_FIXED
+    int step = ball->collision_count < BALL_SPEED_STEPS ? ball->collision_count : BALL_SPEED_STEPS - 1;
+    ball->current_speed = phys_mul(ball->base_speed, speed_scale[step]);
+#else
     ball->current_speed = ball->base_speed * powf(BALL_SPEED_INCREMENT, ball->collision_count);
+#endif
 
-    float max_speed = ball->base_speed * BALL_MAX_SPEED_MULTIPLIER;
+    phys_t max_speed = phys_mul(ball->base_speed, PHYS_CONST(BALL_MAX_SPEED_MULTIPLIER));
     if (ball->current_speed > max_speed) {
         ball->current_speed = max_speed;
     }
 
-    // Renormalize velocity vector to new speed
-    float current_mag = sqrtf(ball->vx * ball->vx + ball->vy * ball->vy);
-    if (current_mag > 0.0f) {
-        ball->vx = (ball->vx / current_mag) * ball->current_speed;
-        ball->vy = (ball->vy / current_mag) * ball->current_speed;
-    }
+    ball_renormalize(ball);
 }
 
 void ball_reset_speed(Ball* ball) {
     ball->current_speed = ball->base_speed;
     ball->collision_count = 0;
 
-    // Renormalize velocity
-    float current_mag = sqrtf(ball->vx * ball->vx + ball->vy * ball->vy);
-    if (current_mag > 0.0f) {
-        ball->vx = (ball->vx / current_mag) * ball->current_speed;
-        ball->vy = (ball->vy / current_mag) * ball->current_speed;
+    ball_renormalize(ball);
+}
+
+void ball_renormalize(Ball* ball) {
+    phys_t current_mag = phys_sqrt_sq(phys_sq(ball->vx) + phys_sq(ball->vy));
+    if (current_mag > 0) {
+        ball->vx = phys_muldiv(ball->vx, ball->current_speed, current_mag);
+        ball->vy = phys_muldiv(ball->vy, ball->current_speed, current_mag);
     }
 }
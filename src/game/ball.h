@@ -7,19 +7,21 @@
 #include <SDL2/SDL.h>
 #endif
 #include <stdbool.h>
+#include "../systems/sprite.h"
+#include "physics.h"
 
 // Ball structure
 typedef struct {
-    float x;                // X position (center)
-    float y;                // Y position (center)
-    float vx;               // X velocity (pixels per second)
-    float vy;               // Y velocity (pixels per second)
-    float base_speed;       // Starting speed (200 px/s)
-    float current_speed;    // Current speed (increases with collisions)
+    phys_t x;               // X position (center)
+    phys_t y;               // Y position (center)
+    phys_t vx;              // X velocity (pixels per second)
+    phys_t vy;              // Y velocity (pixels per second)
+    phys_t base_speed;      // Starting speed (200 px/s)
+    phys_t current_speed;   // Current speed (increases with collisions)
     int collision_count;    // Number of collisions this life
-    float radius;           // Collision radius (8 pixels)
+    phys_t radius;          // Collision radius (8 pixels)
     bool active;            // Is this ball in play?
-    SDL_Texture* texture;   // Sprite texture (NULL for Stage 1 white rendering)
+    SpriteHandle sprite;    // Atlas sprite (solid color until an atlas provides it)
 } Ball;
 
 // Ball functions
@@ -29,11 +31,13 @@ void ball_reset(Ball* ball, float paddle_x);
 void ball_launch(Ball* ball, float angle);
 void ball_on_collision(Ball* ball);  // Increase speed on collision
 void ball_reset_speed(Ball* ball);   // Reset speed to base (on life loss)
+void ball_renormalize(Ball* ball);   // Scale velocity to current_speed, keeping direction
 
 // Constants
 #define BALL_RADIUS 8.0f
 #define BALL_BASE_SPEED 200.0f
 #define BALL_SPEED_INCREMENT 1.02f  // 2% increase per collision
 #define BALL_MAX_SPEED_MULTIPLIER 2.0f  // Cap at 2x base speed
+#define BALL_SPEED_STEPS 37         // Speed scale table size: 1.02^0 .. 1.02^35, then the cap
 
 #endif // BALL_H
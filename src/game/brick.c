@@ -7,29 +7,33 @@ void brick_init(Brick* brick, float x, float y, BrickType type) {
     brick->height = BRICK_HEIGHT;
     brick->type = type;
     brick->active = true;
-    brick->texture = NULL;  // Stage 1: no textures yet
 
     // Set durability and points based on type
     switch (type) {
         case BRICK_NORMAL:
             brick->durability = 1;
             brick->points = BRICK_NORMAL_POINTS;
+            brick->sprite = sprite_get(SPRITE_BRICK_NORMAL);
             break;
         case BRICK_MULTI:
             brick->durability = 2;
             brick->points = BRICK_MULTI_POINTS;
+            brick->sprite = sprite_get(SPRITE_BRICK_MULTI);
             break;
         case BRICK_UNBREAKABLE:
             brick->durability = -1;  // Infinite
             brick->points = 0;
+            brick->sprite = sprite_get(SPRITE_BRICK_UNBREAKABLE);
             break;
         case BRICK_SPECIAL:
             brick->durability = 1;
             brick->points = BRICK_SPECIAL_POINTS;
+            brick->sprite = sprite_get(SPRITE_BRICK_SPECIAL);
             break;
         default:
             brick->durability = 1;
             brick->points = BRICK_NORMAL_POINTS;
+            brick->sprite = sprite_get(SPRITE_BRICK_NORMAL);
             break;
     }
 
@@ -7,6 +7,7 @@
 #include <SDL2/SDL.h>
 #endif
 #include <stdbool.h>
+#include "../systems/sprite.h"
 
 // Brick type enumeration
 typedef enum {
@@ -28,7 +29,7 @@ typedef struct {
     int max_durability;   // Original durability (for visual damage states)
     int points;           // Points awarded on destruction
     bool active;          // Is this brick still in the grid?
-    SDL_Texture* texture; // Sprite texture (NULL for Stage 1 white rendering)
+    SpriteHandle sprite;  // Atlas sprite (solid color until an atlas provides it)
 } Brick;
 
 // Brick functions
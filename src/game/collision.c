@@ -4,41 +4,47 @@
 
 bool collision_ball_paddle(Ball* ball, Paddle* paddle) {
     // Circle-rectangle collision
-    float closest_x = ball->x;
-    float closest_y = ball->y;
+    phys_t left = PHYS_FROM_INT(paddle->bounds.x);
+    phys_t right = PHYS_FROM_INT(paddle->bounds.x + paddle->bounds.w);
+    phys_t top = PHYS_FROM_INT(paddle->bounds.y);
+    phys_t bottom = PHYS_FROM_INT(paddle->bounds.y + paddle->bounds.h);
+    phys_t closest_x = ball->x;
+    phys_t closest_y = ball->y;
 
     // Clamp circle center to rectangle bounds
-    if (ball->x < paddle->bounds.x) {
-        closest_x = paddle->bounds.x;
-    } else if (ball->x > paddle->bounds.x + paddle->bounds.w) {
-        closest_x = paddle->bounds.x + paddle->bounds.w;
+    if (ball->x < left) {
+        closest_x = left;
+    } else if (ball->x > right) {
+        closest_x = right;
     }
 
-    if (ball->y < paddle->bounds.y) {
-        closest_y = paddle->bounds.y;
-    } else if (ball->y > paddle->bounds.y + paddle->bounds.h) {
-        closest_y = paddle->bounds.y + paddle->bounds.h;
+    if (ball->y < top) {
+        closest_y = top;
+    } else if (ball->y > bottom) {
+        closest_y = bottom;
     }
 
     // Check if distance from ball center to closest point is less than radius
-    float dx = ball->x - closest_x;
-    float dy = ball->y - closest_y;
-    float distance_squared = dx * dx + dy * dy;
+    phys_t dx = ball->x - closest_x;
+    phys_t dy = ball->y - closest_y;
+    phys_sq_t distance_squared = phys_sq(dx) + phys_sq(dy);
 
-    return distance_squared < (ball->radius * ball->radius);
+    return distance_squared < phys_sq(ball->radius);
 }
 
 bool collision_ball_brick(Ball* ball, Brick* brick) {
     if (!brick->active) return false;
 
     // Simple AABB collision for brick
-    float brick_right = brick->x + brick->width;
-    float brick_bottom = brick->y + brick->height;
+    phys_t brick_left = phys_from_float(brick->x);
+    phys_t brick_top = phys_from_float(brick->y);
+    phys_t brick_right = phys_from_float(brick->x + brick->width);
+    phys_t brick_bottom = phys_from_float(brick->y + brick->height);
 
     // Check if ball overlaps brick
-    if (ball->x + ball->radius > brick->x &&
+    if (ball->x + ball->radius > brick_left &&
         ball->x - ball->radius < brick_right &&
-        ball->y + ball->radius > brick->y &&
+        ball->y + ball->radius > brick_top &&
         ball->y - ball->radius < brick_bottom) {
         return true;
     }
@@ -47,6 +53,8 @@ bool collision_ball_brick(Ball* ball, Brick* brick) {
 }
 
 void collision_ball_walls(Ball* ball, int screen_width, int screen_height) {
+    phys_t right = PHYS_FROM_INT(screen_width);
+
     // Left wall
     if (ball->x - ball->radius < 0) {
         ball->x = ball->radius;
@@ -55,8 +63,8 @@ void collision_ball_walls(Ball* ball, int screen_width, int screen_height) {
     }
 
     // Right wall
-    if (ball->x + ball->radius > screen_width) {
-        ball->x = screen_width - ball->radius;
+    if (ball->x + ball->radius > right) {
+        ball->x = right - ball->radius;
         collision_reflect_horizontal(ball);
         ball_on_collision(ball);
     }
@@ -81,22 +89,20 @@ void collision_reflect_vertical(Ball* ball) {
 
 void collision_paddle_bounce(Ball* ball, Paddle* paddle) {
     // Reflect vertically
-    ball->vy = -fabsf(ball->vy);  // Always bounce upward
+    ball->vy = -phys_abs(ball->vy);  // Always bounce upward
 
     // Add horizontal component based on where ball hit paddle
-    float hit_pos = (ball->x - paddle->x) / (paddle->width / 2.0f);  // -1 to 1
-    hit_pos = fmaxf(-1.0f, fminf(1.0f, hit_pos));  // Clamp
+    phys_t half_width = phys_from_float(paddle->width / 2.0f);
+    phys_t hit_pos = phys_div(ball->x - phys_from_float(paddle->x), half_width);  // -1 to 1
+    if (hit_pos < -PHYS_ONE) hit_pos = -PHYS_ONE;  // Clamp
+    if (hit_pos > PHYS_ONE) hit_pos = PHYS_ONE;
 
     // Adjust horizontal velocity based on hit position
-    float angle_influence = 0.5f;
-    ball->vx += hit_pos * ball->current_speed * angle_influence;
+    phys_t angle_influence = PHYS_CONST(0.5f);
+    ball->vx += phys_mul(phys_mul(hit_pos, ball->current_speed), angle_influence);
 
     // Renormalize to maintain speed
-    float mag = sqrtf(ball->vx * ball->vx + ball->vy * ball->vy);
-    if (mag > 0) {
-        ball->vx = (ball->vx / mag) * ball->current_speed;
-        ball->vy = (ball->vy / mag) * ball->current_speed;
-    }
+    ball_renormalize(ball);
 
     // Ensure ball bounces upward
     if (ball->vy > 0) {
@@ -105,3 +111,33 @@ void collision_paddle_bounce(Ball* ball, Paddle* paddle) {
 
     ball_on_collision(ball);
 }
+
+void collision_step(Ball* ball, Paddle* paddle, Stage* stage, int screen_width, int screen_height,
+                    float dt, CollisionStep* result) {
+    ball_update(ball, dt);
+    collision_ball_walls(ball, screen_width, screen_height);
+
+    result->tests = 1;
+    result->paddle_hit = collision_ball_paddle(ball, paddle);
+    if (result->paddle_hit) {
+        collision_paddle_bounce(ball, paddle);
+    }
+
+    result->brick = -1;
+    result->brick_destroyed = false;
+    for (int i = 0; i < MAX_BRICKS; i++) {
+        if (stage->bricks[i].active) {
+            result->tests++;
+            if (collision_ball_brick(ball, &stage->bricks[i])) {
+                result->brick = i;
+                result->brick_destroyed = brick_hit(&stage->bricks[i]);
+                stage->revision++;
+                collision_reflect_vertical(ball);
+                ball_on_collision(ball);
+                break;
+            }
+        }
+    }
+
+    result->lost = ball->y - ball->radius > PHYS_FROM_INT(screen_height);
+}
@@ -4,8 +4,18 @@
 #include "ball.h"
 #include "paddle.h"
 #include "brick.h"
+#include "stage.h"
 #include <stdbool.h>
 
+// What one tick of ball physics touched
+typedef struct {
+    bool paddle_hit;
+    int brick;                  // Brick hit (index into the stage's bricks), -1 if none
+    bool brick_destroyed;
+    bool lost;                  // Ball fell below the screen
+    int tests;                  // Collision tests run
+} CollisionStep;
+
 // Collision detection functions
 bool collision_ball_paddle(Ball* ball, Paddle* paddle);
 bool collision_ball_brick(Ball* ball, Brick* brick);
@@ -16,4 +26,11 @@ void collision_reflect_horizontal(Ball* ball);
 void collision_reflect_vertical(Ball* ball);
 void collision_paddle_bounce(Ball* ball, Paddle* paddle);
 
+// One tick of ball physics as gameplay runs it: move the ball, bounce it off
+// the walls and the paddle, then resolve the first brick it touches. Only
+// its arguments are touched, so headless harnesses can run it on several
+// threads at once.
+void collision_step(Ball* ball, Paddle* paddle, Stage* stage, int screen_width, int screen_height,
+                    float dt, CollisionStep* result);
+
 #endif // COLLISION_H
@@ -0,0 +1,308 @@
+#include "entity.h"
+#include <string.h>
+
+#define ENTITY_SLOT(handle) ((int)((handle) & (ENTITY_MAX - 1)))
+#define ENTITY_GENERATION(handle) ((handle) >> ENTITY_SLOT_BITS)
+
+static EntityHandle entity_make_handle(const EntityStore* store, int slot) {
+    return (store->generations[slot] << ENTITY_SLOT_BITS) | (Uint32)slot;
+}
+
+// Slot of a live handle, -1 for a stale one
+static int entity_resolve(const EntityStore* store, EntityHandle handle) {
+    int slot = ENTITY_SLOT(handle);
+    if (handle == ENTITY_NONE || !store->alive[slot] ||
+        store->generations[slot] != ENTITY_GENERATION(handle)) {
+        return -1;
+    }
+    return slot;
+}
+
+static void* entity_pool_element(EntityStore* store, ComponentType type, int index) {
+    switch (type) {
+        case COMPONENT_TRANSFORM: return &store->transforms[index];
+        case COMPONENT_VELOCITY:  return &store->velocities[index];
+        case COMPONENT_COLLIDER:  return &store->colliders[index];
+        case COMPONENT_RENDER:    return &store->renderables[index];
+        default:                  return NULL;
+    }
+}
+
+static size_t entity_pool_size(ComponentType type) {
+    switch (type) {
+        case COMPONENT_TRANSFORM: return sizeof(Transform);
+        case COMPONENT_VELOCITY:  return sizeof(Velocity);
+        case COMPONENT_COLLIDER:  return sizeof(Collider);
+        case COMPONENT_RENDER:    return sizeof(Renderable);
+        default:                  return 0;
+    }
+}
+
+static void* entity_add(EntityStore* store, EntityHandle handle, ComponentType type) {
+    int slot = entity_resolve(store, handle);
+    if (slot < 0) {
+        store->stats.stale_lookups++;
+        return NULL;
+    }
+    if (store->where[slot][type] >= 0) {
+        return entity_pool_element(store, type, store->where[slot][type]);
+    }
+
+    // One element per entity, so the pool can't be full while the slot is live
+    int index = store->counts[type]++;
+    store->owners[type][index] = (Uint16)slot;
+    store->where[slot][type] = (Sint16)index;
+    void* element = entity_pool_element(store, type, index);
+    memset(element, 0, entity_pool_size(type));
+    return element;
+}
+
+static void* entity_get(EntityStore* store, EntityHandle handle, ComponentType type) {
+    int slot = entity_resolve(store, handle);
+    if (slot < 0) {
+        store->stats.stale_lookups++;
+        return NULL;
+    }
+    int index = store->where[slot][type];
+    return index >= 0 ? entity_pool_element(store, type, index) : NULL;
+}
+
+// Swap-remove: the pool's last element fills the hole
+static void entity_pool_remove(EntityStore* store, int slot, ComponentType type) {
+    int index = store->where[slot][type];
+    if (index < 0) {
+        return;
+    }
+
+    // Partial redraws still have to clear where it was drawn
+    if (type == COMPONENT_RENDER && !SDL_RectEmpty(&store->renderables[index].drawn)) {
+        const SDL_Rect* drawn = &store->renderables[index].drawn;
+        if (store->vacated_count < ENTITY_MAX) {
+            store->vacated[store->vacated_count++] = *drawn;
+        } else {
+            SDL_Rect* merged = &store->vacated[ENTITY_MAX - 1];
+            SDL_UnionRect(merged, drawn, merged);
+        }
+    }
+
+    int last = --store->counts[type];
+    if (index != last) {
+        int moved = store->owners[type][last];
+        memcpy(entity_pool_element(store, type, index), entity_pool_element(store, type, last),
+               entity_pool_size(type));
+        store->owners[type][index] = (Uint16)moved;
+        store->where[moved][type] = (Sint16)index;
+    }
+    store->where[slot][type] = -1;
+}
+
+static SDL_Rect entity_sprite_rect(const Transform* transform, const Renderable* renderable) {
+    SDL_Rect rect = {(int)(transform->x - renderable->width / 2.0f),
+                     (int)(transform->y - renderable->height / 2.0f),
+                     renderable->width, renderable->height};
+    return rect;
+}
+
+void entity_store_init(EntityStore* store) {
+    memset(store, 0, sizeof(*store));
+    for (int i = 0; i < ENTITY_MAX; i++) {
+        store->generations[i] = 1;
+    }
+    entity_store_clear(store);
+}
+
+void entity_store_clear(EntityStore* store) {
+    for (int i = 0; i < ENTITY_MAX; i++) {
+        if (store->alive[i]) {
+            entity_destroy(store, entity_make_handle(store, i));
+        }
+    }
+
+    // Lowest slots first, which keeps a small store's slots packed
+    store->free_count = 0;
+    for (int i = ENTITY_MAX - 1; i >= 0; i--) {
+        if (store->generations[i] != 0) {
+            store->free_slots[store->free_count++] = (Uint16)i;
+        }
+        for (int type = 0; type < COMPONENT_COUNT; type++) {
+            store->where[i][type] = -1;
+        }
+    }
+}
+
+EntityHandle entity_create(EntityStore* store) {
+    if (store->free_count == 0) {
+        store->stats.full++;
+        return ENTITY_NONE;
+    }
+
+    int slot = store->free_slots[--store->free_count];
+    store->alive[slot] = true;
+    store->stats.created++;
+    if (++store->stats.live > store->stats.peak) {
+        store->stats.peak = store->stats.live;
+    }
+    return entity_make_handle(store, slot);
+}
+
+void entity_destroy(EntityStore* store, EntityHandle handle) {
+    int slot = entity_resolve(store, handle);
+    if (slot < 0) {
+        return;
+    }
+
+    for (int type = 0; type < COMPONENT_COUNT; type++) {
+        entity_pool_remove(store, slot, type);
+    }
+
+    store->alive[slot] = false;
+    if (store->generations[slot] == ENTITY_GENERATION_MAX) {
+        store->generations[slot] = 0;   // Wrapping would bring old handles back
+        store->stats.retired++;
+    } else {
+        store->generations[slot]++;
+        store->free_slots[store->free_count++] = (Uint16)slot;
+    }
+    store->stats.live--;
+    store->stats.destroyed++;
+}
+
+bool entity_alive(const EntityStore* store, EntityHandle handle) {
+    return entity_resolve(store, handle) >= 0;
+}
+
+Transform* entity_add_transform(EntityStore* store, EntityHandle handle) {
+    return entity_add(store, handle, COMPONENT_TRANSFORM);
+}
+
+Velocity* entity_add_velocity(EntityStore* store, EntityHandle handle) {
+    return entity_add(store, handle, COMPONENT_VELOCITY);
+}
+
+Collider* entity_add_collider(EntityStore* store, EntityHandle handle) {
+    return entity_add(store, handle, COMPONENT_COLLIDER);
+}
+
+Renderable* entity_add_renderable(EntityStore* store, EntityHandle handle) {
+    return entity_add(store, handle, COMPONENT_RENDER);
+}
+
+void entity_remove_component(EntityStore* store, EntityHandle handle, ComponentType type) {
+    int slot = entity_resolve(store, handle);
+    if (slot >= 0 && type >= 0 && type < COMPONENT_COUNT) {
+        entity_pool_remove(store, slot, type);
+    }
+}
+
+Transform* entity_transform(EntityStore* store, EntityHandle handle) {
+    return entity_get(store, handle, COMPONENT_TRANSFORM);
+}
+
+Velocity* entity_velocity(EntityStore* store, EntityHandle handle) {
+    return entity_get(store, handle, COMPONENT_VELOCITY);
+}
+
+Collider* entity_collider(EntityStore* store, EntityHandle handle) {
+    return entity_get(store, handle, COMPONENT_COLLIDER);
+}
+
+Renderable* entity_renderable(EntityStore* store, EntityHandle handle) {
+    return entity_get(store, handle, COMPONENT_RENDER);
+}
+
+EntityHandle entity_owner(const EntityStore* store, ComponentType type, int index) {
+    if (type < 0 || type >= COMPONENT_COUNT || index < 0 || index >= store->counts[type]) {
+        return ENTITY_NONE;
+    }
+    return entity_make_handle(store, store->owners[type][index]);
+}
+
+void entity_system_move(EntityStore* store, float dt) {
+    for (int i = 0; i < store->counts[COMPONENT_VELOCITY]; i++) {
+        int transform = store->where[store->owners[COMPONENT_VELOCITY][i]][COMPONENT_TRANSFORM];
+        if (transform >= 0) {
+            store->transforms[transform].x += store->velocities[i].vx * dt;
+            store->transforms[transform].y += store->velocities[i].vy * dt;
+        }
+    }
+}
+
+void entity_system_cull(EntityStore* store, const SDL_Rect* bounds) {
+    // Backwards: destroying swaps the pool's last element into i
+    for (int i = store->counts[COMPONENT_TRANSFORM] - 1; i >= 0; i--) {
+        int slot = store->owners[COMPONENT_TRANSFORM][i];
+        const Transform* transform = &store->transforms[i];
+        float half_width = 0.0f;
+        float half_height = 0.0f;
+        int collider = store->where[slot][COMPONENT_COLLIDER];
+        if (collider >= 0) {
+            half_width = store->colliders[collider].half_width;
+            half_height = store->colliders[collider].half_height;
+        }
+
+        if (transform->x + half_width < bounds->x || transform->x - half_width > bounds->x + bounds->w ||
+            transform->y + half_height < bounds->y || transform->y - half_height > bounds->y + bounds->h) {
+            entity_destroy(store, entity_make_handle(store, slot));
+        }
+    }
+}
+
+void entity_system_queue_sprites(EntityStore* store, const SDL_Rect* clip) {
+    for (int i = 0; i < store->counts[COMPONENT_RENDER]; i++) {
+        const Renderable* renderable = &store->renderables[i];
+        int transform = store->where[store->owners[COMPONENT_RENDER][i]][COMPONENT_TRANSFORM];
+        if (transform < 0) {
+            continue;
+        }
+
+        SDL_Rect rect = entity_sprite_rect(&store->transforms[transform], renderable);
+        if (!clip || SDL_HasIntersection(clip, &rect)) {
+            sprite_batch_add(renderable->sprite, &rect, renderable->color);
+        }
+    }
+}
+
+void entity_system_damage(EntityStore* store, DamageTracker* damage) {
+    for (int i = 0; i < store->vacated_count; i++) {
+        damage_add(damage, &store->vacated[i]);
+    }
+    store->vacated_count = 0;
+
+    for (int i = 0; i < store->counts[COMPONENT_RENDER]; i++) {
+        Renderable* renderable = &store->renderables[i];
+        int transform = store->where[store->owners[COMPONENT_RENDER][i]][COMPONENT_TRANSFORM];
+        SDL_Rect rect = {0, 0, 0, 0};
+        if (transform >= 0) {
+            rect = entity_sprite_rect(&store->transforms[transform], renderable);
+        }
+        if (!SDL_RectEquals(&rect, &renderable->drawn)) {
+            damage_add(damage, &renderable->drawn);
+            damage_add(damage, &rect);
+            renderable->drawn = rect;
+        }
+    }
+}
+
+int entity_query_rect(EntityStore* store, const SDL_Rect* rect, Uint32 layers,
+                      EntityHandle* out, int max) {
+    int found = 0;
+    for (int i = 0; i < store->counts[COMPONENT_COLLIDER] && found < max; i++) {
+        const Collider* collider = &store->colliders[i];
+        int slot = store->owners[COMPONENT_COLLIDER][i];
+        int transform = store->where[slot][COMPONENT_TRANSFORM];
+        if (!(collider->layers & layers) || transform < 0) {
+            continue;
+        }
+
+        const Transform* t = &store->transforms[transform];
+        if (t->x + collider->half_width >= rect->x && t->x - collider->half_width <= rect->x + rect->w &&
+            t->y + collider->half_height >= rect->y && t->y - collider->half_height <= rect->y + rect->h) {
+            out[found++] = entity_make_handle(store, slot);
+        }
+    }
+    return found;
+}
+
+EntityStats entity_get_stats(const EntityStore* store) {
+    return store->stats;
+}
@@ -0,0 +1,150 @@
+#ifndef ENTITY_H
+#define ENTITY_H
+
+#include <stdbool.h>
+
+#if defined(__EMSCRIPTEN__) || defined(_WIN32)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+#include "../systems/sprite.h"
+#include "../systems/damage.h"
+
+// Entity store
+//
+// Home for short-lived gameplay objects (power-up capsules, lasers, extra
+// balls). An entity is a slot plus the components attached to it; each
+// component type lives in its own dense pool, so systems walk a plain array
+// instead of chasing pointers. Removing a component moves the pool's last
+// element into the hole. Everything is sized up front: creating and
+// destroying entities never allocates.
+//
+// Handles carry the slot's generation, which is bumped when the entity is
+// destroyed, so a handle kept past destruction just stops resolving (lookups
+// return NULL) even after the slot is reused. Generations never wrap: a slot
+// whose generation is used up is retired instead of reused (after 16M
+// entities in that one slot).
+//
+// The paddle, ball and stage stay outside the store: fixed-point physics,
+// snapshots and rewind are built around them. Entities are not part of
+// snapshots; their owners save what they need (see PowerupState).
+
+#define ENTITY_SLOT_BITS 8
+#define ENTITY_MAX (1 << ENTITY_SLOT_BITS)
+#define ENTITY_GENERATION_MAX ((1u << (32 - ENTITY_SLOT_BITS)) - 1)
+#define ENTITY_NONE 0u                  // Never a valid handle
+
+// Generation in the high 24 bits, slot in the low 8; generations start at 1
+typedef Uint32 EntityHandle;
+
+typedef enum {
+    COMPONENT_TRANSFORM = 0,
+    COMPONENT_VELOCITY,
+    COMPONENT_COLLIDER,
+    COMPONENT_RENDER,
+    COMPONENT_COUNT
+} ComponentType;
+
+typedef struct {
+    float x;                    // Center
+    float y;
+} Transform;
+
+typedef struct {
+    float vx;                   // Pixels per second
+    float vy;
+} Velocity;
+
+typedef struct {
+    float half_width;           // Box around the transform's center
+    float half_height;
+    Uint32 layers;              // Bits matched by entity_query_rect
+} Collider;
+
+typedef struct {
+    SpriteHandle sprite;
+    SDL_Color color;
+    int width;                  // Drawn centered on the transform
+    int height;
+    SDL_Rect drawn;             // Where it was last drawn (partial redraws)
+} Renderable;
+
+typedef struct {
+    int live;
+    int peak;
+    Uint64 created;
+    Uint64 destroyed;
+    Uint64 full;                // Creates refused: every slot in use
+    Uint64 stale_lookups;       // Handles that no longer resolve
+    int retired;                // Slots whose generations ran out
+} EntityStats;
+
+typedef struct {
+    Uint32 generations[ENTITY_MAX];             // 0 once the slot is retired
+    bool alive[ENTITY_MAX];
+    Sint16 where[ENTITY_MAX][COMPONENT_COUNT];  // Dense index per component, -1 if absent
+    Uint16 free_slots[ENTITY_MAX];              // Stack of unused slots
+    int free_count;
+
+    // Dense component pools; owners[type][i] is the slot owning element i
+    Transform transforms[ENTITY_MAX];
+    Velocity velocities[ENTITY_MAX];
+    Collider colliders[ENTITY_MAX];
+    Renderable renderables[ENTITY_MAX];
+    Uint16 owners[COMPONENT_COUNT][ENTITY_MAX];
+    int counts[COMPONENT_COUNT];
+
+    // Last drawn rects of destroyed entities, cleared by entity_system_damage
+    SDL_Rect vacated[ENTITY_MAX];
+    int vacated_count;
+
+    EntityStats stats;
+} EntityStore;
+
+// Empty store; old handles stop resolving
+void entity_store_init(EntityStore* store);
+void entity_store_clear(EntityStore* store);
+
+// ENTITY_NONE when all ENTITY_MAX slots are in use
+EntityHandle entity_create(EntityStore* store);
+void entity_destroy(EntityStore* store, EntityHandle handle);   // Stale handles are ignored
+bool entity_alive(const EntityStore* store, EntityHandle handle);
+
+// Attach a zeroed component (or return the existing one); NULL for a stale handle
+Transform* entity_add_transform(EntityStore* store, EntityHandle handle);
+Velocity* entity_add_velocity(EntityStore* store, EntityHandle handle);
+Collider* entity_add_collider(EntityStore* store, EntityHandle handle);
+Renderable* entity_add_renderable(EntityStore* store, EntityHandle handle);
+void entity_remove_component(EntityStore* store, EntityHandle handle, ComponentType type);
+
+// NULL when the handle is stale or the component isn't attached
+Transform* entity_transform(EntityStore* store, EntityHandle handle);
+Velocity* entity_velocity(EntityStore* store, EntityHandle handle);
+Collider* entity_collider(EntityStore* store, EntityHandle handle);
+Renderable* entity_renderable(EntityStore* store, EntityHandle handle);
+
+// Handle of the entity owning element index of a component pool
+EntityHandle entity_owner(const EntityStore* store, ComponentType type, int index);
+
+// ----- Systems -----
+
+// Integrate velocities into transforms
+void entity_system_move(EntityStore* store, float dt);
+
+// Destroy entities whose transform has left bounds (collider box included)
+void entity_system_cull(EntityStore* store, const SDL_Rect* bounds);
+
+// Queue every renderable touching clip (NULL queues everything)
+void entity_system_queue_sprites(EntityStore* store, const SDL_Rect* clip);
+
+// Damage old and new rects of moved renderables and rects of destroyed ones
+void entity_system_damage(EntityStore* store, DamageTracker* damage);
+
+// Collect up to max entities whose collider shares a layer bit and overlaps rect
+int entity_query_rect(EntityStore* store, const SDL_Rect* rect, Uint32 layers,
+                      EntityHandle* out, int max);
+
+EntityStats entity_get_stats(const EntityStore* store);
+
+#endif // ENTITY_H
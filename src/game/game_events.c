@@ -0,0 +1,73 @@
+#include "game_events.h"
+#include "../systems/log.h"
+#include "../systems/metrics.h"
+#include <string.h>
+
+typedef struct {
+    Uint32 mask;
+    GameEventHandler handler;
+    void* userdata;
+} GameEventSubscriber;
+
+static GameEvent s_queue[GAME_EVENTS_CAPACITY];
+static int s_count = 0;
+static GameEventSubscriber s_subscribers[GAME_EVENTS_MAX_SUBSCRIBERS];
+static int s_subscriber_count = 0;
+static GameEventStats s_stats;
+
+void game_events_init(void) {
+    s_count = 0;
+    s_subscriber_count = 0;
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+bool game_events_subscribe(Uint32 mask, GameEventHandler handler, void* userdata) {
+    if (s_subscriber_count == GAME_EVENTS_MAX_SUBSCRIBERS) {
+        LOG_WARN(LOG_CAT_GAME, "Too many gameplay event subscribers (max %d)\n", GAME_EVENTS_MAX_SUBSCRIBERS);
+        return false;
+    }
+
+    GameEventSubscriber* subscriber = &s_subscribers[s_subscriber_count++];
+    subscriber->mask = mask;
+    subscriber->handler = handler;
+    subscriber->userdata = userdata;
+    return true;
+}
+
+bool game_events_emit(const GameEvent* event) {
+    if (s_count == GAME_EVENTS_CAPACITY) {
+        s_stats.dropped++;
+        return false;
+    }
+
+    s_queue[s_count++] = *event;
+    s_stats.emitted++;
+    s_stats.counts[event->type]++;
+    return true;
+}
+
+void game_events_dispatch(void) {
+    // s_count can grow while handlers run; those events go out in this batch
+    int i = 0;
+    for (; i < s_count; i++) {
+        const GameEvent* event = &s_queue[i];
+        Uint32 bit = GAME_EVENT_MASK(event->type);
+        for (int j = 0; j < s_subscriber_count; j++) {
+            if (s_subscribers[j].mask & bit) {
+                s_subscribers[j].handler(event, s_subscribers[j].userdata);
+            }
+        }
+    }
+
+    s_stats.ticks++;
+    if (i > s_stats.max_per_tick) {
+        s_stats.max_per_tick = i;
+    }
+    METRICS_COUNT("events.dispatched", i);
+    METRICS_SAMPLE("events.per_tick", 0.0, GAME_EVENTS_CAPACITY, i);
+    s_count = 0;
+}
+
+GameEventStats game_events_get_stats(void) {
+    return s_stats;
+}
@@ -0,0 +1,73 @@
+#ifndef GAME_EVENTS_H
+#define GAME_EVENTS_H
+
+#include <stdbool.h>
+
+#if defined(__EMSCRIPTEN__) || defined(_WIN32)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+
+// Gameplay events
+//
+// Collision and the gameplay rules only append what happened to a fixed
+// queue; score, sound, redraw regions and logging subscribe to the event
+// types they care about and run in one batch after the physics step. Events
+// emitted by a subscriber during dispatch are delivered in the same batch.
+// Nothing is allocated: the queue and subscriber table are static and a
+// full queue drops (and counts) further events until the next dispatch.
+
+#define GAME_EVENTS_CAPACITY 32         // Per tick; a busy tick emits about five
+#define GAME_EVENTS_MAX_SUBSCRIBERS 8
+
+typedef enum {
+    GAME_EVENT_PADDLE_HIT = 0,
+    GAME_EVENT_BRICK_HIT,           // Brick took a hit and is still standing
+    GAME_EVENT_BRICK_DESTROYED,
+    GAME_EVENT_BALL_LOST,
+    GAME_EVENT_STAGE_CLEARED,
+    GAME_EVENT_POWERUP_CAUGHT,
+    GAME_EVENT_POWERUP_EXPIRED,
+    GAME_EVENT_TYPE_COUNT
+} GameEventType;
+
+#define GAME_EVENT_MASK(type) (1u << (type))
+#define GAME_EVENT_MASK_ALL ((1u << GAME_EVENT_TYPE_COUNT) - 1)
+
+typedef struct {
+    GameEventType type;
+    float x;                    // Ball center when it happened
+    float y;
+    int brick;                  // Index into the stage's bricks, -1 if none
+    int points;                 // BRICK_DESTROYED: points scored
+    int lives;                  // BALL_LOST: lives left
+    int stage;                  // STAGE_CLEARED: the stage that was cleared
+    int powerup;                // POWERUP_*: which effect (PowerupType)
+} GameEvent;
+
+typedef void (*GameEventHandler)(const GameEvent* event, void* userdata);
+
+typedef struct {
+    Uint64 emitted;
+    Uint64 dropped;             // Queue was full
+    int ticks;                  // Dispatches
+    int max_per_tick;
+    int counts[GAME_EVENT_TYPE_COUNT];
+} GameEventStats;
+
+// Clears the queue, subscribers and stats
+void game_events_init(void);
+
+// Handlers run in subscription order for each event whose type is in mask
+bool game_events_subscribe(Uint32 mask, GameEventHandler handler, void* userdata);
+
+// Append an event; false if the queue is full
+bool game_events_emit(const GameEvent* event);
+
+// Deliver everything queued since the last dispatch, then empty the queue
+void game_events_dispatch(void);
+
+GameEventStats game_events_get_stats(void);
+
+#endif // GAME_EVENTS_H
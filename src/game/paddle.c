@@ -7,7 +7,7 @@ void paddle_init(Paddle* paddle, float x, float y) {
     paddle->width = PADDLE_WIDTH;
     paddle->base_width = PADDLE_WIDTH;
     paddle->speed = PADDLE_SPEED;
-    paddle->texture = NULL;  // Stage 1: no textures yet
+    paddle->sprite = sprite_get(SPRITE_PADDLE);
 
     paddle_update_bounds(paddle);
 }
@@ -7,6 +7,7 @@
 #include <SDL2/SDL.h>
 #endif
 #include <stdbool.h>
+#include "../systems/sprite.h"
 
 // Paddle structure
 typedef struct {
@@ -16,7 +17,7 @@ typedef struct {
     float base_width;     // Original width (reset after power-up expires)
     float speed;          // Movement speed (pixels per second)
     SDL_Rect bounds;      // Collision rectangle (updated each frame)
-    SDL_Texture* texture; // Sprite texture (NULL for Stage 1 white rendering)
+    SpriteHandle sprite;  // Atlas sprite (solid color until an atlas provides it)
 } Paddle;
 
 // Paddle functions
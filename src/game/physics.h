@@ -0,0 +1,94 @@
+#ifndef PHYSICS_H
+#define PHYSICS_H
+
+#include <stdint.h>
+#include <math.h>
+
+// Physics scalar type
+//
+// Ball position, velocity and speed use phys_t. By default it is a float;
+// building with PHYSICS_FIXED switches it to Q16.16 fixed point so the
+// simulation is bit-identical on every platform (no libm, no FPU rounding
+// differences) and cheap on weak FPUs. Code outside the physics converts
+// with phys_to_float / phys_from_float.
+
+#ifdef PHYSICS_FIXED
+
+typedef int32_t phys_t;         // Q16.16
+typedef int64_t phys_sq_t;      // Q32.32, products of two phys_t (squared distances)
+
+#define PHYS_SHIFT 16
+#define PHYS_ONE (1 << PHYS_SHIFT)
+#define PHYS_FROM_INT(i) ((phys_t)(i) * PHYS_ONE)
+#define PHYS_CONST(f) ((phys_t)((f) * PHYS_ONE + 0.5f))     // Non-negative constants only
+
+static inline phys_t phys_from_float(float f) {
+    return (phys_t)(f * PHYS_ONE + (f >= 0.0f ? 0.5f : -0.5f));
+}
+
+static inline float phys_to_float(phys_t a) {
+    return (float)a / PHYS_ONE;
+}
+
+static inline phys_t phys_mul(phys_t a, phys_t b) {
+    return (phys_t)(((int64_t)a * b) >> PHYS_SHIFT);
+}
+
+static inline phys_t phys_div(phys_t a, phys_t b) {
+    return (phys_t)(((int64_t)a << PHYS_SHIFT) / b);
+}
+
+// a * b / c without losing the low bits of the product
+static inline phys_t phys_muldiv(phys_t a, phys_t b, phys_t c) {
+    return (phys_t)(((int64_t)a * b) / c);
+}
+
+static inline phys_sq_t phys_sq(phys_t a) {
+    return (int64_t)a * a;
+}
+
+static inline phys_t phys_abs(phys_t a) {
+    return a < 0 ? -a : a;
+}
+
+// Square root of a Q32.32 value as Q16.16 (bitwise integer sqrt, exact floor)
+static inline phys_t phys_sqrt_sq(phys_sq_t v) {
+    uint64_t x = (uint64_t)v;
+    uint64_t result = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > x) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (x >= result + bit) {
+            x -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (phys_t)result;
+}
+
+#else
+
+typedef float phys_t;
+typedef float phys_sq_t;
+
+#define PHYS_ONE 1.0f
+#define PHYS_FROM_INT(i) ((float)(i))
+#define PHYS_CONST(f) (f)
+
+static inline phys_t phys_from_float(float f) { return f; }
+static inline float phys_to_float(phys_t a) { return a; }
+static inline phys_t phys_mul(phys_t a, phys_t b) { return a * b; }
+static inline phys_t phys_div(phys_t a, phys_t b) { return a / b; }
+static inline phys_t phys_muldiv(phys_t a, phys_t b, phys_t c) { return a / c * b; }
+static inline phys_sq_t phys_sq(phys_t a) { return a * a; }
+static inline phys_t phys_abs(phys_t a) { return fabsf(a); }
+static inline phys_t phys_sqrt_sq(phys_sq_t v) { return sqrtf(v); }
+
+#endif
+
+#endif // PHYSICS_H
@@ -0,0 +1,223 @@
+#include "powerup.h"
+#include "score.h"
+#include "game_events.h"
+#include "../systems/timer_wheel.h"
+#include <string.h>
+
+typedef struct {
+    const char* name;
+    Uint32 duration;            // Ticks
+    PowerupRule rule;
+    Uint32 max_duration;        // POWERUP_EXTEND cap
+    SDL_Color color;            // Capsule
+} PowerupEffect;
+
+static const PowerupEffect s_effects[POWERUP_COUNT] = {
+    [POWERUP_WIDE_PADDLE]  = {"wide paddle", 15 * POWERUP_TICKS_PER_SECOND, POWERUP_REFRESH, 0,
+                              {80, 160, 255, 255}},
+    [POWERUP_FAST_PADDLE]  = {"fast paddle", 12 * POWERUP_TICKS_PER_SECOND, POWERUP_REFRESH, 0,
+                              {80, 255, 120, 255}},
+    [POWERUP_DOUBLE_SCORE] = {"double score", 10 * POWERUP_TICKS_PER_SECOND, POWERUP_EXTEND,
+                              30 * POWERUP_TICKS_PER_SECOND, {255, 210, 60, 255}},
+};
+
+typedef struct {
+    EntityHandle entity;        // ENTITY_NONE when the slot is free
+    PowerupType type;
+} Capsule;
+
+static TimerWheel s_wheel;
+static bool s_wheel_ready = false;
+static TimerHandle s_timers[POWERUP_COUNT];
+static Capsule s_capsules[POWERUP_MAX_CAPSULES];
+static PowerupStats s_stats;
+
+static void powerup_emit(GameEventType type, PowerupType powerup, float x, float y) {
+    GameEvent event = {.type = type, .x = x, .y = y, .brick = -1, .powerup = powerup};
+    game_events_emit(&event);
+}
+
+static void powerup_expire(void* userdata, int type) {
+    s_timers[type] = TIMER_NONE;
+    s_stats.expired++;
+    powerup_emit(GAME_EVENT_POWERUP_EXPIRED, (PowerupType)type, 0.0f, 0.0f);
+}
+
+static void powerup_start(PowerupType type) {
+    const PowerupEffect* effect = &s_effects[type];
+    Uint32 duration = effect->duration;
+    Uint32 left = timer_wheel_remaining(&s_wheel, s_timers[type]);
+    if (left > 0) {
+        s_stats.refreshed++;
+        if (effect->rule == POWERUP_EXTEND) {
+            duration = left + effect->duration;
+            if (duration > effect->max_duration) {
+                duration = effect->max_duration;
+            }
+        }
+        timer_wheel_cancel(&s_wheel, s_timers[type]);
+    }
+    s_timers[type] = timer_wheel_schedule(&s_wheel, duration, powerup_expire, NULL, type);
+}
+
+static void powerup_apply(Paddle* paddle) {
+    float width = paddle->base_width * (powerup_active(POWERUP_WIDE_PADDLE) ? POWERUP_WIDE_SCALE : 1.0f);
+    if (paddle->width != width) {
+        paddle->width = width;
+        paddle_update_bounds(paddle);
+    }
+    paddle->speed = PADDLE_SPEED * (powerup_active(POWERUP_FAST_PADDLE) ? POWERUP_FAST_SCALE : 1.0f);
+    score_set_multiplier(powerup_active(POWERUP_DOUBLE_SCORE) ? POWERUP_SCORE_MULTIPLIER : 1.0f);
+}
+
+void powerup_reset(EntityStore* store) {
+    if (!s_wheel_ready) {
+        timer_wheel_init(&s_wheel);
+        s_wheel_ready = true;
+    }
+    timer_wheel_clear(&s_wheel);
+    for (int i = 0; i < POWERUP_COUNT; i++) {
+        s_timers[i] = TIMER_NONE;
+    }
+    powerup_drop_capsules(store);
+}
+
+void powerup_drop_capsules(EntityStore* store) {
+    for (int i = 0; i < POWERUP_MAX_CAPSULES; i++) {
+        if (store && s_capsules[i].entity != ENTITY_NONE) {
+            entity_destroy(store, s_capsules[i].entity);
+        }
+        s_capsules[i].entity = ENTITY_NONE;
+    }
+}
+
+// Falling capsule entity in slot; false if the store is full
+static bool powerup_place(EntityStore* store, int slot, PowerupType type, float x, float y) {
+    EntityHandle entity = entity_create(store);
+    if (entity == ENTITY_NONE) {
+        return false;
+    }
+
+    Transform* transform = entity_add_transform(store, entity);
+    transform->x = x;
+    transform->y = y;
+    entity_add_velocity(store, entity)->vy = POWERUP_FALL_SPEED;
+
+    Collider* collider = entity_add_collider(store, entity);
+    collider->half_width = POWERUP_CAPSULE_WIDTH / 2.0f;
+    collider->half_height = POWERUP_CAPSULE_HEIGHT / 2.0f;
+    collider->layers = POWERUP_CAPSULE_LAYER;
+
+    Renderable* renderable = entity_add_renderable(store, entity);
+    renderable->sprite.atlas = SPRITE_ATLAS_NONE;
+    renderable->color = s_effects[type].color;
+    renderable->width = POWERUP_CAPSULE_WIDTH;
+    renderable->height = POWERUP_CAPSULE_HEIGHT;
+
+    s_capsules[slot].entity = entity;
+    s_capsules[slot].type = type;
+    return true;
+}
+
+void powerup_spawn(EntityStore* store, float x, float y, Uint32 roll) {
+    for (int i = 0; i < POWERUP_MAX_CAPSULES; i++) {
+        if (s_capsules[i].entity == ENTITY_NONE) {
+            if (powerup_place(store, i, (PowerupType)(roll % POWERUP_COUNT), x, y)) {
+                s_stats.spawned++;
+            }
+            return;
+        }
+    }
+    // Too much on screen already; the brick just breaks
+}
+
+void powerup_save_state(EntityStore* store, PowerupState* state) {
+    memset(state, 0, sizeof(*state));
+    for (int i = 0; i < POWERUP_COUNT; i++) {
+        state->ticks_left[i] = s_wheel_ready ? timer_wheel_remaining(&s_wheel, s_timers[i]) : 0;
+    }
+    for (int i = 0; i < POWERUP_MAX_CAPSULES; i++) {
+        const Capsule* capsule = &s_capsules[i];
+        const Transform* transform = capsule->entity != ENTITY_NONE
+            ? entity_transform(store, capsule->entity) : NULL;
+        if (transform) {
+            state->capsule_x[i] = transform->x;
+            state->capsule_y[i] = transform->y;
+            state->capsule_type[i] = (Uint8)(capsule->type + 1);
+        }
+    }
+}
+
+void powerup_load_state(EntityStore* store, Paddle* paddle, const PowerupState* state) {
+    powerup_reset(store);
+    for (int i = 0; i < POWERUP_COUNT; i++) {
+        Uint32 ticks = state->ticks_left[i];
+        if (ticks > 0) {
+            if (ticks > TIMER_WHEEL_MAX_DELAY) {
+                ticks = TIMER_WHEEL_MAX_DELAY;
+            }
+            s_timers[i] = timer_wheel_schedule(&s_wheel, ticks, powerup_expire, NULL, i);
+        }
+    }
+    for (int i = 0; i < POWERUP_MAX_CAPSULES; i++) {
+        int type = state->capsule_type[i] - 1;
+        if (type >= 0 && type < POWERUP_COUNT) {
+            powerup_place(store, i, (PowerupType)type, state->capsule_x[i], state->capsule_y[i]);
+        }
+    }
+    powerup_apply(paddle);
+}
+
+void powerup_tick(EntityStore* store, Paddle* paddle) {
+    if (!s_wheel_ready) {
+        powerup_reset(NULL);
+    }
+
+    EntityHandle caught[POWERUP_MAX_CAPSULES];
+    int count = entity_query_rect(store, &paddle->bounds, POWERUP_CAPSULE_LAYER,
+                                  caught, POWERUP_MAX_CAPSULES);
+    for (int i = 0; i < POWERUP_MAX_CAPSULES; i++) {
+        Capsule* capsule = &s_capsules[i];
+        if (capsule->entity == ENTITY_NONE) {
+            continue;
+        }
+
+        bool was_caught = false;
+        for (int j = 0; j < count && !was_caught; j++) {
+            was_caught = caught[j] == capsule->entity;
+        }
+        if (was_caught) {
+            const Transform* transform = entity_transform(store, capsule->entity);
+            powerup_emit(GAME_EVENT_POWERUP_CAUGHT, capsule->type, transform->x, transform->y);
+            powerup_start(capsule->type);
+            entity_destroy(store, capsule->entity);
+            capsule->entity = ENTITY_NONE;
+            s_stats.caught++;
+        } else if (!entity_alive(store, capsule->entity)) {
+            capsule->entity = ENTITY_NONE;      // Culled below the screen
+            s_stats.missed++;
+        }
+    }
+
+    timer_wheel_tick(&s_wheel);
+    powerup_apply(paddle);
+}
+
+bool powerup_active(PowerupType type) {
+    return s_wheel_ready && timer_wheel_pending(&s_wheel, s_timers[type]);
+}
+
+float powerup_seconds_left(PowerupType type) {
+    if (!s_wheel_ready) {
+        return 0.0f;
+    }
+    return timer_wheel_remaining(&s_wheel, s_timers[type]) / (float)POWERUP_TICKS_PER_SECOND;
+}
+
+const char* powerup_name(PowerupType type) {
+    return type >= 0 && type < POWERUP_COUNT ? s_effects[type].name : "?";
+}
+
+PowerupStats powerup_get_stats(void) {
+    return s_stats;
+}
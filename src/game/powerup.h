@@ -0,0 +1,86 @@
+#ifndef POWERUP_H
+#define POWERUP_H
+
+#include <stdbool.h>
+#include "entity.h"
+#include "paddle.h"
+
+// Power-ups
+//
+// A destroyed special brick drops a capsule (an entity that falls until the
+// paddle catches it or it leaves the screen). Catching it starts a timed
+// effect on the paddle or the score. Effect timers run on a timer wheel
+// advanced once per fixed tick, so expiry is tied to simulation time, not
+// the frame rate. Picking up an effect that is already running follows its
+// rule: refresh restarts the full duration, extend adds to what is left (up
+// to a cap).
+//
+// Active effects are applied to the paddle and score multiplier every tick
+// (base value times the effect). Snapshots carry the effects' remaining
+// ticks and the falling capsules (PowerupState), so a rewind or resume puts
+// both back exactly as they were.
+
+#define POWERUP_TICKS_PER_SECOND 60
+#define POWERUP_MAX_CAPSULES 32             // Falling at once
+#define POWERUP_CAPSULE_WIDTH 30
+#define POWERUP_CAPSULE_HEIGHT 12
+#define POWERUP_FALL_SPEED 150.0f           // Pixels per second
+#define POWERUP_CAPSULE_LAYER (1u << 0)     // Collider layer caught by the paddle
+
+#define POWERUP_WIDE_SCALE 1.5f
+#define POWERUP_FAST_SCALE 1.4f
+#define POWERUP_SCORE_MULTIPLIER 2.0f
+
+typedef enum {
+    POWERUP_WIDE_PADDLE = 0,
+    POWERUP_FAST_PADDLE,
+    POWERUP_DOUBLE_SCORE,
+    POWERUP_COUNT
+} PowerupType;
+
+typedef enum {
+    POWERUP_REFRESH = 0,        // Catching it again restarts the duration
+    POWERUP_EXTEND              // Catching it again adds the duration, up to a cap
+} PowerupRule;
+
+// Running effects and falling capsules, flat for snapshots
+typedef struct {
+    Uint32 ticks_left[POWERUP_COUNT];                   // 0 when not running
+    float capsule_x[POWERUP_MAX_CAPSULES];
+    float capsule_y[POWERUP_MAX_CAPSULES];
+    Uint8 capsule_type[POWERUP_MAX_CAPSULES];           // Type + 1, 0 for a free slot
+} PowerupState;
+
+typedef struct {
+    int spawned;
+    int caught;
+    int missed;                 // Fell off the screen
+    int expired;
+    int refreshed;              // Caught while already running
+} PowerupStats;
+
+// Cancel all effects and forget capsules (new game, lost ball)
+void powerup_reset(EntityStore* store);
+
+// Forget falling capsules without counting them as missed (stage change);
+// running effects carry on
+void powerup_drop_capsules(EntityStore* store);
+
+// Drop a capsule at (x, y); roll picks the effect
+void powerup_spawn(EntityStore* store, float x, float y, Uint32 roll);
+
+// One fixed tick: catch capsules touching the paddle, expire effects, and
+// apply the active ones to the paddle and score multiplier
+void powerup_tick(EntityStore* store, Paddle* paddle);
+
+// Capture / restore effects and capsules (restoring replaces both, no stats
+// or events)
+void powerup_save_state(EntityStore* store, PowerupState* state);
+void powerup_load_state(EntityStore* store, Paddle* paddle, const PowerupState* state);
+
+bool powerup_active(PowerupType type);
+float powerup_seconds_left(PowerupType type);
+const char* powerup_name(PowerupType type);
+PowerupStats powerup_get_stats(void);
+
+#endif // POWERUP_H
@@ -1,22 +1,54 @@
 #include "stage.h"
+#include "../systems/log.h"
+#include <stdio.h>
 #include <string.h>
 
+#define STAGE_ORIGIN_X 10.0f
+#define STAGE_ORIGIN_Y 50.0f
+#define STAGE_SPACING_X 65.0f
+#define STAGE_SPACING_Y 25.0f
+
+// Scratch for the generator, sized for the stage grid so loading never allocates
+static int s_gen_scratch[STAGE_SCRATCH_INTS];
+
 void stage_init(Stage* stage, int stage_number) {
+    stage_build(stage, stage_number, s_gen_scratch);
+}
+
+static void stage_builtin_layout(Stage* stage, int stage_number, int* gen_scratch);
+
+static void stage_start(Stage* stage, int stage_number) {
     stage->stage_number = stage_number;
     stage->active_brick_count = 0;
     stage->cleared = false;
 
     // Clear layout
     memset(stage->layout, BRICK_EMPTY, sizeof(stage->layout));
+}
+
+void stage_build(Stage* stage, int stage_number, int* gen_scratch) {
+    stage_start(stage, stage_number);
 
     // Load layout for this stage
-    stage_load_layout(stage, stage_number);
+    stage_load_layout(stage, stage_number, gen_scratch);
 
     // Create bricks from layout
     stage_create_bricks(stage);
 }
 
-void stage_load_layout(Stage* stage, int stage_number) {
+void stage_build_builtin(Stage* stage, int stage_number, int* gen_scratch) {
+    stage_start(stage, stage_number);
+    stage_builtin_layout(stage, stage_number, gen_scratch);
+    stage_create_bricks(stage);
+}
+
+void stage_load_layout(Stage* stage, int stage_number, int* gen_scratch) {
+    if (!stage_load_file(stage_number, stage->layout)) {
+        stage_builtin_layout(stage, stage_number, gen_scratch);
+    }
+}
+
+static void stage_builtin_layout(Stage* stage, int stage_number, int* gen_scratch) {
     // Simple hardcoded layouts for Stage 1
     // Stage 1: 3 rows of normal bricks
     if (stage_number == 1) {
@@ -26,25 +58,29 @@ void stage_load_layout(Stage* stage, int stage_number) {
             }
         }
     }
-    // Stage 2: 5 rows, some multi-hit
+    // Stage 2: 5 rows, some multi-hit, two power-up bricks
     else if (stage_number == 2) {
         for (int row = 0; row < 5; row++) {
             for (int col = 0; col < STAGE_COLS; col++) {
                 // Make second and fourth rows multi-hit
                 if (row == 1 || row == 3) {
                     stage->layout[row][col] = BRICK_MULTI;
+                } else if (row == 2 && (col == 4 || col == 9)) {
+                    stage->layout[row][col] = BRICK_SPECIAL;
                 } else {
                     stage->layout[row][col] = BRICK_NORMAL;
                 }
             }
         }
     }
-    // Stage 3: Complex pattern with obstacles
-    else {
+    // Stage 3: Complex pattern with obstacles and two power-up bricks
+    else if (stage_number == STAGE_HANDBUILT_COUNT) {
         for (int row = 0; row < 6; row++) {
             for (int col = 0; col < STAGE_COLS; col++) {
                 if (row == 2 && col % 3 == 0) {
                     stage->layout[row][col] = BRICK_UNBREAKABLE;
+                } else if (row == 5 && (col == 2 || col == 11)) {
+                    stage->layout[row][col] = BRICK_SPECIAL;
                 } else if (row % 2 == 0) {
                     stage->layout[row][col] = BRICK_MULTI;
                 } else {
@@ -53,26 +89,30 @@ void stage_load_layout(Stage* stage, int stage_number) {
             }
         }
     }
+    // Endless mode: generated layouts, one difficulty step per stage
+    else {
+        Uint32 seed = stage->seed ^ ((Uint32)stage_number * 2654435761u);
+        stage_gen_layout(&stage->layout[0][0], STAGE_ROWS, STAGE_COLS, MAX_BRICKS,
+                         seed, stage_number - STAGE_HANDBUILT_COUNT, gen_scratch);
+    }
 }
 
 void stage_create_bricks(Stage* stage) {
     int brick_index = 0;
+    stage->revision++;
     stage->active_brick_count = 0;
-
-    float start_x = 10.0f;
-    float start_y = 50.0f;
-    float spacing_x = 65.0f;
-    float spacing_y = 25.0f;
+    memset(stage->cell_brick, -1, sizeof(stage->cell_brick));
 
     for (int row = 0; row < STAGE_ROWS; row++) {
         for (int col = 0; col < STAGE_COLS; col++) {
             BrickType type = stage->layout[row][col];
 
             if (type != BRICK_EMPTY && brick_index < MAX_BRICKS) {
-                float x = start_x + col * spacing_x;
-                float y = start_y + row * spacing_y;
+                float x = STAGE_ORIGIN_X + col * STAGE_SPACING_X;
+                float y = STAGE_ORIGIN_Y + row * STAGE_SPACING_Y;
 
                 brick_init(&stage->bricks[brick_index], x, y, type);
+                stage->cell_brick[row][col] = (Sint8)brick_index;
 
                 if (type != BRICK_UNBREAKABLE) {
                     stage->active_brick_count++;
@@ -82,6 +122,11 @@ void stage_create_bricks(Stage* stage) {
             }
         }
     }
+
+    // Retire leftovers from a larger previous stage (e.g. its unbreakable bricks)
+    for (int i = brick_index; i < MAX_BRICKS; i++) {
+        stage->bricks[i].active = false;
+    }
 }
 
 bool stage_is_cleared(Stage* stage) {
@@ -100,3 +145,147 @@ bool stage_is_cleared(Stage* stage) {
 void stage_reset(Stage* stage) {
     stage_init(stage, stage->stage_number);
 }
+
+static bool stage_brick_counts(const Brick* brick) {
+    return brick->active && brick->type != BRICK_UNBREAKABLE;
+}
+
+bool stage_load_file(int stage_number, BrickType layout[STAGE_ROWS][STAGE_COLS]) {
+    char path[64];
+    snprintf(path, sizeof(path), STAGE_FILE_FORMAT, stage_number);
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+
+    // Parse into a scratch grid so a bad file leaves the caller's layout alone
+    BrickType parsed[STAGE_ROWS][STAGE_COLS];
+    memset(parsed, BRICK_EMPTY, sizeof(parsed));
+
+    char line[128];
+    int row = 0;
+    int line_number = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file)) {
+        line_number++;
+        if (line[0] == '#') {
+            continue;
+        }
+        if (row == STAGE_ROWS) {
+            ok = line[strspn(line, " \t\r\n")] == '\0';  // Only blank lines may follow
+            continue;
+        }
+
+        for (int col = 0; line[col] && line[col] != '\n' && line[col] != '\r'; col++) {
+            BrickType type;
+            switch (line[col]) {
+                case '.': case ' ': type = BRICK_EMPTY; break;
+                case 'N': type = BRICK_NORMAL; break;
+                case 'M': type = BRICK_MULTI; break;
+                case 'U': type = BRICK_UNBREAKABLE; break;
+                case 'S': type = BRICK_SPECIAL; break;
+                default:
+                    LOG_WARN(LOG_CAT_GAME, "%s:%d: unknown brick '%c'\n", path, line_number, line[col]);
+                    ok = false;
+                    type = BRICK_EMPTY;
+                    break;
+            }
+            if (!ok) {
+                break;
+            }
+            if (col >= STAGE_COLS) {
+                if (type != BRICK_EMPTY) {
+                    LOG_WARN(LOG_CAT_GAME, "%s:%d: more than %d columns\n", path, line_number, STAGE_COLS);
+                    ok = false;
+                }
+                continue;
+            }
+            parsed[row][col] = type;
+        }
+        row++;
+    }
+    fclose(file);
+
+    if (!ok) {
+        return false;
+    }
+    memcpy(layout, parsed, sizeof(parsed));
+    return true;
+}
+
+StageDiff stage_apply_layout(Stage* stage, const BrickType layout[STAGE_ROWS][STAGE_COLS]) {
+    StageDiff diff = {0, 0, 0};
+
+    // Pool slots not owned by any cell are free for new bricks
+    bool used[MAX_BRICKS] = {false};
+    for (int row = 0; row < STAGE_ROWS; row++) {
+        for (int col = 0; col < STAGE_COLS; col++) {
+            if (stage->cell_brick[row][col] >= 0) {
+                used[stage->cell_brick[row][col]] = true;
+            }
+        }
+    }
+    int next_free = 0;
+
+    for (int row = 0; row < STAGE_ROWS; row++) {
+        for (int col = 0; col < STAGE_COLS; col++) {
+            BrickType old_type = stage->layout[row][col];
+            BrickType new_type = layout[row][col];
+            if (old_type == new_type) {
+                continue;
+            }
+
+            int index = stage->cell_brick[row][col];
+            if (index >= 0) {
+                Brick* brick = &stage->bricks[index];
+                if (stage_brick_counts(brick)) {
+                    stage->active_brick_count--;
+                }
+                if (new_type == BRICK_EMPTY) {
+                    brick->active = false;
+                    used[index] = false;
+                    stage->cell_brick[row][col] = -1;
+                    diff.removed++;
+                }
+            } else if (new_type != BRICK_EMPTY) {
+                while (next_free < MAX_BRICKS && used[next_free]) {
+                    next_free++;
+                }
+                if (next_free == MAX_BRICKS) {
+                    continue;   // Pool full: the cell stays empty, as in stage_create_bricks
+                }
+                index = next_free;
+                used[index] = true;
+                stage->cell_brick[row][col] = (Sint8)index;
+            }
+            stage->layout[row][col] = new_type;
+
+            if (new_type != BRICK_EMPTY) {
+                Brick* brick = &stage->bricks[index];
+                brick_init(brick, STAGE_ORIGIN_X + col * STAGE_SPACING_X,
+                           STAGE_ORIGIN_Y + row * STAGE_SPACING_Y, new_type);
+                if (stage_brick_counts(brick)) {
+                    stage->active_brick_count++;
+                }
+                if (old_type == BRICK_EMPTY) {
+                    diff.added++;
+                } else {
+                    diff.retyped++;
+                }
+            }
+        }
+    }
+
+    stage->cleared = stage->active_brick_count == 0;
+    stage->revision++;
+    return diff;
+}
+
+bool stage_reload(Stage* stage, StageDiff* diff) {
+    BrickType layout[STAGE_ROWS][STAGE_COLS];
+    if (!stage_load_file(stage->stage_number, layout)) {
+        return false;
+    }
+    *diff = stage_apply_layout(stage, layout);
+    return true;
+}
@@ -2,6 +2,7 @@
 #define STAGE_H
 
 #include "brick.h"
+#include "stage_gen.h"
 #include <stdbool.h>
 
 // Stage grid dimensions
@@ -9,20 +10,59 @@
 #define STAGE_COLS 14
 #define MAX_BRICKS 100
 
+// Generator scratch needed to build one stage (in ints)
+#define STAGE_SCRATCH_INTS STAGE_GEN_SCRATCH_INTS(STAGE_ROWS, STAGE_COLS)
+
+// Stages 1..STAGE_HANDBUILT_COUNT are hand-built, later ones are generated (endless mode)
+#define STAGE_HANDBUILT_COUNT 3
+
+// Layout files override the built-in and generated layouts: STAGE_ROWS lines of
+// STAGE_COLS cells, '.' empty, N normal, M multi-hit, U unbreakable, S special;
+// lines starting with '#' are comments
+#define STAGE_DIR "assets/stages"
+#define STAGE_FILE_FORMAT STAGE_DIR "/stage%d.txt"
+
 // Stage structure
 typedef struct {
     int stage_number;                                  // Current stage (1-indexed)
     Brick bricks[MAX_BRICKS];                          // Brick pool
     int active_brick_count;                            // Number of active bricks
     BrickType layout[STAGE_ROWS][STAGE_COLS];         // Grid template (loaded from file)
+    Sint8 cell_brick[STAGE_ROWS][STAGE_COLS];          // Pool index of each cell's brick (-1: none)
     bool cleared;                                      // All bricks destroyed?
+    Uint32 seed;                                       // Seed for generated stages (endless mode)
+    Uint32 revision;                                   // Bumped whenever bricks change (cache key)
 } Stage;
 
+// What a layout reload changed
+typedef struct {
+    int added;
+    int removed;
+    int retyped;
+} StageDiff;
+
 // Stage functions
 void stage_init(Stage* stage, int stage_number);
-void stage_load_layout(Stage* stage, int stage_number);
+void stage_load_layout(Stage* stage, int stage_number, int* gen_scratch);
 void stage_create_bricks(Stage* stage);
 bool stage_is_cleared(Stage* stage);
 void stage_reset(Stage* stage);
 
+// stage_init with the caller's generator scratch (STAGE_SCRATCH_INTS), so a
+// stage can be built off the game thread; stage_init shares one scratch buffer
+void stage_build(Stage* stage, int stage_number, int* gen_scratch);
+
+// stage_build ignoring layout files: the same stage wherever it runs from
+void stage_build_builtin(Stage* stage, int stage_number, int* gen_scratch);
+
+// Read a stage's layout file; false if there is none or it doesn't parse
+bool stage_load_file(int stage_number, BrickType layout[STAGE_ROWS][STAGE_COLS]);
+
+// Switch to a new layout in place: only changed cells get new, removed or
+// retyped bricks; untouched bricks keep their damage and liveness
+StageDiff stage_apply_layout(Stage* stage, const BrickType layout[STAGE_ROWS][STAGE_COLS]);
+
+// Re-read the current stage's file and apply it; false if it couldn't be loaded
+bool stage_reload(Stage* stage, StageDiff* diff);
+
 #endif // STAGE_H
@@ -0,0 +1,278 @@
+#include "stage_gen.h"
+#include "stage.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Layout shapes (applied to the left half, mirrored to the right)
+typedef enum {
+    PATTERN_FULL = 0,
+    PATTERN_CHECKER,
+    PATTERN_DIAMOND,
+    PATTERN_STRIPES,
+    PATTERN_PILLARS,
+    PATTERN_NOISE,
+    PATTERN_COUNT
+} StagePattern;
+
+// xorshift32: tiny, fast and identical on every platform (unlike rand())
+static Uint32 gen_next(Uint32* state) {
+    Uint32 x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static bool gen_pattern_cell(StagePattern pattern, int r, int c, int band, int half, Uint32* rng) {
+    switch (pattern) {
+        case PATTERN_FULL:
+            return true;
+        case PATTERN_CHECKER:
+            return ((r + c) & 1) == 0;
+        case PATTERN_DIAMOND: {
+            // Normalized distance from the band center row and the board center column
+            int dr = abs(2 * r - (band - 1));
+            int dc = 2 * (half - 1 - c);
+            return dr * half + dc * band <= 2 * band * half;
+        }
+        case PATTERN_STRIPES:
+            return (r & 1) == 0;
+        case PATTERN_PILLARS:
+            return (c % 3) != 2;
+        case PATTERN_NOISE:
+        default:
+            return (gen_next(rng) % 100) < 65;
+    }
+}
+
+static BrickType gen_brick_type(int difficulty, Uint32* rng) {
+    int unbreakable_pct = difficulty >= 2 ? 3 * difficulty : 0;
+    int multi_pct = 15 + 8 * difficulty;
+
+    if (unbreakable_pct > 20) unbreakable_pct = 20;
+    if (multi_pct > 60) multi_pct = 60;
+
+    int roll = (int)(gen_next(rng) % 100);
+    if (roll < unbreakable_pct) return BRICK_UNBREAKABLE;
+    roll -= unbreakable_pct;
+    if (roll < multi_pct) return BRICK_MULTI;
+    roll -= multi_pct;
+    if (roll < 5) return BRICK_SPECIAL;
+    return BRICK_NORMAL;
+}
+
+static bool gen_is_breakable(BrickType type) {
+    return type != BRICK_EMPTY && type != BRICK_UNBREAKABLE;
+}
+
+// Cell states in the reach map
+#define REACH_OPEN 0      // Not reached yet
+#define REACH_DONE 1      // Reachable from below
+#define REACH_WALL 2      // Unbreakable brick
+
+// Flood fill from the cells already on the stack.
+// Stack entries pack (row << 16 | col) to keep divisions out of the inner loop,
+// and walls live in the reach map so each neighbour costs a single test.
+static void gen_flood(int rows, int cols, int* reach, int* stack, int top) {
+    while (top > 0) {
+        int packed = stack[--top];
+        int r = packed >> 16;
+        int c = packed & 0xFFFF;
+        int i = r * cols + c;
+
+        if (r > 0 && reach[i - cols] == REACH_OPEN) {
+            reach[i - cols] = REACH_DONE;
+            stack[top++] = packed - (1 << 16);
+        }
+        if (r < rows - 1 && reach[i + cols] == REACH_OPEN) {
+            reach[i + cols] = REACH_DONE;
+            stack[top++] = packed + (1 << 16);
+        }
+        if (c > 0 && reach[i - 1] == REACH_OPEN) {
+            reach[i - 1] = REACH_DONE;
+            stack[top++] = packed - 1;
+        }
+        if (c < cols - 1 && reach[i + 1] == REACH_OPEN) {
+            reach[i + 1] = REACH_DONE;
+            stack[top++] = packed + 1;
+        }
+    }
+}
+
+// Make every breakable brick reachable from below the grid.
+// Unreached bricks get a channel opened straight down to reached space by
+// demoting unbreakable bricks (and their mirrors) to multi-hit bricks.
+// Each cell is flooded at most once, so this is O(rows * cols).
+static void gen_ensure_clearable(BrickType* grid, int rows, int cols, int* scratch) {
+    int cells = rows * cols;
+    int* stack = scratch;
+    int* reach = scratch + cells;
+    int top = 0;
+
+    for (int i = 0; i < cells; i++) {
+        reach[i] = grid[i] == BRICK_UNBREAKABLE ? REACH_WALL : REACH_OPEN;
+    }
+
+    // The row nearest the paddle is open to the play area
+    for (int c = 0; c < cols; c++) {
+        int i = (rows - 1) * cols + c;
+        if (reach[i] == REACH_OPEN) {
+            reach[i] = REACH_DONE;
+            stack[top++] = ((rows - 1) << 16) | c;
+        }
+    }
+    gen_flood(rows, cols, reach, stack, top);
+
+    for (int i = 0; i < cells; i++) {
+        if (reach[i] == REACH_DONE || !gen_is_breakable(grid[i])) {
+            continue;
+        }
+
+        int c = i % cols;
+        for (int j = i + cols; j < cells && reach[j] != REACH_DONE; j += cols) {
+            if (grid[j] == BRICK_UNBREAKABLE) {
+                int mirror = j - c + (cols - 1 - c);
+                grid[j] = BRICK_MULTI;
+                reach[j] = REACH_OPEN;
+                if (grid[mirror] == BRICK_UNBREAKABLE) {
+                    grid[mirror] = BRICK_MULTI;
+                    reach[mirror] = REACH_OPEN;
+                }
+            }
+        }
+
+        reach[i] = REACH_DONE;
+        stack[0] = ((i / cols) << 16) | c;
+        gen_flood(rows, cols, reach, stack, 1);
+    }
+}
+
+int stage_gen_layout(BrickType* grid, int rows, int cols, int max_bricks,
+                     Uint32 seed, int difficulty, int* scratch) {
+    Uint32 rng = seed ? seed : 0x9E3779B9u;
+    int half = (cols + 1) / 2;
+    int count = 0;
+
+    if (difficulty < 1) difficulty = 1;
+
+    memset(grid, BRICK_EMPTY, sizeof(BrickType) * rows * cols);
+
+    // Warm up the generator so nearby seeds diverge
+    for (int i = 0; i < 4; i++) {
+        gen_next(&rng);
+    }
+
+    StagePattern pattern = (StagePattern)(gen_next(&rng) % PATTERN_COUNT);
+
+    // Band of rows grows with difficulty: 35% of the board up to 80%
+    int band = rows * (35 + 5 * difficulty) / 100;
+    if (band > rows * 4 / 5) band = rows * 4 / 5;
+    if (band < 1) band = 1;
+    int first_row = (rows - band) > 0 ? (int)(gen_next(&rng) % 2) : 0;
+
+    for (int r = 0; r < band; r++) {
+        BrickType* row = grid + (first_row + r) * cols;
+        for (int c = 0; c < half; c++) {
+            int mirror = cols - 1 - c;
+            int cost = (mirror == c) ? 1 : 2;
+
+            if (!gen_pattern_cell(pattern, r, c, band, half, &rng)) {
+                continue;
+            }
+            if (count + cost > max_bricks) {
+                break;
+            }
+
+            BrickType type = gen_brick_type(difficulty, &rng);
+            row[c] = type;
+            row[mirror] = type;
+            count += cost;
+        }
+    }
+
+    // At least one brick has to be breakable or the stage is never cleared.
+    // Prefer turning an unbreakable pair into normal bricks so the cap holds.
+    int first_wall = -1;
+    bool has_breakable = false;
+    for (int i = 0; i < rows * cols && !has_breakable; i++) {
+        has_breakable = gen_is_breakable(grid[i]);
+        if (first_wall < 0 && grid[i] == BRICK_UNBREAKABLE) first_wall = i;
+    }
+    if (!has_breakable && first_wall >= 0) {
+        int c = first_wall % cols;
+        grid[first_wall] = BRICK_NORMAL;
+        grid[first_wall - c + (cols - 1 - c)] = BRICK_NORMAL;
+    } else if (!has_breakable && max_bricks > 0) {
+        BrickType* row = grid + (first_row + band - 1) * cols;
+        row[half - 1] = BRICK_NORMAL;
+        count++;
+        if (cols - half != half - 1 && count < max_bricks) {
+            row[cols - half] = BRICK_NORMAL;
+            count++;
+        }
+    }
+
+    // Rows outside the band are empty, so the band's bottom edge is open play area
+    gen_ensure_clearable(grid + first_row * cols, band, cols, scratch);
+
+    return count;
+}
+
+static int gen_compare_double(const void* a, const void* b) {
+    double da = *(const double*)a;
+    double db = *(const double*)b;
+    return (da > db) - (da < db);
+}
+
+// Returns the 99th percentile generation time in microseconds
+static double gen_bench_board(const char* name, int rows, int cols, int max_bricks, int iterations) {
+    BrickType* grid = (BrickType*)SDL_malloc(sizeof(BrickType) * rows * cols);
+    int* scratch = (int*)SDL_malloc(sizeof(int) * STAGE_GEN_SCRATCH_INTS(rows, cols));
+    double* samples = (double*)SDL_malloc(sizeof(double) * iterations);
+
+    if (!grid || !scratch || !samples) {
+        printf("  %s: out of memory\n", name);
+        SDL_free(grid);
+        SDL_free(scratch);
+        SDL_free(samples);
+        return STAGE_GEN_BUDGET_US * 2.0;
+    }
+
+    double freq = (double)SDL_GetPerformanceFrequency();
+    double total_us = 0.0;
+
+    // Warm caches so the first timed run isn't charged for page faults
+    stage_gen_layout(grid, rows, cols, max_bricks, 1, 1, scratch);
+
+    for (int i = 0; i < iterations; i++) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        stage_gen_layout(grid, rows, cols, max_bricks, (Uint32)i * 2654435761u,
+                         1 + i % 20, scratch);
+        samples[i] = (double)(SDL_GetPerformanceCounter() - start) * 1000000.0 / freq;
+        total_us += samples[i];
+    }
+
+    qsort(samples, iterations, sizeof(double), gen_compare_double);
+    double p99_us = samples[iterations * 99 / 100];
+
+    printf("  %-6s %4dx%-4d mean %8.2f us  p99 %8.2f us  worst %8.2f us\n",
+           name, rows, cols, total_us / iterations, p99_us, samples[iterations - 1]);
+
+    SDL_free(grid);
+    SDL_free(scratch);
+    SDL_free(samples);
+    return p99_us;
+}
+
+bool stage_gen_benchmark(void) {
+    printf("Stage generator benchmark (p99 budget %.0f us)\n", STAGE_GEN_BUDGET_US);
+
+    double stage_us = gen_bench_board("stage", STAGE_ROWS, STAGE_COLS, MAX_BRICKS, 10000);
+    double large_us = gen_bench_board("large", 64, 112, 64 * 112, 1000);
+
+    bool ok = stage_us <= STAGE_GEN_BUDGET_US && large_us <= STAGE_GEN_BUDGET_US;
+    printf("  %s\n", ok ? "PASS" : "FAIL: over budget");
+    return ok;
+}
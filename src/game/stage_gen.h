@@ -0,0 +1,30 @@
+#ifndef STAGE_GEN_H
+#define STAGE_GEN_H
+
+#include "brick.h"
+#include <stdbool.h>
+
+// Procedural stage generator (endless mode)
+//
+// Produces a left/right symmetric layout from (seed, difficulty). The same
+// seed and difficulty always give the same layout on every platform. Every
+// breakable brick is guaranteed to be reachable from below, so the stage can
+// always be cleared.
+
+// Scratch space required by stage_gen_layout (in ints)
+#define STAGE_GEN_SCRATCH_INTS(rows, cols) (2 * (rows) * (cols))
+
+// Time budget for one generation (99th percentile), checked by stage_gen_benchmark
+#define STAGE_GEN_BUDGET_US 250.0
+
+// Generate a layout into grid (rows * cols, row-major).
+// At most max_bricks non-empty cells are placed.
+// Returns the number of bricks placed.
+int stage_gen_layout(BrickType* grid, int rows, int cols, int max_bricks,
+                     Uint32 seed, int difficulty, int* scratch);
+
+// Time generation on the stage grid and on a very large board.
+// Prints the results and returns false if the worst case exceeds the budget.
+bool stage_gen_benchmark(void);
+
+#endif // STAGE_GEN_H
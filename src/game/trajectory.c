@@ -0,0 +1,291 @@
+#include "trajectory.h"
+#include <math.h>
+#include <string.h>
+
+#define TRAJECTORY_NO_STEP 0x7FFFFFFF
+
+typedef struct {
+    bool valid;
+    Uint32 last_used;
+
+    // What the path was cast from
+    const Stage* stage;
+    int stage_number;
+    Uint32 seed;
+    Uint32 revision;
+    float origin_x;
+    float origin_y;
+    float vx;
+    float vy;
+    float base_speed;
+    int collision_count;
+    float plane_y;
+    int max_bounces;
+
+    float times[TRAJECTORY_MAX_CONTACTS];   // From the origin
+    Trajectory path;                        // Times rewritten per query
+} TrajectoryCacheEntry;
+
+static TrajectoryCacheEntry s_cache[TRAJECTORY_CACHE_SIZE];
+static Uint32 s_clock = 0;
+static TrajectoryStats s_stats;
+
+// First fixed step at which a point that crosses a boundary after t seconds
+// is past it (the update only sees positions at whole steps)
+static int trajectory_step_after(float t) {
+    int step = (int)floorf(t / TRAJECTORY_DT) + 1;
+    return step < 1 ? 1 : step;
+}
+
+// First step at which a point moving at v is strictly inside the box (the
+// brick grown by the ball radius, as collision_ball_brick tests it);
+// TRAJECTORY_NO_STEP if it misses, or passes through between two steps
+static int trajectory_brick_step(float px, float py, float vx, float vy,
+                                 float left, float top, float right, float bottom) {
+    float t_enter = -1e30f;
+    float t_exit = 1e30f;
+
+    if (vx != 0.0f) {
+        float t0 = (left - px) / vx;
+        float t1 = (right - px) / vx;
+        if (t0 > t1) { float t = t0; t0 = t1; t1 = t; }
+        if (t0 > t_enter) t_enter = t0;
+        if (t1 < t_exit) t_exit = t1;
+    } else if (px <= left || px >= right) {
+        return TRAJECTORY_NO_STEP;
+    }
+
+    if (vy != 0.0f) {
+        float t0 = (top - py) / vy;
+        float t1 = (bottom - py) / vy;
+        if (t0 > t1) { float t = t0; t0 = t1; t1 = t; }
+        if (t0 > t_enter) t_enter = t0;
+        if (t1 < t_exit) t_exit = t1;
+    } else if (py <= top || py >= bottom) {
+        return TRAJECTORY_NO_STEP;
+    }
+
+    int step = trajectory_step_after(t_enter);
+    if (t_enter >= t_exit || step * TRAJECTORY_DT >= t_exit) {
+        return TRAJECTORY_NO_STEP;
+    }
+    return step;
+}
+
+static bool trajectory_in_brick(const Brick* brick, float x, float y, float radius) {
+    return x + radius > brick->x && x - radius < brick->x + brick->width &&
+           y + radius > brick->y && y - radius < brick->y + brick->height;
+}
+
+// Same speed-up as ball_on_collision
+static float trajectory_speed(float base_speed, int collision_count) {
+    float speed = base_speed * powf(BALL_SPEED_INCREMENT, (float)collision_count);
+    float max_speed = base_speed * BALL_MAX_SPEED_MULTIPLIER;
+    return speed > max_speed ? max_speed : speed;
+}
+
+static bool trajectory_add(TrajectoryCacheEntry* entry, TrajectoryContactType type,
+                           float x, float y, float time, int brick) {
+    Trajectory* path = &entry->path;
+    TrajectoryContact* contact = &path->contacts[path->count];
+    contact->type = type;
+    contact->x = x;
+    contact->y = y;
+    contact->time = time;
+    contact->brick = brick;
+    entry->times[path->count] = time;
+    path->count++;
+    return path->count < entry->max_bounces;
+}
+
+// Jump from contact to contact, reacting at the step where the gameplay
+// update would: walls clamp and reflect, then the paddle plane ends the
+// path, then the first overlapping brick in pool order flips vy
+static void trajectory_cast(TrajectoryCacheEntry* entry, const Stage* stage, float radius) {
+    int durability[MAX_BRICKS];
+    for (int i = 0; i < MAX_BRICKS; i++) {
+        const Brick* brick = &stage->bricks[i];
+        durability[i] = brick->active ? brick->durability : 0;
+    }
+
+    float px = entry->origin_x;
+    float py = entry->origin_y;
+    float vx = entry->vx;
+    float vy = entry->vy;
+    float time = 0.0f;
+    int collisions = entry->collision_count;
+    float right_wall = (float)SCREEN_WIDTH - radius;
+
+    Trajectory* path = &entry->path;
+    path->count = 0;
+    path->reaches_paddle = false;
+
+    while (path->count < entry->max_bounces && (vx != 0.0f || vy != 0.0f)) {
+        int step = TRAJECTORY_NO_STEP;
+        if (vx < 0.0f) {
+            step = trajectory_step_after((radius - px) / vx);
+        } else if (vx > 0.0f) {
+            step = trajectory_step_after((right_wall - px) / vx);
+        }
+        if (vy < 0.0f) {
+            int s = trajectory_step_after((radius - py) / vy);
+            if (s < step) step = s;
+        } else if (vy > 0.0f) {
+            int s = trajectory_step_after((entry->plane_y - py) / vy);
+            if (s < step) step = s;
+        }
+        for (int i = 0; i < MAX_BRICKS; i++) {
+            if (durability[i] != 0) {
+                const Brick* brick = &stage->bricks[i];
+                int s = trajectory_brick_step(px, py, vx, vy,
+                                              brick->x - radius, brick->y - radius,
+                                              brick->x + brick->width + radius,
+                                              brick->y + brick->height + radius);
+                if (s < step) step = s;
+            }
+        }
+
+        float t = step * TRAJECTORY_DT;
+        px += vx * t;
+        py += vy * t;
+        time += t;
+
+        int hits = 0;
+        bool more = true;
+        if (px - radius < 0.0f) {
+            px = radius;
+            vx = -vx;
+            hits++;
+            more = trajectory_add(entry, TRAJECTORY_WALL, px, py, time, -1);
+        } else if (px > right_wall) {
+            px = right_wall;
+            vx = -vx;
+            hits++;
+            more = trajectory_add(entry, TRAJECTORY_WALL, px, py, time, -1);
+        }
+        if (more && py - radius < 0.0f) {
+            py = radius;
+            vy = -vy;
+            hits++;
+            more = trajectory_add(entry, TRAJECTORY_CEILING, px, py, time, -1);
+        }
+        if (more && vy > 0.0f && py > entry->plane_y) {
+            trajectory_add(entry, TRAJECTORY_PADDLE, px, py, time, -1);
+            path->reaches_paddle = true;
+            break;
+        }
+        for (int i = 0; more && i < MAX_BRICKS; i++) {
+            if (durability[i] != 0 && trajectory_in_brick(&stage->bricks[i], px, py, radius)) {
+                vy = -vy;
+                hits++;
+                if (durability[i] > 0) {
+                    durability[i]--;    // Unbreakable bricks stay at -1
+                }
+                more = trajectory_add(entry, TRAJECTORY_BRICK, px, py, time, i);
+                break;
+            }
+        }
+
+        for (int i = 0; i < hits; i++) {
+            collisions++;
+            float scale = trajectory_speed(entry->base_speed, collisions) / sqrtf(vx * vx + vy * vy);
+            vx *= scale;
+            vy *= scale;
+        }
+    }
+}
+
+// Seconds the ball has travelled along the entry's first segment, or -1 if it
+// isn't on it (moved off the line or past the first contact)
+static float trajectory_on_path(const TrajectoryCacheEntry* entry, float x, float y) {
+    float dx = x - entry->origin_x;
+    float dy = y - entry->origin_y;
+    float speed_sq = entry->vx * entry->vx + entry->vy * entry->vy;
+    if (speed_sq == 0.0f) {
+        return dx == 0.0f && dy == 0.0f ? 0.0f : -1.0f;
+    }
+
+    float along = (dx * entry->vx + dy * entry->vy) / speed_sq;
+    float off = (dx * entry->vy - dy * entry->vx) / sqrtf(speed_sq);
+    if (fabsf(off) > TRAJECTORY_PATH_TOLERANCE || along < 0.0f ||
+        (entry->path.count > 0 && along > entry->times[0])) {
+        return -1.0f;
+    }
+    return along;
+}
+
+const Trajectory* trajectory_predict(const Ball* ball, const Stage* stage,
+                                     const Paddle* paddle, int max_bounces) {
+    if (max_bounces > TRAJECTORY_MAX_CONTACTS) {
+        max_bounces = TRAJECTORY_MAX_CONTACTS;
+    }
+
+    float x = phys_to_float(ball->x);
+    float y = phys_to_float(ball->y);
+    float vx = phys_to_float(ball->vx);
+    float vy = phys_to_float(ball->vy);
+    float base_speed = phys_to_float(ball->base_speed);
+    float plane_y = (float)paddle->bounds.y - phys_to_float(ball->radius);
+
+    s_stats.queries++;
+    s_clock++;
+
+    TrajectoryCacheEntry* entry = NULL;
+    TrajectoryCacheEntry* oldest = &s_cache[0];
+    float elapsed = 0.0f;
+    for (int i = 0; i < TRAJECTORY_CACHE_SIZE; i++) {
+        TrajectoryCacheEntry* e = &s_cache[i];
+        if (e->valid && e->stage == stage && e->stage_number == stage->stage_number &&
+            e->seed == stage->seed && e->revision == stage->revision &&
+            e->vx == vx && e->vy == vy && e->base_speed == base_speed &&
+            e->collision_count == ball->collision_count &&
+            e->plane_y == plane_y && e->max_bounces == max_bounces) {
+            elapsed = trajectory_on_path(e, x, y);
+            if (elapsed >= 0.0f) {
+                entry = e;
+                break;
+            }
+        }
+        if (!e->valid || e->last_used < oldest->last_used) {
+            oldest = e;
+        }
+    }
+
+    if (entry) {
+        s_stats.hits++;
+    } else {
+        entry = oldest;
+        entry->valid = true;
+        entry->stage = stage;
+        entry->stage_number = stage->stage_number;
+        entry->seed = stage->seed;
+        entry->revision = stage->revision;
+        entry->origin_x = x;
+        entry->origin_y = y;
+        entry->vx = vx;
+        entry->vy = vy;
+        entry->base_speed = base_speed;
+        entry->collision_count = ball->collision_count;
+        entry->plane_y = plane_y;
+        entry->max_bounces = max_bounces;
+        trajectory_cast(entry, stage, phys_to_float(ball->radius));
+        s_stats.casts++;
+        elapsed = 0.0f;
+    }
+
+    entry->last_used = s_clock;
+    for (int i = 0; i < entry->path.count; i++) {
+        entry->path.contacts[i].time = entry->times[i] - elapsed;
+    }
+    return &entry->path;
+}
+
+void trajectory_cache_clear(void) {
+    memset(s_cache, 0, sizeof(s_cache));
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_clock = 0;
+}
+
+TrajectoryStats trajectory_get_stats(void) {
+    return s_stats;
+}
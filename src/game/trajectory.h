@@ -0,0 +1,64 @@
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <stdbool.h>
+#include "ball.h"
+#include "paddle.h"
+#include "stage.h"
+
+// Ball trajectory prediction
+//
+// Casts the ball's path through the walls and live bricks until it reaches
+// the paddle's plane or max_bounces contacts. Instead of stepping tick by
+// tick it jumps straight to the next fixed step at which the gameplay update
+// would see a contact and reacts the same way (walls clamp and reflect,
+// bricks flip the vertical velocity, every contact speeds the ball up), so
+// the path matches the simulation rather than an idealized one. Bricks that
+// would break along the way are left out of the rest of the path.
+//
+// Results are cached. A cached path stays valid while the ball keeps moving
+// along its first segment with the same velocity and the stage's bricks are
+// unchanged (Stage.revision), so per-tick queries from a moving ball are
+// cache hits; contact times are then relative to the ball's current position.
+
+#define TRAJECTORY_MAX_CONTACTS 16
+#define TRAJECTORY_DT (1.0f / 60.0f)     // Fixed step of the gameplay update
+#define TRAJECTORY_CACHE_SIZE 4         // Paths kept (bot, preview, test queries)
+#define TRAJECTORY_PATH_TOLERANCE 0.5f  // Max distance from the cached path (pixels)
+
+typedef enum {
+    TRAJECTORY_WALL = 0,        // Left or right wall
+    TRAJECTORY_CEILING,
+    TRAJECTORY_BRICK,
+    TRAJECTORY_PADDLE           // Reached the paddle's plane (the path ends)
+} TrajectoryContactType;
+
+typedef struct {
+    TrajectoryContactType type;
+    float x;                    // Ball center at contact
+    float y;
+    float time;                 // Seconds from now
+    int brick;                  // Pool index for TRAJECTORY_BRICK, else -1
+} TrajectoryContact;
+
+typedef struct {
+    int count;
+    TrajectoryContact contacts[TRAJECTORY_MAX_CONTACTS];
+    bool reaches_paddle;        // Last contact is TRAJECTORY_PADDLE
+} Trajectory;
+
+typedef struct {
+    int queries;
+    int hits;
+    int casts;                  // Paths actually computed
+} TrajectoryStats;
+
+// Predict up to max_bounces contacts (at most TRAJECTORY_MAX_CONTACTS).
+// The result stays valid until the next call.
+const Trajectory* trajectory_predict(const Ball* ball, const Stage* stage,
+                                     const Paddle* paddle, int max_bounces);
+
+void trajectory_cache_clear(void);
+TrajectoryStats trajectory_get_stats(void);
+
+#endif // TRAJECTORY_H
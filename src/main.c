@@ -8,14 +8,35 @@
 #endif
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include "game/paddle.h"
 #include "game/ball.h"
+#include "game/entity.h"
+#include "game/powerup.h"
 #include "game/brick.h"
 #include "game/stage.h"
+#include "game/stage_gen.h"
 #include "game/score.h"
 #include "game/collision.h"
 #include "states/game_state.h"
+#include "bench.h"
+#include "fuzz.h"
+#include "systems/snapshot.h"
+#include "systems/persist.h"
+#include "systems/log.h"
+#include "systems/audio.h"
+#include "systems/metrics.h"
+#include "systems/stage_watch.h"
+#include "systems/texture_cache.h"
+#include "systems/alloc_track.h"
+#include "systems/stage_prep.h"
+#include "systems/startup.h"
+#include "systems/res_governor.h"
+#include "systems/frame_budget.h"
+#include "systems/capture.h"
+#include "systems/device_profile.h"
 
 // Screen constants
 #define SCREEN_WIDTH 960
@@ -29,9 +50,22 @@
 
 // Global game context for Emscripten main loop
 GameContext g_ctx;
+Renderer g_renderer;
 Paddle g_paddle;
 Ball g_ball;
 Stage g_stage;
+EntityStore g_entities;
+DeviceProfile g_profile;
+
+// Startup jobs: run on worker threads while the window and renderer are created
+static int startup_load_fonts(void* unused) {
+    return text_init(&g_ctx.text_renderer, &g_renderer) ? 1 : 0;
+}
+
+static int startup_read_assets(void* unused) {
+    sprite_prefetch();
+    return 1;
+}
 
 void main_loop(void) {
     if (g_ctx.quit) {
@@ -42,6 +76,7 @@ void main_loop(void) {
     }
 
     // Fixed timestep update
+    Uint64 frame_start = SDL_GetPerformanceCounter();
     Uint32 new_time = SDL_GetTicks();
     float frame_time = (new_time - g_ctx.current_time) / 1000.0f;
     g_ctx.current_time = new_time;
@@ -52,40 +87,211 @@ void main_loop(void) {
 
     g_ctx.accumulator += frame_time;
 
+    alloc_track_phase(ALLOC_PHASE_UPDATE);
+    int steps = 0;
     while (g_ctx.accumulator >= FIXED_DT) {
         state_update(&g_ctx, FIXED_DT);
         g_ctx.accumulator -= FIXED_DT;
+        steps++;
     }
 
     // Render current state
+    Uint64 render_start = SDL_GetPerformanceCounter();
+    alloc_track_phase(ALLOC_PHASE_RENDER);
     state_render(&g_ctx);
+    startup_first_frame();      // Only the first call records anything
+    alloc_track_frame_end();
+    Uint64 render_end = SDL_GetPerformanceCounter();
+
+    // Frame interval, plus the update+render work inside it (vsync hides the latter)
+    static Uint64 last_frame_start = 0;
+    double ms_per_tick = 1000.0 / (double)SDL_GetPerformanceFrequency();
+    if (last_frame_start != 0) {
+        METRICS_SAMPLE("frame.ms", 0.0, 64.0, (frame_start - last_frame_start) * ms_per_tick);
+    }
+    last_frame_start = frame_start;
+    double work_ms = (render_end - frame_start) * ms_per_tick;
+    METRICS_SAMPLE("frame.work_ms", 0.0, 32.0, work_ms);
+    frame_budget_frame((render_start - frame_start) * ms_per_tick,
+                       (render_end - render_start) * ms_per_tick);
+    res_governor_frame(work_ms);
+    METRICS_SAMPLE("frame.fixed_steps", 0.0, 16.0, steps);
+    METRICS_COUNT("sim.ticks", steps);
+    METRICS_GAUGE("log.dropped", log_get_dropped());
+    metrics_frame(new_time);
 
 #ifndef __EMSCRIPTEN__
-    SDL_Delay(1);
+    // Profiles drawing below 60 FPS sleep out the rest of the frame; the
+    // fixed steps still run 60 times a second
+    Uint32 frame_ms = 1000 / g_profile.frame_rate;
+    Uint32 spent = SDL_GetTicks() - new_time;
+    SDL_Delay(g_profile.frame_rate < SCREEN_FPS && spent < frame_ms ? frame_ms - spent : 1);
 #endif
 }
 
 int main(int argc, char* argv[]) {
+    startup_begin();
+
+    // Counting allocators have to be in place before SDL allocates anything
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--alloc-track") == 0 || strcmp(argv[i], "--test-alloc") == 0) {
+            alloc_track_install();
+        }
+    }
+
+    // Command-line options
+    bool endless_mode = false;
+    bool dirty_rects = false;
+    bool verbose = false;
+    bool metrics = false;
+    bool watch_stages = false;
+    bool startup_timeline = false;
+    bool dynamic_resolution = true;
+    bool quality_tiers = true;
+    bool capture = false;
+    bool recalibrate = false;
+    bool backend_chosen = false;
+    const char* profile_source = NULL;
+    int texture_budget_mb = TEXTURE_CACHE_BUDGET_MB;
+    const char* metrics_path = NULL;
+    const char* capture_path = NULL;
+    RenderBackendType backend = RENDER_BACKEND_GPU;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--endless") == 0) {
+            endless_mode = true;
+        } else if (strcmp(argv[i], "--dirty-rects") == 0) {
+            dirty_rects = true;
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else if (strncmp(argv[i], "--texture-budget=", 17) == 0) {
+            texture_budget_mb = atoi(argv[i] + 17);
+            if (texture_budget_mb <= 0) {
+                printf("Invalid texture budget '%s' (megabytes)\n", argv[i] + 17);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--watch-stages") == 0) {
+            watch_stages = true;
+        } else if (strcmp(argv[i], "--no-dynamic-resolution") == 0) {
+            dynamic_resolution = false;
+        } else if (strcmp(argv[i], "--fixed-quality") == 0) {
+            quality_tiers = false;
+        } else if (strcmp(argv[i], "--startup-timeline") == 0) {
+            startup_timeline = true;
+        } else if (strcmp(argv[i], "--metrics") == 0) {
+            metrics = true;
+        } else if (strncmp(argv[i], "--metrics=", 10) == 0) {
+            metrics = true;
+            metrics_path = argv[i] + 10;
+        } else if (strcmp(argv[i], "--capture") == 0) {
+            capture = true;
+        } else if (strncmp(argv[i], "--capture=", 10) == 0) {
+            capture = true;
+            capture_path = argv[i] + 10;
+        } else if (strncmp(argv[i], "--renderer=", 11) == 0) {
+            if (!render_backend_from_name(argv[i] + 11, &backend) ||
+                backend == RENDER_BACKEND_NULL || backend == RENDER_BACKEND_RECORD) {
+                printf("Unknown renderer '%s' (use gpu or software)\n", argv[i] + 11);
+                return 1;
+            }
+            backend_chosen = true;
+        } else if (strncmp(argv[i], "--profile=", 10) == 0) {
+            if (!device_profile_preset(argv[i] + 10, &g_profile)) {
+                printf("Unknown profile '%s' (use high, balanced or low)\n", argv[i] + 10);
+                return 1;
+            }
+            profile_source = "--profile";
+        } else if (strcmp(argv[i], "--recalibrate") == 0) {
+            recalibrate = true;
+        } else if (strcmp(argv[i], "--bench-stagegen") == 0) {
+            return stage_gen_benchmark() ? 0 : 1;
+        } else if (strcmp(argv[i], "--bench-render") == 0) {
+            return bench_render(BENCH_RENDER_FRAMES) ? 0 : 1;
+        } else if (strcmp(argv[i], "--bench-physics") == 0) {
+            return bench_physics(BENCH_PHYSICS_TICKS) ? 0 : 1;
+        } else if (strcmp(argv[i], "--bench-snapshot") == 0) {
+            return bench_snapshot(BENCH_SNAPSHOT_FRAMES) ? 0 : 1;
+        } else if (strcmp(argv[i], "--bench-persist") == 0) {
+            return bench_persist(BENCH_PERSIST_REQUESTS) ? 0 : 1;
+        } else if (strcmp(argv[i], "--bench-trajectory") == 0) {
+            return bench_trajectory(BENCH_TRAJECTORY_FRAMES) ? 0 : 1;
+        } else if (strcmp(argv[i], "--bench-timers") == 0) {
+            return bench_timers(BENCH_TIMER_TICKS) ? 0 : 1;
+        } else if (strcmp(argv[i], "--bench-tasks") == 0) {
+            return bench_tasks(BENCH_TASK_TICKS) ? 0 : 1;
+        } else if (strcmp(argv[i], "--fuzz-physics") == 0) {
+            return fuzz_physics(FUZZ_CASES) ? 0 : 1;
+        } else if (strncmp(argv[i], "--fuzz-physics=", 15) == 0) {
+            int cases = atoi(argv[i] + 15);
+            if (cases <= 0) {
+                printf("Invalid fuzz case count '%s'\n", argv[i] + 15);
+                return 1;
+            }
+            return fuzz_physics(cases) ? 0 : 1;
+        } else if (strncmp(argv[i], "--fuzz-replay=", 14) == 0) {
+            return fuzz_replay(argv[i] + 14) ? 0 : 1;
+        } else if (strcmp(argv[i], "--test-alloc") == 0) {
+            return bench_alloc(BENCH_ALLOC_FRAMES) ? 0 : 1;
+        } else if (strcmp(argv[i], "--bench-audio") == 0) {
+            return bench_audio(BENCH_AUDIO_EVENTS) ? 0 : 1;
+        }
+    }
+
+    // Partial redraw needs a target that keeps its pixels between frames
+    if (dirty_rects) {
+        backend = RENDER_BACKEND_SOFTWARE;
+        backend_chosen = true;
+    }
+
+    int step = startup_step_begin("SDL_Init");
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_JOYSTICK) < 0) {
         printf("SDL could not initialize! SDL_Error: %s\n", SDL_GetError());
         return 1;
     }
+    startup_step_end(step);
+
+    // Gameplay and frame-stat messages go through the background logger
+    log_init();
+    if (verbose) {
+        log_set_level(LOG_LEVEL_DEBUG);
+    }
+    if (metrics) {
+        metrics_init(metrics_path);
+    }
+
+    // Settings measured on this device at first launch (or forced with --profile)
+    bool calibrate = false;
+    if (!profile_source && !recalibrate && device_profile_load(&g_profile)) {
+        profile_source = "saved";
+    } else if (!profile_source) {
+        device_profile_preset("balanced", &g_profile);     // Until calibration replaces it
+        calibrate = true;
+    }
+    if (!backend_chosen && !calibrate) {
+        backend = (RenderBackendType)g_profile.backend;
+    }
+    startup_use_threads(g_profile.workers > 0);
+
+    // Fonts and the atlas image only need the file system: read them from
+    // storage while the window and renderer are created
+    StartupJob fonts_job = startup_spawn("fonts", startup_load_fonts, NULL);
+    StartupJob assets_job = startup_spawn("assets", startup_read_assets, NULL);
 
     // Open the first joystick if available (Vita controller or gamepad)
+    step = startup_step_begin("joystick");
     g_ctx.joystick = NULL;
     if (SDL_NumJoysticks() > 0) {
         g_ctx.joystick = SDL_JoystickOpen(0);
         if (g_ctx.joystick) {
-            printf("Joystick/Controller opened successfully\n");
-            printf("  Name: %s\n", SDL_JoystickName(g_ctx.joystick));
-            printf("  Axes: %d\n", SDL_JoystickNumAxes(g_ctx.joystick));
-            printf("  Buttons: %d\n", SDL_JoystickNumButtons(g_ctx.joystick));
-            printf("  Hats: %d\n", SDL_JoystickNumHats(g_ctx.joystick));
+            printf("Controller: %s (%d axes, %d buttons, %d hats)\n",
+                   SDL_JoystickName(g_ctx.joystick), SDL_JoystickNumAxes(g_ctx.joystick),
+                   SDL_JoystickNumButtons(g_ctx.joystick), SDL_JoystickNumHats(g_ctx.joystick));
         } else {
             printf("Warning: Could not open joystick! SDL_Error: %s\n", SDL_GetError());
         }
     }
+    startup_step_end(step);
 
+    step = startup_step_begin("window");
     g_ctx.window = SDL_CreateWindow(
         "BreakOut",
         SDL_WINDOWPOS_UNDEFINED,
@@ -97,58 +303,173 @@ int main(int argc, char* argv[]) {
 
     if (g_ctx.window == NULL) {
         printf("Window could not be created! SDL_Error: %s\n", SDL_GetError());
+        startup_join(fonts_job);
+        startup_join(assets_job);
         SDL_Quit();
         return 1;
     }
+    startup_step_end(step);
 
-    g_ctx.renderer = SDL_CreateRenderer(g_ctx.window, -1, SDL_RENDERER_ACCELERATED);
-
-    if (g_ctx.renderer == NULL) {
-        printf("Renderer could not be created! SDL_Error: %s\n", SDL_GetError());
+    step = startup_step_begin("renderer");
+    g_ctx.renderer = &g_renderer;
+    if (!render_create(&g_renderer, backend, g_ctx.window)) {
+        startup_join(fonts_job);
+        startup_join(assets_job);
         SDL_DestroyWindow(g_ctx.window);
         SDL_Quit();
         return 1;
     }
+    startup_step_end(step);
+
+    // Measure before anything holds textures, so the renderer can still be swapped
+    if (calibrate) {
+        step = startup_step_begin("calibrate");
+        bool fonts_ok = startup_join(fonts_job);
+        DeviceProfile measured;
+        if (!device_profile_calibrate(&g_renderer, g_ctx.window, fonts_ok ? g_ctx.text_renderer.font_small : NULL,
+                                      &measured)) {
+            startup_join(assets_job);
+            SDL_DestroyWindow(g_ctx.window);
+            SDL_Quit();
+            return 1;
+        }
+        g_profile = measured;
+        device_profile_save(&g_profile);
+        profile_source = "calibrated";
+        if (backend_chosen && g_renderer.type != backend) {
+            render_destroy(&g_renderer);
+            if (!render_create(&g_renderer, backend, g_ctx.window)) {
+                startup_join(assets_job);
+                SDL_DestroyWindow(g_ctx.window);
+                SDL_Quit();
+                return 1;
+            }
+        }
+        startup_step_end(step);
+    }
+    device_profile_print(&g_profile, profile_source);
+    render_set_vsync(&g_renderer, g_profile.vsync != 0);
+
+    // Shed optional work (HUD refreshes, dirty-rect detail) when frames run over
+    // budget, then lower the internal resolution (partial redraws already avoid
+    // full-screen fills and need 1:1 pixels)
+    frame_budget_init(g_ctx.renderer, quality_tiers, (QualityTier)g_profile.quality, g_profile.frame_rate);
+    res_governor_init(g_ctx.renderer, dynamic_resolution && !dirty_rects,
+                      dirty_rects ? 1.0f : g_profile.scale, g_profile.frame_rate);
+
+    // Record what was presented, for bug reports about hitches
+    if (capture) {
+        capture_init(g_ctx.renderer, capture_path);
+    }
 
     printf("BreakOut initialized! Controls:\n");
     printf("  LEFT/RIGHT arrows or A/D or D-Pad or Analog: Move paddle\n");
     printf("  SPACE or Cross (X): Launch ball\n");
     printf("  ESC or Select: Quit/Return to menu\n\n");
 
+    // Every texture (atlases, text) is owned by the cache
+    texture_cache_init(g_ctx.renderer, (size_t)texture_budget_mb * 1024 * 1024);
+
+    // Load sprite atlases before entities pick up their sprite handles
+    startup_join(assets_job);
+    step = startup_step_begin("sprites");
+    sprite_init(g_ctx.renderer);
+    startup_step_end(step);
+
     // Initialize game entities
     g_ctx.paddle = &g_paddle;
     g_ctx.ball = &g_ball;
     g_ctx.stage = &g_stage;
+    g_ctx.entities = &g_entities;
 
+    step = startup_step_begin("entities");
     paddle_init(&g_paddle, SCREEN_WIDTH / 2, SCREEN_HEIGHT - 40);
     ball_init(&g_ball, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
     stage_init(&g_stage, 1);
+    entity_store_init(&g_entities);
+    powerup_reset(&g_entities);
     score_init();
+    startup_step_end(step);
 
-    // Initialize text rendering
-    if (!text_init(&g_ctx.text_renderer, g_ctx.renderer)) {
+    // Text rendering (fonts were loaded on a worker)
+    if (!startup_join(fonts_job)) {
         printf("Warning: Text rendering failed to initialize. Game will use fallback rendering.\n");
     }
 
-    // Initialize state machine
+    // Initialize state machine (the first frame is presented by main_loop)
+    step = startup_step_begin("state init");
     state_init(&g_ctx);
+    startup_step_end(step);
+    g_ctx.endless_mode = endless_mode;
+    g_ctx.dirty_rects = dirty_rects;
+    g_ctx.rewind_enabled = true;
+    g_ctx.watch_stages = watch_stages && stage_watch_init(STAGE_DIR);
+    g_ctx.drawn_state = (GameStateType)-1;
+    damage_init(&g_ctx.damage, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+    // Sound effects (the game runs silent without an audio device)
+    step = startup_step_begin("audio");
+    audio_init();
+    startup_step_end(step);
+
+    // High score and progress (saved from a background thread)
+    step = startup_step_begin("save data");
+    persist_init(NULL);
+    startup_step_end(step);
+
+    // Next stages are built in the background while the current one is played
+    if (g_profile.workers > 0) {
+        stage_prep_init();
+    }
+
+    // Pick up a run that was interrupted by a suspend or quit
+    Snapshot resume;
+    if (snapshot_load(snapshot_resume_path(), &resume) && snapshot_apply(&g_ctx, &resume)) {
+        printf("Resumed game at stage %d (score %d, lives %d)\n",
+               g_ctx.current_stage, g_ctx.score, g_ctx.lives);
+        remove(snapshot_resume_path());
+    }
+
+    startup_finish(startup_timeline);
+
     g_ctx.current_time = SDL_GetTicks();
     g_ctx.accumulator = 0.0f;
 
 #ifdef __EMSCRIPTEN__
-    emscripten_set_main_loop(main_loop, 0, 1);
+    emscripten_set_main_loop(main_loop, g_profile.frame_rate < SCREEN_FPS ? g_profile.frame_rate : 0, 1);
 #else
     while (!g_ctx.quit) {
         main_loop();
     }
 #endif
 
+    // Quitting mid-run (including a launcher's SIGTERM) saves it for next launch
+    if (g_ctx.current_state == STATE_GAMEPLAY && !g_ctx.state_changed) {
+        Snapshot snap;
+        snapshot_capture(&g_ctx, &snap);
+        if (snapshot_save(&snap, snapshot_resume_path())) {
+            printf("Saved game for resume\n");
+        }
+    }
+
+    alloc_track_report();
+    stage_watch_shutdown();
+    stage_prep_shutdown();
+    metrics_shutdown();
+    persist_shutdown();
+    audio_shutdown();
     text_cleanup(&g_ctx.text_renderer);
+    sprite_cleanup();
+    texture_cache_shutdown();
+    res_governor_shutdown();
+    frame_budget_shutdown();
+    capture_shutdown();
     if (g_ctx.joystick) {
         SDL_JoystickClose(g_ctx.joystick);
     }
-    SDL_DestroyRenderer(g_ctx.renderer);
+    render_destroy(&g_renderer);
     SDL_DestroyWindow(g_ctx.window);
+    log_shutdown();
     SDL_Quit();
 
     return 0;
@@ -5,6 +5,17 @@
 #include "../game/stage.h"
 #include "../game/score.h"
 #include "../game/collision.h"
+#include "../game/game_events.h"
+#include "../game/powerup.h"
+#include "../systems/snapshot.h"
+#include "../systems/persist.h"
+#include "../systems/log.h"
+#include "../systems/audio.h"
+#include "../systems/metrics.h"
+#include "../systems/stage_watch.h"
+#include "../systems/stage_prep.h"
+#include "../systems/frame_budget.h"
+#include "../systems/task.h"
 #include <stdio.h>
 #include <math.h>
 #include <string.h>
@@ -16,6 +27,18 @@
 #define SCREEN_WIDTH 960
 #define SCREEN_HEIGHT 544
 #define FIXED_DT (1.0f / 60.0f)
+#define HUD_Y 10
+#define HUD_HEIGHT 32
+#define BANNER_Y 320
+#define BANNER_HEIGHT 48
+#define GAMEPLAY_INTRO_TICKS 90         // "Stage N" before the ball can launch
+#define GAMEPLAY_RESPAWN_TICKS 60       // Pause after a lost ball
+
+// Scripted sequences (stage intros, respawn pauses), advanced once per tick
+static TaskScheduler s_tasks;
+
+static void gameplay_subscribe(GameContext* ctx);
+static void gameplay_start_tasks(GameContext* ctx);
 
 // Initialize game state system
 void state_init(GameContext* ctx) {
@@ -26,7 +49,19 @@ void state_init(GameContext* ctx) {
     ctx->lives = 3;
     ctx->current_stage = 1;
     ctx->ball_launched = false;
+    ctx->endless_mode = false;
+    ctx->rewind_enabled = false;
+    ctx->result_saved = false;
+    ctx->dirty_rects = false;
+    ctx->hud_text[0] = '\0';
+    ctx->hud_age = 0;
+    ctx->launch_held = false;
+    ctx->banner_text[0] = '\0';
     ctx->quit = false;
+
+    task_scheduler_init(&s_tasks);
+    game_events_init();
+    gameplay_subscribe(ctx);
 }
 
 // Main state update dispatcher
@@ -35,9 +70,12 @@ void state_update(GameContext* ctx, float dt) {
     if (ctx->state_changed) {
         ctx->current_state = ctx->next_state;
         ctx->state_changed = false;
-        printf("State changed to: %d\n", ctx->current_state);
+        ctx->hud_text[0] = '\0';     // Never show the last game's HUD
+        LOG_DEBUG(LOG_CAT_GAME, "State changed to: %d\n", ctx->current_state);
     }
 
+    task_scheduler_tick(&s_tasks);
+
     // Dispatch to appropriate state update
     switch (ctx->current_state) {
         case STATE_TITLE:
@@ -55,11 +93,11 @@ void state_update(GameContext* ctx, float dt) {
     }
 }
 
-// Main state render dispatcher
-void state_render(GameContext* ctx) {
-    SDL_SetRenderDrawColor(ctx->renderer, 0, 0, 0, 255);
-    SDL_RenderClear(ctx->renderer);
+static void state_render_damaged(GameContext* ctx);
+static void gameplay_refresh_hud(GameContext* ctx);
 
+// Draw the current state's full frame
+static void state_render_current(GameContext* ctx) {
     switch (ctx->current_state) {
         case STATE_TITLE:
             state_title_render(ctx);
@@ -74,8 +112,26 @@ void state_render(GameContext* ctx) {
             state_gamecomplete_render(ctx);
             break;
     }
+}
+
+// Main state render dispatcher
+void state_render(GameContext* ctx) {
+    sprite_frame_begin();
+    if (ctx->current_state == STATE_GAMEPLAY) {
+        gameplay_refresh_hud(ctx);
+    }
 
-    SDL_RenderPresent(ctx->renderer);
+    if (ctx->dirty_rects) {
+        state_render_damaged(ctx);
+        return;
+    }
+
+    render_set_color(ctx->renderer, 0, 0, 0, 255);
+    render_clear(ctx->renderer);
+
+    state_render_current(ctx);
+
+    render_present(ctx->renderer);
 }
 
 // Transition to new state
@@ -103,9 +159,15 @@ void state_title_update(GameContext* ctx, float dt) {
                 ctx->current_stage = 1;
                 ctx->ball_launched = false;
                 score_init();
+                ctx->stage->seed = SDL_GetTicks();
                 stage_init(ctx->stage, ctx->current_stage);
                 paddle_init(ctx->paddle, SCREEN_WIDTH / 2, SCREEN_HEIGHT - 40);
                 ball_init(ctx->ball, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+                powerup_reset(ctx->entities);
+                entity_store_clear(ctx->entities);
+                rewind_reset();
+                ctx->result_saved = false;
+                gameplay_start_tasks(ctx);
                 return;
             }
             // Quit game
@@ -126,9 +188,15 @@ void state_title_update(GameContext* ctx, float dt) {
                 ctx->current_stage = 1;
                 ctx->ball_launched = false;
                 score_init();
+                ctx->stage->seed = SDL_GetTicks();
                 stage_init(ctx->stage, ctx->current_stage);
                 paddle_init(ctx->paddle, SCREEN_WIDTH / 2, SCREEN_HEIGHT - 40);
                 ball_init(ctx->ball, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+                powerup_reset(ctx->entities);
+                entity_store_clear(ctx->entities);
+                rewind_reset();
+                ctx->result_saved = false;
+                gameplay_start_tasks(ctx);
                 return;
             }
             // Circle (1) button to quit
@@ -141,8 +209,8 @@ void state_title_update(GameContext* ctx, float dt) {
 }
 
 void state_title_render(GameContext* ctx) {
-    SDL_SetRenderDrawColor(ctx->renderer, 0, 0, 50, 255); // Dark blue background
-    SDL_RenderClear(ctx->renderer);
+    render_set_color(ctx->renderer, 0, 0, 50, 255); // Dark blue background
+    render_clear(ctx->renderer);
 
     SDL_Color white = {255, 255, 255, 255};
     SDL_Color cyan = {100, 200, 255, 255};
@@ -151,6 +219,16 @@ void state_title_render(GameContext* ctx) {
     text_render_centered(&ctx->text_renderer, "VitaBreak", 120,
                         text_get_font_large(&ctx->text_renderer), white);
 
+    // Best result so far
+    const SaveData* save = persist_data();
+    if (save->high_score > 0) {
+        char high_text[64];
+        snprintf(high_text, sizeof(high_text), "High Score: %d  (Best Stage %d)",
+                 save->high_score, save->best_stage);
+        text_render_centered(&ctx->text_renderer, high_text, 200,
+                            text_get_font_small(&ctx->text_renderer), cyan);
+    }
+
     // Menu options
     text_render_centered(&ctx->text_renderer, "- Start", 280,
                         text_get_font_medium(&ctx->text_renderer), cyan);
@@ -165,19 +243,301 @@ void state_title_render(GameContext* ctx) {
 }
 
 // ===== GAMEPLAY STATE =====
+static SDL_Rect gameplay_ball_rect(GameContext* ctx) {
+    float x = phys_to_float(ctx->ball->x);
+    float y = phys_to_float(ctx->ball->y);
+    float radius = phys_to_float(ctx->ball->radius);
+    SDL_Rect ball_rect = {
+        (int)(x - radius),
+        (int)(y - radius),
+        (int)(radius * 2),
+        (int)(radius * 2)
+    };
+    return ball_rect;
+}
+
+static SDL_Rect gameplay_brick_rect(Brick* brick) {
+    SDL_Rect brick_rect = {
+        (int)brick->x,
+        (int)brick->y,
+        (int)brick->width,
+        (int)brick->height
+    };
+    return brick_rect;
+}
+
+// Stereo position of a point on screen, -128 (left) .. 128 (right)
+static int gameplay_pan(float x) {
+    return (int)(x * 256.0f / SCREEN_WIDTH) - 128;
+}
+
+// Once per rendered frame; lower quality tiers regenerate the text less often
+static void gameplay_refresh_hud(GameContext* ctx) {
+    if (ctx->hud_text[0] != '\0' && ++ctx->hud_age < frame_budget_settings()->hud_interval) {
+        return;
+    }
+    ctx->hud_age = 0;
+    snprintf(ctx->hud_text, sizeof(ctx->hud_text), "Score: %d  Lives: %d  Stage: %d",
+             ctx->score, ctx->lives, ctx->current_stage);
+}
+
+// Queue paddle, ball and brick sprites that touch clip (NULL queues everything)
+static void gameplay_queue_sprites(GameContext* ctx, const SDL_Rect* clip) {
+    SDL_Color white = {255, 255, 255, 255};
+
+    // Render paddle
+    if (!clip || SDL_HasIntersection(clip, &ctx->paddle->bounds)) {
+        sprite_batch_add(ctx->paddle->sprite, &ctx->paddle->bounds, white);
+    }
+
+    // Render ball
+    SDL_Rect ball_rect = gameplay_ball_rect(ctx);
+    if (!clip || SDL_HasIntersection(clip, &ball_rect)) {
+        sprite_batch_add(ctx->ball->sprite, &ball_rect, white);
+    }
+
+    // Render bricks
+    for (int i = 0; i < MAX_BRICKS; i++) {
+        if (ctx->stage->bricks[i].active) {
+            SDL_Rect brick_rect = gameplay_brick_rect(&ctx->stage->bricks[i]);
+            if (!clip || SDL_HasIntersection(clip, &brick_rect)) {
+                sprite_batch_add(ctx->stage->bricks[i].sprite, &brick_rect, white);
+            }
+        }
+    }
+
+    entity_system_queue_sprites(ctx->entities, clip);
+}
+
+// Apply an edited stage file in place, keeping the run (and untouched bricks) as is
+static void gameplay_reload_stage(GameContext* ctx) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    StageDiff diff;
+    if (!stage_reload(ctx->stage, &diff)) {
+        LOG_WARN(LOG_CAT_GAME, "Stage %d file not reloaded\n", ctx->current_stage);
+        return;
+    }
+    double us = (SDL_GetPerformanceCounter() - start) * 1000000.0 / SDL_GetPerformanceFrequency();
+
+    if (ctx->dirty_rects) {
+        damage_add_full(&ctx->damage);
+    }
+    LOG_INFO(LOG_CAT_GAME, "Reloaded stage %d in %.1f us: %d added, %d removed, %d retyped\n",
+             ctx->current_stage, us, diff.added, diff.removed, diff.retyped);
+}
+
+// Hand-built stages end the game unless endless mode keeps generating more
+static bool gameplay_last_stage(const GameContext* ctx) {
+    return !ctx->endless_mode && ctx->current_stage >= STAGE_HANDBUILT_COUNT;
+}
+
+static void gameplay_emit(GameContext* ctx, GameEventType type, int brick) {
+    GameEvent event = {.type = type, .x = phys_to_float(ctx->ball->x), .y = phys_to_float(ctx->ball->y),
+                       .brick = brick, .lives = ctx->lives, .stage = ctx->current_stage};
+    if (brick >= 0) {
+        event.points = brick_get_points(&ctx->stage->bricks[brick]);
+    }
+    game_events_emit(&event);
+}
+
+// ----- Gameplay event subscribers -----
+
+static void gameplay_on_score(const GameEvent* event, void* userdata) {
+    GameContext* ctx = userdata;
+    score_add(event->points);
+    ctx->score = score_get();
+    LOG_DEBUG(LOG_CAT_GAME, "Score: %d\n", ctx->score);
+}
+
+static void gameplay_on_sound(const GameEvent* event, void* userdata) {
+    int pan = gameplay_pan(event->x);
+    switch (event->type) {
+        case GAME_EVENT_PADDLE_HIT:
+            audio_play(SOUND_PADDLE_HIT, SDL_MIX_MAXVOLUME, pan);
+            break;
+        case GAME_EVENT_BRICK_HIT:
+            audio_play(SOUND_BRICK_HIT, SDL_MIX_MAXVOLUME, pan);
+            break;
+        case GAME_EVENT_BRICK_DESTROYED:
+            audio_play(SOUND_BRICK_BREAK, SDL_MIX_MAXVOLUME, pan);
+            break;
+        case GAME_EVENT_BALL_LOST:
+            audio_play(SOUND_BALL_LOST, SDL_MIX_MAXVOLUME, 0);
+            break;
+        default:
+            break;
+    }
+}
+
+static void gameplay_on_redraw(const GameEvent* event, void* userdata) {
+    GameContext* ctx = userdata;
+    if (!ctx->dirty_rects) {
+        return;
+    }
+    if (event->type == GAME_EVENT_STAGE_CLEARED) {
+        damage_add_full(&ctx->damage);
+    } else {
+        SDL_Rect brick_rect = gameplay_brick_rect(&ctx->stage->bricks[event->brick]);
+        damage_add(&ctx->damage, &brick_rect);
+    }
+}
+
+static void gameplay_on_progress(const GameEvent* event, void* userdata) {
+    GameContext* ctx = userdata;
+    if (event->type == GAME_EVENT_BALL_LOST) {
+        LOG_INFO(LOG_CAT_GAME, "Ball lost! Lives remaining: %d\n", event->lives);
+        if (event->lives <= 0) {
+            LOG_INFO(LOG_CAT_GAME, "GAME OVER! Final Score: %d\n", ctx->score);
+        }
+    } else if (event->type == GAME_EVENT_STAGE_CLEARED) {
+        LOG_INFO(LOG_CAT_GAME, "Stage %d cleared! Score: %d\n", event->stage, ctx->score);
+        if (gameplay_last_stage(ctx)) {
+            LOG_INFO(LOG_CAT_GAME, "ALL STAGES COMPLETE!\n");
+        } else {
+            persist_record_stage(event->stage + 1);
+        }
+    } else if (event->type == GAME_EVENT_POWERUP_CAUGHT) {
+        LOG_INFO(LOG_CAT_GAME, "Power-up: %s (%.0f s left)\n", powerup_name(event->powerup),
+                 powerup_seconds_left(event->powerup));
+    } else if (event->type == GAME_EVENT_POWERUP_EXPIRED) {
+        LOG_DEBUG(LOG_CAT_GAME, "Power-up ended: %s\n", powerup_name(event->powerup));
+    }
+}
+
+// Special bricks drop capsules; losing the ball loses every running effect
+static void gameplay_on_powerup(const GameEvent* event, void* userdata) {
+    GameContext* ctx = userdata;
+    if (event->type == GAME_EVENT_BALL_LOST) {
+        powerup_reset(ctx->entities);
+        return;
+    }
+
+    const Brick* brick = &ctx->stage->bricks[event->brick];
+    if (brick->type == BRICK_SPECIAL) {
+        Uint32 roll = ctx->stage->seed ^ ((Uint32)event->brick * 2654435761u) ^ (Uint32)ctx->current_stage;
+        powerup_spawn(ctx->entities, brick->x + brick->width / 2.0f, brick->y + brick->height / 2.0f, roll);
+    }
+}
+
+// Tasks waiting for an event type resume in the same batch
+static void gameplay_on_tasks(const GameEvent* event, void* userdata) {
+    task_scheduler_notify(&s_tasks, event->type, event);
+}
+
+static void gameplay_subscribe(GameContext* ctx) {
+    game_events_subscribe(GAME_EVENT_MASK(GAME_EVENT_BRICK_DESTROYED), gameplay_on_score, ctx);
+    game_events_subscribe(GAME_EVENT_MASK(GAME_EVENT_PADDLE_HIT) | GAME_EVENT_MASK(GAME_EVENT_BRICK_HIT) |
+                          GAME_EVENT_MASK(GAME_EVENT_BRICK_DESTROYED) | GAME_EVENT_MASK(GAME_EVENT_BALL_LOST),
+                          gameplay_on_sound, ctx);
+    game_events_subscribe(GAME_EVENT_MASK(GAME_EVENT_BRICK_HIT) | GAME_EVENT_MASK(GAME_EVENT_BRICK_DESTROYED) |
+                          GAME_EVENT_MASK(GAME_EVENT_STAGE_CLEARED), gameplay_on_redraw, ctx);
+    game_events_subscribe(GAME_EVENT_MASK(GAME_EVENT_BRICK_DESTROYED) | GAME_EVENT_MASK(GAME_EVENT_BALL_LOST),
+                          gameplay_on_powerup, ctx);
+    game_events_subscribe(GAME_EVENT_MASK(GAME_EVENT_BALL_LOST) | GAME_EVENT_MASK(GAME_EVENT_STAGE_CLEARED) |
+                          GAME_EVENT_MASK(GAME_EVENT_POWERUP_CAUGHT) | GAME_EVENT_MASK(GAME_EVENT_POWERUP_EXPIRED),
+                          gameplay_on_progress, ctx);
+    game_events_subscribe(GAME_EVENT_MASK_ALL, gameplay_on_tasks, ctx);
+}
+
+// Show banner mid-screen and keep the ball on the paddle; NULL ends both
+static void gameplay_hold_launch(GameContext* ctx, const char* banner) {
+    snprintf(ctx->banner_text, sizeof(ctx->banner_text), "%s", banner ? banner : "");
+    ctx->launch_held = banner != NULL;
+}
+
+// One per game: announces each stage and pauses after a lost ball.
+// locals[0] is the stage last announced.
+static TaskStatus gameplay_announcer(TaskScheduler* sched, Task* task) {
+    GameContext* ctx = task->userdata;
+    const GameEvent* event = task->event_data;
+    char banner[32];
+
+    TASK_BEGIN(task);
+    while (true) {
+        if (task->locals[0] != ctx->current_stage) {
+            task->locals[0] = ctx->current_stage;
+            snprintf(banner, sizeof(banner), "Stage %d", ctx->current_stage);
+            gameplay_hold_launch(ctx, banner);
+            TASK_WAIT_TICKS(task, GAMEPLAY_INTRO_TICKS);
+            gameplay_hold_launch(ctx, NULL);
+            continue;
+        }
+
+        TASK_WAIT_EVENT(task, GAME_EVENT_MASK(GAME_EVENT_BALL_LOST) |
+                              GAME_EVENT_MASK(GAME_EVENT_STAGE_CLEARED));
+        if (event->type == GAME_EVENT_BALL_LOST) {
+            if (event->lives <= 0) {
+                TASK_EXIT(task);
+            }
+            if (event->lives == 1) {
+                snprintf(banner, sizeof(banner), "Last Ball");
+            } else {
+                snprintf(banner, sizeof(banner), "%d Balls Left", event->lives);
+            }
+            gameplay_hold_launch(ctx, banner);
+            TASK_WAIT_TICKS(task, GAMEPLAY_RESPAWN_TICKS);
+            gameplay_hold_launch(ctx, NULL);
+        } else {
+            // The next stage is swapped in after this event batch
+            TASK_YIELD(task);
+        }
+    }
+    TASK_END(task);
+}
+
+// New game: drop the last game's sequences
+static void gameplay_start_tasks(GameContext* ctx) {
+    task_scheduler_clear(&s_tasks);
+    gameplay_hold_launch(ctx, NULL);
+    task_spawn(&s_tasks, gameplay_announcer, ctx, 0);
+}
+
+// Move on to the next stage, prepared in the background when possible
+static void gameplay_next_stage(GameContext* ctx) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    ctx->current_stage++;
+    bool prepared = stage_prep_take(ctx->stage, ctx->current_stage, ctx->stage->seed,
+                                    stage_watch_revision(ctx->current_stage));
+    if (!prepared) {
+        stage_init(ctx->stage, ctx->current_stage);
+    }
+    double us = (SDL_GetPerformanceCounter() - start) * 1000000.0 / SDL_GetPerformanceFrequency();
+
+    METRICS_SAMPLE("stage.swap_us", 0.0, 2000.0, us);
+    LOG_DEBUG(LOG_CAT_GAME, "Stage %d %s in %.1f us\n", ctx->current_stage,
+              prepared ? "swapped in" : "built", us);
+}
+
 void state_gameplay_update(GameContext* ctx, float dt) {
+    if (ctx->watch_stages && stage_watch_poll(ctx->current_stage)) {
+        gameplay_reload_stage(ctx);
+    }
+
+    // Keep the next stage ready for when this one is cleared
+    if (!gameplay_last_stage(ctx)) {
+        stage_prep_request(ctx->current_stage + 1, ctx->stage->seed,
+                           stage_watch_revision(ctx->current_stage + 1));
+    }
+
     SDL_Event e;
     while (SDL_PollEvent(&e) != 0) {
         if (e.type == SDL_QUIT) {
             ctx->quit = true;
         }
 
+        // The OS may kill us while suspended: keep the run resumable
+        if (e.type == SDL_APP_WILLENTERBACKGROUND || e.type == SDL_APP_TERMINATING) {
+            Snapshot snap;
+            snapshot_capture(ctx, &snap);
+            snapshot_save(&snap, snapshot_resume_path());
+        }
+
         if (e.type == SDL_KEYDOWN) {
             if (e.key.keysym.sym == SDLK_ESCAPE) {
                 state_transition(ctx, STATE_TITLE);
                 return;
             }
-            if (e.key.keysym.sym == SDLK_SPACE && !ctx->ball_launched) {
+            if (e.key.keysym.sym == SDLK_SPACE && !ctx->ball_launched && !ctx->launch_held) {
                 float angle = -M_PI / 2.0f + ((rand() % 60) - 30) * M_PI / 180.0f;
                 ball_launch(ctx->ball, angle);
                 ctx->ball_launched = true;
@@ -187,7 +547,8 @@ void state_gameplay_update(GameContext* ctx, float dt) {
         // Gamepad button support
         if (e.type == SDL_JOYBUTTONDOWN) {
             // Cross button (2) or Start button (11) to launch
-            if ((e.jbutton.button == 2 || e.jbutton.button == 11) && !ctx->ball_launched) {
+            if ((e.jbutton.button == 2 || e.jbutton.button == 11) &&
+                !ctx->ball_launched && !ctx->launch_held) {
                 float angle = -M_PI / 2.0f + ((rand() % 60) - 30) * M_PI / 180.0f;
                 ball_launch(ctx->ball, angle);
                 ctx->ball_launched = true;
@@ -204,6 +565,16 @@ void state_gameplay_update(GameContext* ctx, float dt) {
     const Uint8* keys = SDL_GetKeyboardState(NULL);
     float paddle_direction = 0.0f;
 
+    // Rewind: R or the L shoulder (button 4) steps back one tick per update
+    if (ctx->rewind_enabled && (keys[SDL_SCANCODE_R] ||
+        (ctx->joystick && SDL_JoystickGetButton(ctx->joystick, 4)))) {
+        Snapshot snap;
+        if (rewind_pop(&snap)) {
+            snapshot_apply(ctx, &snap);
+        }
+        return;
+    }
+
     // Keyboard controls
     if (keys[SDL_SCANCODE_LEFT] || keys[SDL_SCANCODE_A]) {
         paddle_direction = -1.0f;
@@ -236,62 +607,66 @@ void state_gameplay_update(GameContext* ctx, float dt) {
     paddle_move(ctx->paddle, paddle_direction, dt);
     paddle_update(ctx->paddle, dt);
 
+    // Free-moving entities, gone once they leave the screen
+    SDL_Rect screen = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+    entity_system_move(ctx->entities, dt);
+    entity_system_cull(ctx->entities, &screen);
+    powerup_tick(ctx->entities, ctx->paddle);
+    METRICS_GAUGE("entities.live", entity_get_stats(ctx->entities).live);
+
     // Ball physics
     if (ctx->ball_launched) {
-        ball_update(ctx->ball, dt);
-        collision_ball_walls(ctx->ball, SCREEN_WIDTH, SCREEN_HEIGHT);
-
-        if (collision_ball_paddle(ctx->ball, ctx->paddle)) {
-            collision_paddle_bounce(ctx->ball, ctx->paddle);
-        }
-
-        // Brick collision
-        for (int i = 0; i < MAX_BRICKS; i++) {
-            if (ctx->stage->bricks[i].active) {
-                if (collision_ball_brick(ctx->ball, &ctx->stage->bricks[i])) {
-                    bool destroyed = brick_hit(&ctx->stage->bricks[i]);
-                    collision_reflect_vertical(ctx->ball);
-                    ball_on_collision(ctx->ball);
-
-                    if (destroyed) {
-                        int points = brick_get_points(&ctx->stage->bricks[i]);
-                        score_add(points);
-                        ctx->score = score_get();
-                        printf("Score: %d\n", ctx->score);
-                    }
-                    break;
-                }
-            }
+        CollisionStep step;
+        collision_step(ctx->ball, ctx->paddle, ctx->stage, SCREEN_WIDTH, SCREEN_HEIGHT, dt, &step);
+
+        // Resolve the hits, leave the consequences to subscribers
+        if (step.paddle_hit) {
+            gameplay_emit(ctx, GAME_EVENT_PADDLE_HIT, -1);
         }
+        if (step.brick >= 0) {
+            METRICS_COUNT("brick.hit_calls", 1);
+            gameplay_emit(ctx, step.brick_destroyed ? GAME_EVENT_BRICK_DESTROYED : GAME_EVENT_BRICK_HIT,
+                          step.brick);
+        }
+        METRICS_COUNT("collision.tests", step.tests);
+        METRICS_COUNT("collision.hits", step.paddle_hit + (step.brick >= 0));
 
         // Ball loss
-        if (ctx->ball->y - ctx->ball->radius > SCREEN_HEIGHT) {
+        bool ball_lost = step.lost;
+        if (ball_lost) {
             ctx->lives--;
-            printf("Ball lost! Lives remaining: %d\n", ctx->lives);
+            gameplay_emit(ctx, GAME_EVENT_BALL_LOST, -1);
+        }
+
+        // Stage clear (a lost last ball ends the game first)
+        bool cleared = ctx->lives > 0 && stage_is_cleared(ctx->stage);
+        if (cleared) {
+            gameplay_emit(ctx, GAME_EVENT_STAGE_CLEARED, -1);
+        }
+
+        // Score, sound, redraw regions and logs for everything above
+        game_events_dispatch();
 
+        if (ball_lost) {
             if (ctx->lives > 0) {
                 ball_reset(ctx->ball, ctx->paddle->x);
                 ctx->ball_launched = false;
                 ball_reset_speed(ctx->ball);
             } else {
-                printf("GAME OVER! Final Score: %d\n", ctx->score);
                 state_transition(ctx, STATE_GAME_OVER);
                 return;
             }
         }
 
-        // Stage clear
-        if (stage_is_cleared(ctx->stage)) {
-            printf("Stage %d cleared! Score: %d\n", ctx->current_stage, ctx->score);
-
-            // For now, consider 3 stages as "game complete"
-            if (ctx->current_stage >= 3) {
-                printf("ALL STAGES COMPLETE!\n");
+        if (cleared) {
+            // Hand-built stages end the game unless endless mode keeps generating more
+            if (gameplay_last_stage(ctx)) {
                 state_transition(ctx, STATE_GAME_COMPLETE);
                 return;
             } else {
-                ctx->current_stage++;
-                stage_init(ctx->stage, ctx->current_stage);
+                gameplay_next_stage(ctx);
+                powerup_drop_capsules(ctx->entities);
+                entity_store_clear(ctx->entities);
                 ball_reset(ctx->ball, ctx->paddle->x);
                 ctx->ball_launched = false;
                 ball_reset_speed(ctx->ball);
@@ -299,52 +674,117 @@ void state_gameplay_update(GameContext* ctx, float dt) {
         }
     } else {
         // Ball follows paddle when not launched
-        ctx->ball->x = ctx->paddle->x;
-        ctx->ball->y = ctx->paddle->y - 30.0f;
+        ctx->ball->x = phys_from_float(ctx->paddle->x);
+        ctx->ball->y = phys_from_float(ctx->paddle->y - 30.0f);
+        game_events_dispatch();
+    }
+
+    if (ctx->rewind_enabled) {
+        Snapshot snap;
+        snapshot_capture(ctx, &snap);
+        rewind_push(&snap);
     }
 }
 
 void state_gameplay_render(GameContext* ctx) {
-    SDL_SetRenderDrawColor(ctx->renderer, 0, 0, 0, 255);
-    SDL_RenderClear(ctx->renderer);
+    render_set_color(ctx->renderer, 0, 0, 0, 255);
+    render_clear(ctx->renderer);
 
-    // Render paddle
-    SDL_SetRenderDrawColor(ctx->renderer, 255, 255, 255, 255);
-    SDL_RenderFillRect(ctx->renderer, &ctx->paddle->bounds);
+    // Sprites are queued and submitted in one batch per atlas
+    gameplay_queue_sprites(ctx, NULL);
+    sprite_batch_flush(ctx->renderer);
 
-    // Render ball
-    SDL_Rect ball_rect = {
-        (int)(ctx->ball->x - ctx->ball->radius),
-        (int)(ctx->ball->y - ctx->ball->radius),
-        (int)(ctx->ball->radius * 2),
-        (int)(ctx->ball->radius * 2)
-    };
-    SDL_RenderFillRect(ctx->renderer, &ball_rect);
+    // HUD: Score, Lives, and Stage
+    SDL_Color white = {255, 255, 255, 255};
+    text_render_centered(&ctx->text_renderer, ctx->hud_text, HUD_Y,
+                        text_get_font_small(&ctx->text_renderer), white);
 
-    // Render bricks
-    for (int i = 0; i < MAX_BRICKS; i++) {
-        if (ctx->stage->bricks[i].active) {
-            SDL_Rect brick_rect = {
-                (int)ctx->stage->bricks[i].x,
-                (int)ctx->stage->bricks[i].y,
-                (int)ctx->stage->bricks[i].width,
-                (int)ctx->stage->bricks[i].height
-            };
-            SDL_RenderFillRect(ctx->renderer, &brick_rect);
+    if (ctx->banner_text[0] != '\0') {
+        SDL_Color cyan = {100, 200, 255, 255};
+        text_render_centered(&ctx->text_renderer, ctx->banner_text, BANNER_Y,
+                            text_get_font_medium(&ctx->text_renderer), cyan);
+    }
+}
+
+// Partial redraw: only regions that changed since the last frame are cleared,
+// redrawn and pushed to the window surface
+static void state_render_damaged(GameContext* ctx) {
+    DamageTracker* damage = &ctx->damage;
+    damage_set_max_rects(damage, frame_budget_settings()->damage_max_rects);
+
+    if (ctx->drawn_state != ctx->current_state) {
+        damage_add_full(damage);
+        ctx->drawn_state = ctx->current_state;
+    }
+
+    // Static screens only redraw on state changes; gameplay tracks what moved
+    SDL_Rect hud_rect = {0, HUD_Y, SCREEN_WIDTH, HUD_HEIGHT};
+    SDL_Rect banner_rect = {0, BANNER_Y, SCREEN_WIDTH, BANNER_HEIGHT};
+    if (ctx->current_state == STATE_GAMEPLAY) {
+        SDL_Rect ball_rect = gameplay_ball_rect(ctx);
+        damage_add(damage, &ctx->drawn_ball_rect);
+        damage_add(damage, &ball_rect);
+        damage_add(damage, &ctx->drawn_paddle_rect);
+        damage_add(damage, &ctx->paddle->bounds);
+        ctx->drawn_ball_rect = ball_rect;
+        ctx->drawn_paddle_rect = ctx->paddle->bounds;
+        entity_system_damage(ctx->entities, damage);
+
+        if (strcmp(ctx->hud_text, ctx->drawn_hud_text) != 0) {
+            damage_add(damage, &hud_rect);
+            strcpy(ctx->drawn_hud_text, ctx->hud_text);
+        }
+        if (strcmp(ctx->banner_text, ctx->drawn_banner_text) != 0) {
+            damage_add(damage, &banner_rect);
+            strcpy(ctx->drawn_banner_text, ctx->banner_text);
         }
     }
 
-    // HUD: Score, Lives, and Stage
-    SDL_Color white = {255, 255, 255, 255};
-    char hud_text[64];
-    snprintf(hud_text, sizeof(hud_text), "Score: %d  Lives: %d  Stage: %d",
-             ctx->score, ctx->lives, ctx->current_stage);
-    text_render_centered(&ctx->text_renderer, hud_text, 10,
-                        text_get_font_small(&ctx->text_renderer), white);
+    if (damage->full) {
+        render_set_color(ctx->renderer, 0, 0, 0, 255);
+        render_clear(ctx->renderer);
+        state_render_current(ctx);
+        render_present(ctx->renderer);
+    } else {
+        SDL_Color white = {255, 255, 255, 255};
+        SDL_Color cyan = {100, 200, 255, 255};
+
+        for (int i = 0; i < damage->count; i++) {
+            const SDL_Rect* rect = &damage->rects[i];
+            render_set_clip(ctx->renderer, rect);
+            render_set_color(ctx->renderer, 0, 0, 0, 255);
+            render_fill_rect(ctx->renderer, rect);
+
+            gameplay_queue_sprites(ctx, rect);
+            sprite_batch_flush(ctx->renderer);
+
+            if (SDL_HasIntersection(rect, &hud_rect)) {
+                text_render_centered(&ctx->text_renderer, ctx->hud_text, HUD_Y,
+                                    text_get_font_small(&ctx->text_renderer), white);
+            }
+            if (ctx->banner_text[0] != '\0' && SDL_HasIntersection(rect, &banner_rect)) {
+                text_render_centered(&ctx->text_renderer, ctx->banner_text, BANNER_Y,
+                                    text_get_font_medium(&ctx->text_renderer), cyan);
+            }
+        }
+
+        if (damage->count > 0) {
+            render_set_clip(ctx->renderer, NULL);
+        }
+        render_present_rects(ctx->renderer, damage->rects, damage->count);
+    }
+
+    damage_reset(damage);
 }
 
 // ===== GAME OVER STATE =====
 void state_gameover_update(GameContext* ctx, float dt) {
+    // Queued for the background writer; never blocks on storage
+    if (!ctx->result_saved) {
+        persist_record_game(ctx->score, ctx->current_stage, false);
+        ctx->result_saved = true;
+    }
+
     SDL_Event e;
     while (SDL_PollEvent(&e) != 0) {
         if (e.type == SDL_QUIT) {
@@ -369,8 +809,8 @@ void state_gameover_update(GameContext* ctx, float dt) {
 }
 
 void state_gameover_render(GameContext* ctx) {
-    SDL_SetRenderDrawColor(ctx->renderer, 50, 0, 0, 255); // Dark red background
-    SDL_RenderClear(ctx->renderer);
+    render_set_color(ctx->renderer, 50, 0, 0, 255); // Dark red background
+    render_clear(ctx->renderer);
 
     SDL_Color red = {255, 100, 100, 255};
     SDL_Color white = {255, 255, 255, 255};
@@ -389,6 +829,12 @@ void state_gameover_render(GameContext* ctx) {
 
 // ===== GAME COMPLETE STATE =====
 void state_gamecomplete_update(GameContext* ctx, float dt) {
+    // Queued for the background writer; never blocks on storage
+    if (!ctx->result_saved) {
+        persist_record_game(ctx->score, ctx->current_stage, true);
+        ctx->result_saved = true;
+    }
+
     SDL_Event e;
     while (SDL_PollEvent(&e) != 0) {
         if (e.type == SDL_QUIT) {
@@ -413,8 +859,8 @@ void state_gamecomplete_update(GameContext* ctx, float dt) {
 }
 
 void state_gamecomplete_render(GameContext* ctx) {
-    SDL_SetRenderDrawColor(ctx->renderer, 0, 50, 0, 255); // Dark green background
-    SDL_RenderClear(ctx->renderer);
+    render_set_color(ctx->renderer, 0, 50, 0, 255); // Dark green background
+    render_clear(ctx->renderer);
 
     SDL_Color green = {100, 255, 100, 255};
     SDL_Color white = {255, 255, 255, 255};
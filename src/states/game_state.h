@@ -12,7 +12,11 @@
 #include "../game/paddle.h"
 #include "../game/ball.h"
 #include "../game/stage.h"
+#include "../game/entity.h"
+#include "../systems/render.h"
 #include "../systems/text.h"
+#include "../systems/sprite.h"
+#include "../systems/damage.h"
 
 // Game state types
 typedef enum {
@@ -33,17 +37,35 @@ typedef struct {
     int lives;
     int current_stage;
     bool ball_launched;
+    bool endless_mode;    // Keep generating stages after the hand-built ones
+    bool rewind_enabled;  // Record a snapshot per tick; hold R / L to rewind
+    bool result_saved;    // Finished game already handed to persistence
+    bool watch_stages;    // Reload the stage file when it changes on disk
+    bool launch_held;     // A stage intro or respawn pause is running
+    char banner_text[32];         // Shown mid-screen during gameplay when set
 
     // SDL resources
     SDL_Window* window;
-    SDL_Renderer* renderer;
+    Renderer* renderer;
     SDL_Joystick* joystick;
     TextRenderer text_renderer;
+    char hud_text[64];            // Score line, refreshed per the quality tier
+    int hud_age;                  // Frames since it was regenerated
 
     // Game entities
     Paddle* paddle;
     Ball* ball;
     Stage* stage;
+    EntityStore* entities;        // Capsules, lasers, extra balls
+
+    // Partial redraw mode (software backend only)
+    bool dirty_rects;
+    DamageTracker damage;
+    GameStateType drawn_state;    // State shown by the last rendered frame
+    SDL_Rect drawn_ball_rect;     // Bounds as last drawn, cleared when they move
+    SDL_Rect drawn_paddle_rect;
+    char drawn_hud_text[64];
+    char drawn_banner_text[32];
 
     // Timing
     Uint32 current_time;
@@ -0,0 +1,155 @@
+#include "alloc_track.h"
+#include "metrics.h"
+#include <stdio.h>
+#include <string.h>
+
+static SDL_malloc_func s_malloc = NULL;
+static SDL_calloc_func s_calloc = NULL;
+static SDL_realloc_func s_realloc = NULL;
+static SDL_free_func s_free = NULL;
+
+static bool s_installed = false;
+static SDL_threadID s_main_thread = 0;
+static AllocPhase s_phase = ALLOC_PHASE_FRAME;
+
+// Main-thread counts (only the main thread writes them)
+static AllocCounts s_frame[ALLOC_PHASE_COUNT];
+static AllocCounts s_last_frame;
+static AllocStats s_stats;
+
+// Counts from any thread
+static SDL_atomic_t s_frees;
+static SDL_atomic_t s_other;
+
+static const char* phase_names[ALLOC_PHASE_COUNT] = {"frame", "update", "render", "present"};
+
+static void alloc_track_count(size_t bytes) {
+    if (SDL_ThreadID() == s_main_thread) {
+        s_frame[s_phase].count++;
+        s_frame[s_phase].bytes += bytes;
+    } else {
+        SDL_AtomicAdd(&s_other, 1);
+    }
+}
+
+static void* SDLCALL alloc_track_malloc(size_t size) {
+    alloc_track_count(size);
+    return s_malloc(size);
+}
+
+static void* SDLCALL alloc_track_calloc(size_t count, size_t size) {
+    alloc_track_count(count * size);
+    return s_calloc(count, size);
+}
+
+static void* SDLCALL alloc_track_realloc(void* mem, size_t size) {
+    alloc_track_count(size);
+    return s_realloc(mem, size);
+}
+
+static void SDLCALL alloc_track_free(void* mem) {
+    if (mem) {
+        SDL_AtomicAdd(&s_frees, 1);
+    }
+    s_free(mem);
+}
+
+bool alloc_track_install(void) {
+    if (s_installed) {
+        return true;
+    }
+
+    SDL_GetMemoryFunctions(&s_malloc, &s_calloc, &s_realloc, &s_free);
+    s_main_thread = SDL_ThreadID();
+    if (SDL_SetMemoryFunctions(alloc_track_malloc, alloc_track_calloc,
+                               alloc_track_realloc, alloc_track_free) != 0) {
+        printf("Could not install allocation tracking: %s\n", SDL_GetError());
+        return false;
+    }
+
+    s_installed = true;
+    alloc_track_reset();
+    return true;
+}
+
+bool alloc_track_installed(void) {
+    return s_installed;
+}
+
+void alloc_track_phase(AllocPhase phase) {
+    s_phase = phase;
+}
+
+void alloc_track_frame_end(void) {
+    if (!s_installed) {
+        return;
+    }
+
+    AllocCounts total = {0, 0};
+    for (int i = 0; i < ALLOC_PHASE_COUNT; i++) {
+        s_stats.phases[i].count += s_frame[i].count;
+        s_stats.phases[i].bytes += s_frame[i].bytes;
+        total.count += s_frame[i].count;
+        total.bytes += s_frame[i].bytes;
+    }
+
+    s_stats.frames++;
+    if (total.count > 0) {
+        s_stats.frames_with_allocs++;
+    }
+    if (total.count > s_stats.max_frame_count) {
+        s_stats.max_frame_count = total.count;
+    }
+    if (total.bytes > s_stats.max_frame_bytes) {
+        s_stats.max_frame_bytes = total.bytes;
+    }
+    METRICS_COUNT("alloc.count", total.count);
+    METRICS_COUNT("alloc.bytes", total.bytes);
+
+    s_last_frame = total;
+    memset(s_frame, 0, sizeof(s_frame));
+    s_phase = ALLOC_PHASE_FRAME;
+}
+
+void alloc_track_reset(void) {
+    memset(s_frame, 0, sizeof(s_frame));
+    memset(&s_last_frame, 0, sizeof(s_last_frame));
+    memset(&s_stats, 0, sizeof(s_stats));
+    SDL_AtomicSet(&s_frees, 0);
+    SDL_AtomicSet(&s_other, 0);
+    s_phase = ALLOC_PHASE_FRAME;
+}
+
+AllocStats alloc_track_get_stats(void) {
+    AllocStats stats = s_stats;
+    stats.frees = (Uint64)SDL_AtomicGet(&s_frees);
+    stats.other_threads = (Uint64)SDL_AtomicGet(&s_other);
+    return stats;
+}
+
+AllocCounts alloc_track_last_frame(void) {
+    return s_last_frame;
+}
+
+void alloc_track_report(void) {
+    if (!s_installed) {
+        return;
+    }
+
+    AllocStats stats = alloc_track_get_stats();
+    int frames = stats.frames > 0 ? stats.frames : 1;
+    printf("Allocations over %d frames: %d frames allocated, worst %llu allocs / %llu bytes\n",
+           stats.frames, stats.frames_with_allocs,
+           (unsigned long long)stats.max_frame_count, (unsigned long long)stats.max_frame_bytes);
+    for (int i = 0; i < ALLOC_PHASE_COUNT; i++) {
+        printf("  %-8s %8llu allocs %10llu bytes  (%.2f allocs/frame)\n", phase_names[i],
+               (unsigned long long)stats.phases[i].count, (unsigned long long)stats.phases[i].bytes,
+               (double)stats.phases[i].count / frames);
+    }
+    printf("  other threads %llu allocs, %llu frees in total\n",
+           (unsigned long long)stats.other_threads, (unsigned long long)stats.frees);
+}
+
+const char* alloc_track_phase_name(AllocPhase phase) {
+    return phase >= 0 && phase < ALLOC_PHASE_COUNT ? phase_names[phase] : "?";
+}
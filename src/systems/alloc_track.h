@@ -0,0 +1,59 @@
+#ifndef ALLOC_TRACK_H
+#define ALLOC_TRACK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#if defined(__EMSCRIPTEN__) || defined(_WIN32)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+
+// Allocation tracking
+//
+// Installs counting allocators with SDL_SetMemoryFunctions, so every SDL
+// allocation (surfaces, textures, events, TTF) and every SDL_malloc in game
+// code is counted. Allocations on the main thread are attributed to the
+// current phase of the frame; other threads (audio, logger, save writer)
+// are only counted in total. Allocations made inside the C library itself
+// (e.g. stdio buffers) don't go through SDL and aren't seen.
+
+typedef enum {
+    ALLOC_PHASE_FRAME = 0,      // Main loop bookkeeping
+    ALLOC_PHASE_UPDATE,         // Events and fixed steps
+    ALLOC_PHASE_RENDER,         // Building the frame
+    ALLOC_PHASE_PRESENT,
+    ALLOC_PHASE_COUNT
+} AllocPhase;
+
+typedef struct {
+    Uint64 count;
+    Uint64 bytes;
+} AllocCounts;
+
+typedef struct {
+    AllocCounts phases[ALLOC_PHASE_COUNT];  // Main thread, since the last reset
+    Uint64 frees;
+    Uint64 other_threads;                   // Allocations off the main thread
+    int frames;
+    int frames_with_allocs;
+    Uint64 max_frame_count;                 // Worst frame
+    Uint64 max_frame_bytes;
+} AllocStats;
+
+// Must run before SDL allocates anything (first thing in main)
+bool alloc_track_install(void);
+bool alloc_track_installed(void);
+
+void alloc_track_phase(AllocPhase phase);
+void alloc_track_frame_end(void);           // Close the frame's counts; phase back to FRAME
+void alloc_track_reset(void);
+
+AllocStats alloc_track_get_stats(void);
+AllocCounts alloc_track_last_frame(void);   // Main-thread total of the last closed frame
+void alloc_track_report(void);
+
+const char* alloc_track_phase_name(AllocPhase phase);
+
+#endif // ALLOC_TRACK_H
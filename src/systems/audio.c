@@ -0,0 +1,376 @@
+#include "audio.h"
+#include "log.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define AUDIO_QUEUE_MASK (AUDIO_QUEUE_SIZE - 1)
+#define AUDIO_LATENCY_BUCKETS 128   // Pickup histogram, 0.25 ms per bucket
+
+typedef enum {
+    WAVE_SQUARE = 0,
+    WAVE_SINE,
+    WAVE_NOISE
+} Waveform;
+
+// Recipe for a synthesized effect: a pitch sweep with a linear decay
+typedef struct {
+    const char* name;
+    Waveform wave;
+    float start_hz;
+    float end_hz;
+    int duration_ms;
+    float gain;
+} SoundRecipe;
+
+static const SoundRecipe sound_recipes[SOUND_COUNT] = {
+    {"paddle_hit", WAVE_SQUARE, 440.0f, 440.0f, 40, 0.30f},
+    {"brick_hit", WAVE_SQUARE, 660.0f, 620.0f, 30, 0.25f},
+    {"brick_break", WAVE_NOISE, 0.0f, 0.0f, 90, 0.35f},
+    {"ball_lost", WAVE_SINE, 392.0f, 98.0f, 450, 0.45f},
+};
+
+typedef struct {
+    Sint16* pcm;                // Mono, device rate
+    int length;                 // Frames
+} SoundBuffer;
+
+typedef struct {
+    Uint64 ticks;               // When it was queued, for latency stats
+    Uint8 sound;
+    Uint8 volume;
+    Sint16 pan;
+} AudioCommand;
+
+typedef struct {
+    const SoundBuffer* sound;   // NULL when free
+    int position;
+    int gain_left;              // Q7: 128 = unity
+    int gain_right;
+} Voice;
+
+static SDL_AudioDeviceID s_device = 0;
+static SDL_AudioSpec s_spec;
+static SoundBuffer s_sounds[SOUND_COUNT];
+static Sint32* s_mix = NULL;        // Callback accumulator, allocated at init
+
+// Single producer (game thread), single consumer (audio callback)
+static AudioCommand s_queue[AUDIO_QUEUE_SIZE];
+static SDL_atomic_t s_queue_head;   // Next command to mix (callback)
+static SDL_atomic_t s_queue_tail;   // Next free slot (game thread)
+static int s_dropped = 0;
+
+// Callback-only state
+static Voice s_voices[AUDIO_VOICES];
+static int s_played = 0;
+static int s_stolen = 0;
+static int s_callbacks = 0;
+static int s_peak = 0;
+static Uint64 s_pickup_ticks = 0;
+static Uint64 s_pickup_max_ticks = 0;
+static int s_pickup_hist[AUDIO_LATENCY_BUCKETS];
+static Uint64 s_ticks_per_bucket = 1;
+
+static bool audio_load_wav(SoundBuffer* buffer, const char* name) {
+    char path[128];
+    snprintf(path, sizeof(path), "assets/sfx/%s.wav", name);
+
+    SDL_AudioSpec wav_spec;
+    Uint8* wav_data = NULL;
+    Uint32 wav_length = 0;
+    if (!SDL_LoadWAV(path, &wav_spec, &wav_data, &wav_length)) {
+        return false;
+    }
+
+    SDL_AudioCVT cvt;
+    if (SDL_BuildAudioCVT(&cvt, wav_spec.format, wav_spec.channels, wav_spec.freq,
+                          AUDIO_S16SYS, 1, s_spec.freq) < 0) {
+        LOG_WARN(LOG_CAT_SYSTEM, "Unsupported sound format in %s: %s\n", path, SDL_GetError());
+        SDL_FreeWAV(wav_data);
+        return false;
+    }
+
+    cvt.len = (int)wav_length;
+    cvt.buf = (Uint8*)SDL_malloc((size_t)cvt.len * cvt.len_mult);
+    if (!cvt.buf) {
+        SDL_FreeWAV(wav_data);
+        return false;
+    }
+    memcpy(cvt.buf, wav_data, wav_length);
+    SDL_FreeWAV(wav_data);
+
+    if (cvt.needed && SDL_ConvertAudio(&cvt) < 0) {
+        LOG_WARN(LOG_CAT_SYSTEM, "Failed to convert %s: %s\n", path, SDL_GetError());
+        SDL_free(cvt.buf);
+        return false;
+    }
+
+    buffer->pcm = (Sint16*)cvt.buf;
+    buffer->length = (cvt.needed ? cvt.len_cvt : cvt.len) / (int)sizeof(Sint16);
+    return true;
+}
+
+static bool audio_synthesize(SoundBuffer* buffer, const SoundRecipe* recipe) {
+    int length = s_spec.freq * recipe->duration_ms / 1000;
+    buffer->pcm = (Sint16*)SDL_malloc((size_t)length * sizeof(Sint16));
+    if (!buffer->pcm) {
+        return false;
+    }
+    buffer->length = length;
+
+    double phase = 0.0;
+    Uint32 noise = 0x12345678u;
+    for (int i = 0; i < length; i++) {
+        float t = (float)i / length;
+        float hz = recipe->start_hz + (recipe->end_hz - recipe->start_hz) * t;
+        phase += hz / s_spec.freq;
+        phase -= floor(phase);
+
+        float value;
+        switch (recipe->wave) {
+            case WAVE_SQUARE:
+                value = phase < 0.5 ? 1.0f : -1.0f;
+                break;
+            case WAVE_SINE:
+                value = (float)sin(phase * 2.0 * M_PI);
+                break;
+            default:
+                noise = noise * 1664525u + 1013904223u;
+                value = (Sint32)noise / 2147483648.0f;
+                break;
+        }
+
+        // Short attack avoids a click; linear decay after that
+        float attack = i < 64 ? i / 64.0f : 1.0f;
+        buffer->pcm[i] = (Sint16)(value * recipe->gain * attack * (1.0f - t) * 32767.0f);
+    }
+    return true;
+}
+
+static void audio_start_voice(const AudioCommand* command) {
+    // Free voice, else steal the one furthest through its sound
+    Voice* voice = NULL;
+    for (int i = 0; i < AUDIO_VOICES; i++) {
+        if (!s_voices[i].sound) {
+            voice = &s_voices[i];
+            break;
+        }
+        if (!voice || s_voices[i].position > voice->position) {
+            voice = &s_voices[i];
+        }
+    }
+    if (voice->sound) {
+        s_stolen++;
+    }
+
+    int pan = command->pan;
+    voice->sound = &s_sounds[command->sound];
+    voice->position = 0;
+    voice->gain_left = command->volume * (128 - (pan > 0 ? pan : 0)) / 128;
+    voice->gain_right = command->volume * (128 + (pan < 0 ? pan : 0)) / 128;
+}
+
+static void audio_callback(void* userdata, Uint8* stream, int len) {
+    Sint16* out = (Sint16*)stream;
+    int channels = s_spec.channels;
+    int frames = len / (int)(sizeof(Sint16) * channels);
+    if (frames > s_spec.samples) {
+        // Never expected, but the accumulator only holds one device buffer
+        memset(stream, 0, len);
+        frames = s_spec.samples;
+    }
+
+    // Pick up everything queued since the last callback. Sample the clock
+    // after the tail so every command picked up was stamped before now.
+    int head = SDL_AtomicGet(&s_queue_head);
+    int tail = SDL_AtomicGet(&s_queue_tail);
+    Uint64 now = SDL_GetPerformanceCounter();
+    while (head != tail) {
+        const AudioCommand* command = &s_queue[head & AUDIO_QUEUE_MASK];
+        Uint64 waited = now > command->ticks ? now - command->ticks : 0;
+        s_pickup_ticks += waited;
+        if (waited > s_pickup_max_ticks) {
+            s_pickup_max_ticks = waited;
+        }
+        Uint64 bucket = waited / s_ticks_per_bucket;
+        s_pickup_hist[bucket < AUDIO_LATENCY_BUCKETS ? bucket : AUDIO_LATENCY_BUCKETS - 1]++;
+        audio_start_voice(command);
+        s_played++;
+        head++;
+    }
+    SDL_AtomicSet(&s_queue_head, head);
+    s_callbacks++;
+
+    memset(s_mix, 0, (size_t)frames * 2 * sizeof(Sint32));
+    for (int v = 0; v < AUDIO_VOICES; v++) {
+        Voice* voice = &s_voices[v];
+        if (!voice->sound) {
+            continue;
+        }
+        const Sint16* pcm = voice->sound->pcm + voice->position;
+        int count = voice->sound->length - voice->position;
+        if (count > frames) {
+            count = frames;
+        }
+        for (int i = 0; i < count; i++) {
+            s_mix[i * 2] += pcm[i] * voice->gain_left;
+            s_mix[i * 2 + 1] += pcm[i] * voice->gain_right;
+        }
+        voice->position += count;
+        if (voice->position >= voice->sound->length) {
+            voice->sound = NULL;
+        }
+    }
+
+    // Q7 gains back to 16 bits with clipping; mono sums, extra channels stay silent
+    int peak = s_peak;
+    for (int i = 0; i < frames; i++) {
+        Sint32 left = s_mix[i * 2] >> 7;
+        Sint32 right = s_mix[i * 2 + 1] >> 7;
+        if (channels == 1) {
+            left = (left + right) / 2;
+        }
+        left = left > 32767 ? 32767 : (left < -32768 ? -32768 : left);
+        right = right > 32767 ? 32767 : (right < -32768 ? -32768 : right);
+        if (abs(left) > peak) peak = abs(left);
+        if (abs(right) > peak) peak = abs(right);
+
+        Sint16* frame = &out[i * channels];
+        frame[0] = (Sint16)left;
+        for (int c = 1; c < channels; c++) {
+            frame[c] = c == 1 ? (Sint16)right : 0;
+        }
+    }
+    s_peak = peak;
+}
+
+bool audio_init(void) {
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
+        LOG_WARN(LOG_CAT_SYSTEM, "Audio unavailable: %s\n", SDL_GetError());
+        return false;
+    }
+
+    SDL_AudioSpec desired;
+    SDL_zero(desired);
+    desired.freq = AUDIO_FREQUENCY;
+    desired.format = AUDIO_S16SYS;
+    desired.channels = 2;
+    desired.samples = AUDIO_SAMPLES;
+    desired.callback = audio_callback;
+
+    // Any rate or channel count works (effects are built for the device);
+    // the sample format and buffer size are what the mixer relies on
+    s_device = SDL_OpenAudioDevice(NULL, 0, &desired, &s_spec,
+                                   SDL_AUDIO_ALLOW_FREQUENCY_CHANGE | SDL_AUDIO_ALLOW_CHANNELS_CHANGE);
+    if (s_device == 0) {
+        LOG_ERROR(LOG_CAT_SYSTEM, "Failed to open audio device: %s\n", SDL_GetError());
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        return false;
+    }
+
+    s_mix = (Sint32*)SDL_malloc((size_t)s_spec.samples * 2 * sizeof(Sint32));
+    bool ok = s_mix != NULL;
+    for (int i = 0; ok && i < SOUND_COUNT; i++) {
+        if (!audio_load_wav(&s_sounds[i], sound_recipes[i].name)) {
+            ok = audio_synthesize(&s_sounds[i], &sound_recipes[i]);
+        }
+    }
+    if (!ok) {
+        LOG_ERROR(LOG_CAT_SYSTEM, "Failed to allocate sound buffers\n");
+        audio_shutdown();
+        return false;
+    }
+
+    memset(s_voices, 0, sizeof(s_voices));
+    SDL_AtomicSet(&s_queue_head, 0);
+    SDL_AtomicSet(&s_queue_tail, 0);
+    s_dropped = 0;
+    s_played = 0;
+    s_stolen = 0;
+    s_callbacks = 0;
+    s_peak = 0;
+    s_pickup_ticks = 0;
+    s_pickup_max_ticks = 0;
+    memset(s_pickup_hist, 0, sizeof(s_pickup_hist));
+    s_ticks_per_bucket = SDL_GetPerformanceFrequency() / 4000;
+
+    LOG_INFO(LOG_CAT_SYSTEM, "Audio: %s, %d Hz, %d channels, %d-frame buffer (%.1f ms)\n",
+                             SDL_GetCurrentAudioDriver(), s_spec.freq, s_spec.channels, s_spec.samples,
+                             1000.0 * s_spec.samples / s_spec.freq);
+    SDL_PauseAudioDevice(s_device, 0);
+    return true;
+}
+
+void audio_shutdown(void) {
+    if (s_device != 0) {
+        SDL_CloseAudioDevice(s_device);
+        s_device = 0;
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    }
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        SDL_free(s_sounds[i].pcm);
+        s_sounds[i].pcm = NULL;
+        s_sounds[i].length = 0;
+    }
+    SDL_free(s_mix);
+    s_mix = NULL;
+}
+
+void audio_play(SoundId sound, int volume, int pan) {
+    if (s_device == 0 || sound < 0 || sound >= SOUND_COUNT) {
+        return;
+    }
+
+    int tail = SDL_AtomicGet(&s_queue_tail);
+    if (tail - SDL_AtomicGet(&s_queue_head) >= AUDIO_QUEUE_SIZE) {
+        s_dropped++;
+        return;
+    }
+
+    AudioCommand* command = &s_queue[tail & AUDIO_QUEUE_MASK];
+    command->ticks = SDL_GetPerformanceCounter();
+    command->sound = (Uint8)sound;
+    command->volume = (Uint8)(volume < 0 ? 0 : (volume > SDL_MIX_MAXVOLUME ? SDL_MIX_MAXVOLUME : volume));
+    command->pan = (Sint16)(pan < -128 ? -128 : (pan > 128 ? 128 : pan));
+    SDL_AtomicSet(&s_queue_tail, tail + 1);     // Publishes the command
+}
+
+AudioStats audio_get_stats(void) {
+    AudioStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (s_device == 0) {
+        return stats;
+    }
+
+    SDL_LockAudioDevice(s_device);
+    stats.played = s_played;
+    stats.stolen = s_stolen;
+    stats.callbacks = s_callbacks;
+    stats.peak = s_peak;
+    Uint64 pickup_ticks = s_pickup_ticks;
+    Uint64 pickup_max_ticks = s_pickup_max_ticks;
+    int hist[AUDIO_LATENCY_BUCKETS];
+    memcpy(hist, s_pickup_hist, sizeof(hist));
+    SDL_UnlockAudioDevice(s_device);
+
+    // 99th percentile from the histogram (upper edge of its bucket)
+    int remaining = stats.played / 100;
+    for (int i = AUDIO_LATENCY_BUCKETS - 1; i >= 0; i--) {
+        remaining -= hist[i];
+        if (remaining < 0 || i == 0) {
+            stats.pickup_p99_ms = (i + 1) * 0.25;
+            break;
+        }
+    }
+
+    double ms = 1000.0 / (double)SDL_GetPerformanceFrequency();
+    stats.frequency = s_spec.freq;
+    stats.samples = s_spec.samples;
+    stats.channels = s_spec.channels;
+    stats.dropped = s_dropped;
+    stats.pickup_max_ms = pickup_max_ticks * ms;
+    stats.pickup_avg_ms = stats.played ? pickup_ticks * ms / stats.played : 0.0;
+    stats.buffer_ms = 1000.0 * s_spec.samples / s_spec.freq;
+    return stats;
+}
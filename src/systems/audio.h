@@ -0,0 +1,65 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#if defined(__EMSCRIPTEN__) || defined(_WIN32)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+#include <stdbool.h>
+
+// Sound effects
+//
+// Every effect is decoded (or synthesized) once at init into mono 16-bit PCM
+// at the device rate. Gameplay posts play commands into a lock-free queue;
+// the SDL audio callback drains it and mixes a fixed set of voices, so the
+// callback never allocates, locks or touches a file. Effects load from
+// assets/sfx/<name>.wav when present and are synthesized otherwise.
+//
+// Latency from audio_play() to the speaker is at most one callback period to
+// pick the command up plus one device buffer to play it out.
+
+#define AUDIO_FREQUENCY 48000
+#ifdef __EMSCRIPTEN__
+#define AUDIO_SAMPLES 1024          // Browsers can't keep up with smaller buffers
+#else
+#define AUDIO_SAMPLES 128           // Frames per callback: 2.7 ms at 48 kHz
+#endif
+#define AUDIO_VOICES 8              // Simultaneous sounds; the oldest is stolen
+#define AUDIO_QUEUE_SIZE 64         // Pending play commands; power of two
+
+typedef enum {
+    SOUND_PADDLE_HIT = 0,
+    SOUND_BRICK_HIT,
+    SOUND_BRICK_BREAK,
+    SOUND_BALL_LOST,
+    SOUND_COUNT
+} SoundId;
+
+typedef struct {
+    int frequency;              // Device rate and buffer actually obtained
+    int samples;
+    int channels;
+    int played;                 // Commands picked up by the mixer
+    int dropped;                // Commands lost to a full queue
+    int stolen;                 // Voices cut short for a new sound
+    int callbacks;
+    int peak;                   // Largest output sample magnitude
+    double pickup_max_ms;       // audio_play() to the callback that starts it
+    double pickup_avg_ms;
+    double pickup_p99_ms;
+    double buffer_ms;           // One device buffer
+} AudioStats;
+
+// Open the audio device and build the sound cache. Returns false (and the
+// game runs silent) if there is no audio device.
+bool audio_init(void);
+void audio_shutdown(void);
+
+// Queue a sound from the game thread. volume is 0..SDL_MIX_MAXVOLUME,
+// pan is -128 (left) .. 128 (right).
+void audio_play(SoundId sound, int volume, int pan);
+
+AudioStats audio_get_stats(void);
+
+#endif // AUDIO_H
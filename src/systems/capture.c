@@ -0,0 +1,295 @@
+#include "capture.h"
+#include "log.h"
+#include "metrics.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    Uint8* pixels;              // ARGB8888, width * height
+    Uint32 number;              // Presented frame number
+    double interval_ms;         // Since the previous present
+    int dropped_before;         // Dropped since the previous queued frame
+} CaptureFrame;
+
+static FILE* s_file = NULL;
+static char s_path[512];
+static int s_width = 0;
+static int s_height = 0;
+
+static SDL_Thread* s_thread = NULL;
+static SDL_mutex* s_lock = NULL;
+static SDL_cond* s_wake = NULL;
+static bool s_quit = false;
+
+// Ring of frames: the game thread fills at s_head, the encoder takes from
+// s_tail; s_count (guarded by s_lock) says which slots belong to whom
+static CaptureFrame s_frames[CAPTURE_POOL_FRAMES];
+static int s_head = 0;
+static int s_tail = 0;
+static int s_count = 0;
+
+// Encoder only
+static Uint8* s_yuv = NULL;
+
+// Game thread
+static Uint64 s_last_present = 0;
+static int s_dropped_run = 0;
+static Uint64 s_readback_ticks = 0;
+static Uint64 s_readback_max_ticks = 0;
+
+// Encoder counters (guarded by s_lock) and game thread counters
+static CaptureStats s_stats;
+static Uint64 s_encode_ticks = 0;
+static Uint64 s_encode_max_ticks = 0;
+
+static size_t capture_yuv_size(void) {
+    int chroma = ((s_width + 1) / 2) * ((s_height + 1) / 2);
+    return (size_t)s_width * s_height + 2 * (size_t)chroma;
+}
+
+// Full-range BT.601 (what C420jpeg means), chroma averaged over 2x2 blocks
+static void capture_convert(const Uint8* pixels, Uint8* yuv) {
+    int chroma_width = (s_width + 1) / 2;
+    int chroma_height = (s_height + 1) / 2;
+    Uint8* plane_y = yuv;
+    Uint8* plane_u = yuv + (size_t)s_width * s_height;
+    Uint8* plane_v = plane_u + (size_t)chroma_width * chroma_height;
+    const Uint32* argb = (const Uint32*)pixels;
+
+    for (int y = 0; y < s_height; y++) {
+        const Uint32* row = argb + (size_t)y * s_width;
+        for (int x = 0; x < s_width; x++) {
+            int r = (row[x] >> 16) & 0xFF;
+            int g = (row[x] >> 8) & 0xFF;
+            int b = row[x] & 0xFF;
+            plane_y[(size_t)y * s_width + x] = (Uint8)((77 * r + 150 * g + 29 * b + 128) >> 8);
+        }
+    }
+
+    for (int cy = 0; cy < chroma_height; cy++) {
+        for (int cx = 0; cx < chroma_width; cx++) {
+            int r = 0, g = 0, b = 0, n = 0;
+            for (int dy = 0; dy < 2 && cy * 2 + dy < s_height; dy++) {
+                const Uint32* row = argb + (size_t)(cy * 2 + dy) * s_width;
+                for (int dx = 0; dx < 2 && cx * 2 + dx < s_width; dx++) {
+                    Uint32 p = row[cx * 2 + dx];
+                    r += (p >> 16) & 0xFF;
+                    g += (p >> 8) & 0xFF;
+                    b += p & 0xFF;
+                    n++;
+                }
+            }
+            r /= n;
+            g /= n;
+            b /= n;
+            int u = ((-43 * r - 85 * g + 128 * b + 128) >> 8) + 128;
+            int v = ((128 * r - 107 * g - 21 * b + 128) >> 8) + 128;
+            plane_u[(size_t)cy * chroma_width + cx] = (Uint8)(u < 0 ? 0 : u > 255 ? 255 : u);
+            plane_v[(size_t)cy * chroma_width + cx] = (Uint8)(v < 0 ? 0 : v > 255 ? 255 : v);
+        }
+    }
+}
+
+static bool capture_write(const CaptureFrame* frame) {
+    capture_convert(frame->pixels, s_yuv);
+    // X* are application parameters; Y4M readers skip them
+    return fprintf(s_file, "FRAME Xframe=%u Xms=%.3f Xdropped=%d\n",
+                   frame->number, frame->interval_ms, frame->dropped_before) > 0 &&
+           fwrite(s_yuv, capture_yuv_size(), 1, s_file) == 1;
+}
+
+static int capture_thread(void* unused) {
+    SDL_LockMutex(s_lock);
+    while (true) {
+        while (s_count == 0 && !s_quit) {
+            SDL_CondWait(s_wake, s_lock);
+        }
+        if (s_count == 0) {
+            break;  // Quitting with everything encoded
+        }
+        CaptureFrame* frame = &s_frames[s_tail];
+        SDL_UnlockMutex(s_lock);
+
+        Uint64 start = SDL_GetPerformanceCounter();
+        bool ok = capture_write(frame);
+        Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+
+        SDL_LockMutex(s_lock);
+        if (ok) {
+            s_stats.written++;
+        } else if (s_stats.failures++ == 0) {
+            LOG_ERROR(LOG_CAT_SYSTEM, "Failed to write captured frame to %s\n", s_path);
+        }
+        s_encode_ticks += elapsed;
+        if (elapsed > s_encode_max_ticks) {
+            s_encode_max_ticks = elapsed;
+        }
+        s_tail = (s_tail + 1) % CAPTURE_POOL_FRAMES;
+        s_count--;
+    }
+    SDL_UnlockMutex(s_lock);
+    return 0;
+}
+
+static void capture_free_buffers(void) {
+    for (int i = 0; i < CAPTURE_POOL_FRAMES; i++) {
+        SDL_free(s_frames[i].pixels);
+        s_frames[i].pixels = NULL;
+    }
+    SDL_free(s_yuv);
+    s_yuv = NULL;
+}
+
+bool capture_init(const Renderer* renderer, const char* path) {
+    if (!renderer->sdl) {
+        LOG_WARN(LOG_CAT_RENDER, "Frame capture needs the gpu or software renderer\n");
+        return false;
+    }
+    snprintf(s_path, sizeof(s_path), "%s", path ? path : CAPTURE_FILE);
+    s_width = renderer->output_width;
+    s_height = renderer->output_height;
+
+    // Every buffer is allocated here; capturing itself allocates nothing
+    bool ok = true;
+    for (int i = 0; i < CAPTURE_POOL_FRAMES; i++) {
+        s_frames[i].pixels = (Uint8*)SDL_malloc((size_t)s_width * s_height * 4);
+        ok = ok && s_frames[i].pixels;
+    }
+    s_yuv = (Uint8*)SDL_malloc(capture_yuv_size());
+    if (!ok || !s_yuv) {
+        LOG_ERROR(LOG_CAT_RENDER, "Not enough memory for %d captured frames\n", CAPTURE_POOL_FRAMES);
+        capture_free_buffers();
+        return false;
+    }
+
+    s_file = fopen(s_path, "wb");
+    if (!s_file) {
+        LOG_ERROR(LOG_CAT_RENDER, "Failed to open capture file %s\n", s_path);
+        capture_free_buffers();
+        return false;
+    }
+    fprintf(s_file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", s_width, s_height, CAPTURE_FPS);
+
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_readback_ticks = 0;
+    s_readback_max_ticks = 0;
+    s_encode_ticks = 0;
+    s_encode_max_ticks = 0;
+    s_head = 0;
+    s_tail = 0;
+    s_count = 0;
+    s_last_present = 0;
+    s_dropped_run = 0;
+    s_quit = false;
+
+    // Encoding on the game thread would stall it: no thread, no capture
+    s_lock = SDL_CreateMutex();
+    s_wake = SDL_CreateCond();
+    s_thread = (s_lock && s_wake) ? SDL_CreateThread(capture_thread, "capture", NULL) : NULL;
+    if (!s_thread) {
+        LOG_WARN(LOG_CAT_RENDER, "Capture encoder thread unavailable, frame capture disabled\n");
+        capture_shutdown();
+        return false;
+    }
+    LOG_INFO(LOG_CAT_RENDER, "Capturing %dx%d frames to %s\n", s_width, s_height, s_path);
+    return true;
+}
+
+void capture_shutdown(void) {
+    if (s_thread) {
+        SDL_LockMutex(s_lock);
+        s_quit = true;
+        SDL_CondSignal(s_wake);
+        SDL_UnlockMutex(s_lock);
+        SDL_WaitThread(s_thread, NULL);
+        s_thread = NULL;
+
+        CaptureStats stats = capture_get_stats();
+        LOG_INFO(LOG_CAT_SYSTEM, "Capture: %d of %d frames written, %d dropped, %d failed\n",
+                 stats.written, stats.frames, stats.dropped, stats.failures);
+        LOG_INFO(LOG_CAT_SYSTEM, "Capture overhead: readback avg %.2f ms (max %.2f), encode avg %.2f ms (max %.2f)\n",
+                 stats.readback_avg_ms, stats.readback_max_ms, stats.encode_avg_ms, stats.encode_max_ms);
+    }
+    if (s_wake) {
+        SDL_DestroyCond(s_wake);
+        s_wake = NULL;
+    }
+    if (s_lock) {
+        SDL_DestroyMutex(s_lock);
+        s_lock = NULL;
+    }
+    if (s_file) {
+        fclose(s_file);
+        s_file = NULL;
+    }
+    capture_free_buffers();
+}
+
+bool capture_active(void) {
+    return s_thread != NULL;
+}
+
+Uint64 capture_frame(Renderer* renderer) {
+    if (!s_thread) {
+        return 0;
+    }
+    Uint64 start = SDL_GetPerformanceCounter();
+    double ms_per_tick = 1000.0 / (double)SDL_GetPerformanceFrequency();
+    double interval_ms = s_last_present ? (start - s_last_present) * ms_per_tick : 0.0;
+    s_last_present = start;
+    s_stats.frames++;
+
+    // The head slot is ours unless the encoder still has every slot queued
+    SDL_LockMutex(s_lock);
+    bool full = s_count == CAPTURE_POOL_FRAMES;
+    SDL_UnlockMutex(s_lock);
+
+    CaptureFrame* frame = &s_frames[s_head];
+    if (full || renderer->output_width != s_width || renderer->output_height != s_height ||
+        SDL_RenderReadPixels(renderer->sdl, NULL, SDL_PIXELFORMAT_ARGB8888,
+                             frame->pixels, s_width * 4) != 0) {
+        s_stats.dropped++;
+        s_dropped_run++;
+        METRICS_COUNT("capture.dropped", 1);
+        return SDL_GetPerformanceCounter() - start;
+    }
+    frame->number = (Uint32)s_stats.frames;
+    frame->interval_ms = interval_ms;
+    frame->dropped_before = s_dropped_run;
+    s_dropped_run = 0;
+    s_head = (s_head + 1) % CAPTURE_POOL_FRAMES;
+
+    SDL_LockMutex(s_lock);
+    s_count++;
+    s_stats.queued++;
+    SDL_CondSignal(s_wake);
+    SDL_UnlockMutex(s_lock);
+
+    Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+    s_readback_ticks += elapsed;
+    if (elapsed > s_readback_max_ticks) {
+        s_readback_max_ticks = elapsed;
+    }
+    METRICS_SAMPLE("capture.readback_ms", 0.0, 16.0, elapsed * ms_per_tick);
+    return elapsed;
+}
+
+CaptureStats capture_get_stats(void) {
+    if (s_lock) {
+        SDL_LockMutex(s_lock);
+    }
+    CaptureStats stats = s_stats;
+    Uint64 encode_ticks = s_encode_ticks;
+    Uint64 encode_max_ticks = s_encode_max_ticks;
+    if (s_lock) {
+        SDL_UnlockMutex(s_lock);
+    }
+
+    double ms = 1000.0 / (double)SDL_GetPerformanceFrequency();
+    stats.readback_max_ms = s_readback_max_ticks * ms;
+    stats.readback_avg_ms = stats.queued ? s_readback_ticks * ms / stats.queued : 0.0;
+    stats.encode_max_ms = encode_max_ticks * ms;
+    int encoded = stats.written + stats.failures;
+    stats.encode_avg_ms = encoded ? encode_ticks * ms / encoded : 0.0;
+    return stats;
+}
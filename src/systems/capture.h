@@ -0,0 +1,51 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdbool.h>
+#include "render.h"
+
+// Frame capture for performance bug reports
+//
+// Each presented frame is read back (just before present, so the back
+// buffer is still valid) into one of a few preallocated buffers and handed
+// to a background thread, which converts it to YUV 4:2:0 and appends it to
+// a Y4M file. Every frame header carries the frame number, its time since
+// the previous present and how many frames were dropped before it, so a
+// hitch shows up in the footage and in the numbers next to it. When the
+// encoder falls behind and every buffer is still queued, the frame is
+// dropped rather than waiting: capture never stalls the main loop beyond
+// the readback itself, which is timed and reported.
+
+#define CAPTURE_FILE "capture.y4m"
+#define CAPTURE_POOL_FRAMES 4           // Frames read back but not yet encoded
+#define CAPTURE_FPS 60                  // Nominal rate in the Y4M header
+
+typedef struct {
+    int frames;                 // Presented while capturing
+    int queued;                 // Read back and handed to the encoder
+    int dropped;                // All buffers busy (or the output size changed)
+    int written;
+    int failures;               // Failed writes
+    double readback_max_ms;     // Main thread cost per captured frame
+    double readback_avg_ms;
+    double encode_max_ms;       // Encoder thread, conversion plus write
+    double encode_avg_ms;
+} CaptureStats;
+
+// Start capturing to path (NULL: CAPTURE_FILE). Needs an SDL backend and
+// threads; false (and capture stays off) otherwise.
+bool capture_init(const Renderer* renderer, const char* path);
+
+// Encode what is queued, close the file and report the overhead
+void capture_shutdown(void);
+
+bool capture_active(void);
+
+// Called by the renderer with the finished frame still in the back buffer.
+// Returns the performance counter ticks spent, so present timing can leave
+// them out.
+Uint64 capture_frame(Renderer* renderer);
+
+CaptureStats capture_get_stats(void);
+
+#endif // CAPTURE_H
@@ -0,0 +1,105 @@
+#include "damage.h"
+#include "log.h"
+
+static int damage_area(const SDL_Rect* rect) {
+    return rect->w * rect->h;
+}
+
+static int damage_total_area(const DamageTracker* damage) {
+    int total = 0;
+    for (int i = 0; i < damage->count; i++) {
+        total += damage_area(&damage->rects[i]);
+    }
+    return total;
+}
+
+void damage_init(DamageTracker* damage, int width, int height) {
+    damage->count = 0;
+    damage->max_rects = DAMAGE_MAX_RECTS;
+    damage->full = true;  // Nothing on screen yet
+    damage->width = width;
+    damage->height = height;
+    damage->report_frames = 0;
+    damage->report_coverage = 0.0;
+}
+
+void damage_add(DamageTracker* damage, const SDL_Rect* rect) {
+    if (damage->full || SDL_RectEmpty(rect)) {
+        return;
+    }
+
+    SDL_Rect target = {0, 0, damage->width, damage->height};
+    SDL_Rect merged;
+    if (!SDL_IntersectRect(rect, &target, &merged)) {
+        return;
+    }
+
+    // Absorb overlapping rects; repeat because the union can grow into others
+    bool absorbed = true;
+    while (absorbed) {
+        absorbed = false;
+        for (int i = 0; i < damage->count; i++) {
+            if (SDL_HasIntersection(&merged, &damage->rects[i])) {
+                SDL_UnionRect(&merged, &damage->rects[i], &merged);
+                damage->rects[i] = damage->rects[--damage->count];
+                absorbed = true;
+                break;
+            }
+        }
+    }
+
+    // Out of slots: fold into the rect whose bounding box grows the least
+    if (damage->count >= damage->max_rects) {
+        int best = 0;
+        int best_growth = -1;
+        for (int i = 0; i < damage->count; i++) {
+            SDL_Rect joined;
+            SDL_UnionRect(&merged, &damage->rects[i], &joined);
+            int growth = damage_area(&joined) - damage_area(&damage->rects[i]);
+            if (best_growth < 0 || growth < best_growth) {
+                best = i;
+                best_growth = growth;
+            }
+        }
+        SDL_UnionRect(&merged, &damage->rects[best], &merged);
+        damage->rects[best] = damage->rects[--damage->count];
+    }
+
+    damage->rects[damage->count++] = merged;
+
+    // Past this point a single full redraw is cheaper than many rects
+    if (damage_total_area(damage) * 100 > damage->width * damage->height * DAMAGE_FULL_PERCENT) {
+        damage_add_full(damage);
+    }
+}
+
+void damage_set_max_rects(DamageTracker* damage, int max_rects) {
+    if (max_rects < 1) {
+        max_rects = 1;
+    } else if (max_rects > DAMAGE_MAX_RECTS) {
+        max_rects = DAMAGE_MAX_RECTS;
+    }
+    damage->max_rects = max_rects;
+}
+
+void damage_add_full(DamageTracker* damage) {
+    damage->full = true;
+    damage->count = 0;
+}
+
+void damage_reset(DamageTracker* damage) {
+    double coverage = damage->full ? 1.0
+        : (double)damage_total_area(damage) / (damage->width * damage->height);
+
+    damage->report_coverage += coverage;
+    damage->report_frames++;
+    if (damage->report_frames >= DAMAGE_REPORT_INTERVAL) {
+        LOG_INFO(LOG_CAT_RENDER, "Redraw coverage: %.1f%% of the screen per frame\n",
+                 100.0 * damage->report_coverage / damage->report_frames);
+        damage->report_frames = 0;
+        damage->report_coverage = 0.0;
+    }
+
+    damage->count = 0;
+    damage->full = false;
+}
@@ -0,0 +1,49 @@
+#ifndef DAMAGE_H
+#define DAMAGE_H
+
+#include <stdbool.h>
+
+#if defined(__EMSCRIPTEN__) || defined(_WIN32)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+
+// Dirty rectangle tracking for partial redraws
+//
+// Used with a software renderer drawing straight into the window surface,
+// which keeps its contents between frames. Only damaged regions are cleared,
+// redrawn and pushed to the screen with SDL_UpdateWindowSurfaceRects.
+
+#define DAMAGE_MAX_RECTS 16
+#define DAMAGE_FULL_PERCENT 50          // Switch to a full redraw above this coverage
+#define DAMAGE_REPORT_INTERVAL 600      // Frames between coverage reports (10s at 60 FPS)
+
+typedef struct {
+    SDL_Rect rects[DAMAGE_MAX_RECTS];
+    int count;
+    int max_rects;              // Rects kept apart before merging (at most DAMAGE_MAX_RECTS)
+    bool full;                  // Whole target must be redrawn
+    int width;                  // Target size
+    int height;
+
+    // Coverage stats
+    int report_frames;
+    double report_coverage;     // Sum of per-frame redrawn fractions
+} DamageTracker;
+
+void damage_init(DamageTracker* damage, int width, int height);
+
+// Mark a region (clipped to the target, merged with overlapping rects)
+void damage_add(DamageTracker* damage, const SDL_Rect* rect);
+
+// Fewer rects means fewer, larger redraw passes; set before the frame adds any
+void damage_set_max_rects(DamageTracker* damage, int max_rects);
+
+// Mark the whole target
+void damage_add_full(DamageTracker* damage);
+
+// Clear for the next frame, recording coverage of the frame just drawn
+void damage_reset(DamageTracker* damage);
+
+#endif // DAMAGE_H
@@ -0,0 +1,267 @@
+#include "device_profile.h"
+#include "persist.h"
+#include "log.h"
+#include "../game/paddle.h"
+#include "../game/ball.h"
+#include "../game/stage.h"
+#include "../game/collision.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define DEVICE_BUDGET_MS (1000.0f / 60.0f)
+#define DEVICE_FILL_SHARE 0.5f          // Calibration frame may use this share of the budget
+#define DEVICE_VSYNC_SHARE 0.25f        // Vsync only with this much headroom (else it halves the rate)
+#define DEVICE_TICK_SHARE 0.25f         // Two ticks per frame above this: draw at 30 FPS
+#define DEVICE_TEXT_MEDIUM_MS 1.0f      // HUD string rasterization that starts at medium quality...
+#define DEVICE_TEXT_LOW_MS 4.0f         // ...and at low quality
+
+static const float s_scales[] = {1.0f, 0.875f, 0.75f, 0.625f, 0.5f};
+
+typedef struct {
+    const char* name;
+    DeviceProfile settings;
+} DevicePreset;
+
+static const DevicePreset s_presets[] = {
+    {"high",     {.backend = RENDER_BACKEND_GPU, .vsync = 1, .scale = 1.0f, .frame_rate = 60,
+                  .quality = QUALITY_HIGH, .workers = DEVICE_MAX_WORKERS}},
+    {"balanced", {.backend = RENDER_BACKEND_GPU, .vsync = 0, .scale = 1.0f, .frame_rate = 60,
+                  .quality = QUALITY_MEDIUM, .workers = 1}},
+    {"low",      {.backend = RENDER_BACKEND_GPU, .vsync = 0, .scale = 0.5f, .frame_rate = 30,
+                  .quality = QUALITY_LOW, .workers = 0}},
+};
+
+static Stage s_stage;               // Calibration stage (too big for the stack on the Vita)
+
+static Uint32 device_profile_checksum(const DeviceProfile* profile) {
+    const Uint8* bytes = (const Uint8*)profile;
+    Uint32 hash = 2166136261u;
+    for (size_t i = 0; i < offsetof(DeviceProfile, checksum); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void device_profile_path(char* path, size_t size) {
+    snprintf(path, size, "%s%s", persist_pref_dir(), DEVICE_PROFILE_FILE);
+}
+
+static double device_ms(Uint64 ticks) {
+    return ticks * 1000.0 / (double)SDL_GetPerformanceFrequency();
+}
+
+bool device_profile_preset(const char* name, DeviceProfile* profile) {
+    for (int i = 0; i < (int)(sizeof(s_presets) / sizeof(s_presets[0])); i++) {
+        if (strcmp(name, s_presets[i].name) == 0) {
+            *profile = s_presets[i].settings;
+            profile->magic = DEVICE_PROFILE_MAGIC;
+            profile->version = DEVICE_PROFILE_VERSION;
+            return true;
+        }
+    }
+    return false;
+}
+
+// A checksum only proves the file is intact; the settings are used as
+// divisors and array indices, so they have to be ones calibration can pick
+static bool device_profile_in_range(const DeviceProfile* profile) {
+    int count = (int)(sizeof(s_scales) / sizeof(s_scales[0]));
+    return (profile->backend == RENDER_BACKEND_GPU || profile->backend == RENDER_BACKEND_SOFTWARE) &&
+           (profile->vsync == 0 || profile->vsync == 1) &&
+           profile->scale >= s_scales[count - 1] && profile->scale <= s_scales[0] &&
+           (profile->frame_rate == 30 || profile->frame_rate == 60) &&
+           profile->quality >= 0 && profile->quality < QUALITY_TIER_COUNT &&
+           profile->workers >= 0 && profile->workers <= DEVICE_MAX_WORKERS;
+}
+
+bool device_profile_load(DeviceProfile* profile) {
+    char path[512];
+    device_profile_path(path, sizeof(path));
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    bool ok = fread(profile, sizeof(*profile), 1, file) == 1;
+    fclose(file);
+
+    if (!ok || profile->magic != DEVICE_PROFILE_MAGIC || profile->version != DEVICE_PROFILE_VERSION ||
+        profile->checksum != device_profile_checksum(profile) || !device_profile_in_range(profile)) {
+        LOG_WARN(LOG_CAT_SYSTEM, "Ignoring invalid device profile %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+// A torn write fails the checksum next time, which only means calibrating again
+bool device_profile_save(const DeviceProfile* profile) {
+    char path[512];
+    device_profile_path(path, sizeof(path));
+    DeviceProfile data = *profile;
+    data.checksum = device_profile_checksum(&data);
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        LOG_ERROR(LOG_CAT_SYSTEM, "Failed to save device profile %s\n", path);
+        return false;
+    }
+    bool ok = fwrite(&data, sizeof(data), 1, file) == 1;
+    if (fclose(file) != 0 || !ok) {
+        LOG_ERROR(LOG_CAT_SYSTEM, "Failed to save device profile %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+// Average frame of DEVICE_CALIBRATE_FILLS full-screen fills, presented
+static float device_measure_fill(Renderer* renderer) {
+    SDL_Rect screen = {0, 0, renderer->output_width, renderer->output_height};
+    Uint64 start = 0;
+
+    // The first frame is untimed: it pays for driver setup
+    for (int frame = -1; frame < DEVICE_CALIBRATE_FRAMES; frame++) {
+        if (frame == 0) {
+            start = SDL_GetPerformanceCounter();
+        }
+        render_set_color(renderer, 0, 0, 0, 255);
+        render_clear(renderer);
+        for (int i = 0; i < DEVICE_CALIBRATE_FILLS; i++) {
+            Uint8 shade = (Uint8)(8 + i * 2);
+            render_set_color(renderer, shade, shade, shade + 8, 255);
+            render_fill_rect(renderer, &screen);
+        }
+        render_present(renderer);
+    }
+
+    // Presents can return before the GPU is done: reading a pixel waits for it
+    Uint32 pixel;
+    SDL_Rect one = {0, 0, 1, 1};
+    SDL_RenderReadPixels(renderer->sdl, &one, SDL_PIXELFORMAT_ARGB8888, &pixel, sizeof(pixel));
+    return (float)(device_ms(SDL_GetPerformanceCounter() - start) / DEVICE_CALIBRATE_FRAMES);
+}
+
+// Rasterizing a changed HUD line, which is what text costs during play
+static float device_measure_text(TTF_Font* font) {
+    if (!font) {
+        return 0.0f;
+    }
+    SDL_Color white = {255, 255, 255, 255};
+    char text[64];
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < DEVICE_CALIBRATE_TEXTS; i++) {
+        snprintf(text, sizeof(text), "Score: %d  Lives: %d  Stage: %d", 1230 + i * 70, 3, 1);
+        SDL_Surface* surface = TTF_RenderText_Blended(font, text, white);
+        SDL_FreeSurface(surface);
+    }
+    return (float)(device_ms(SDL_GetPerformanceCounter() - start) / DEVICE_CALIBRATE_TEXTS);
+}
+
+// Ball physics against every brick of the first stage, as a gameplay tick does
+static float device_measure_ticks(void) {
+    Ball ball;
+    ball_init(&ball, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+    ball_launch(&ball, (float)(-M_PI / 3.0));
+    stage_init(&s_stage, 1);
+    phys_t floor = PHYS_FROM_INT(SCREEN_HEIGHT);
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int tick = 0; tick < DEVICE_CALIBRATE_TICKS; tick++) {
+        ball_update(&ball, 1.0f / 60.0f);
+        collision_ball_walls(&ball, SCREEN_WIDTH, SCREEN_HEIGHT);
+        for (int i = 0; i < MAX_BRICKS; i++) {
+            if (s_stage.bricks[i].active && collision_ball_brick(&ball, &s_stage.bricks[i])) {
+                collision_reflect_vertical(&ball);
+            }
+        }
+        if (ball.y - ball.radius > floor) {
+            ball_reset(&ball, SCREEN_WIDTH / 2);
+            ball_launch(&ball, (float)(-M_PI / 3.0));
+        }
+    }
+    return (float)(device_ms(SDL_GetPerformanceCounter() - start) * 1000.0 / DEVICE_CALIBRATE_TICKS);
+}
+
+static void device_profile_choose(DeviceProfile* profile, RenderBackendType backend) {
+    profile->backend = backend;
+
+    // Largest resolution whose fill cost (about the pixel count) fits
+    int count = (int)(sizeof(s_scales) / sizeof(s_scales[0]));
+    float scale = s_scales[count - 1];
+    for (int i = 0; i < count; i++) {
+        if (profile->fill_ms * s_scales[i] * s_scales[i] <= DEVICE_BUDGET_MS * DEVICE_FILL_SHARE) {
+            scale = s_scales[i];
+            break;
+        }
+    }
+    profile->scale = scale;
+    float frame_ms = profile->fill_ms * scale * scale;
+
+    // Too slow even at the lowest resolution, or ticks too expensive to run
+    // another frame's worth of drawing next to them: draw every other tick
+    bool slow = frame_ms > DEVICE_BUDGET_MS * DEVICE_FILL_SHARE ||
+                profile->tick_us / 1000.0f > DEVICE_BUDGET_MS * DEVICE_TICK_SHARE;
+    profile->frame_rate = slow ? 30 : 60;
+    profile->vsync = !slow && frame_ms <= DEVICE_BUDGET_MS * DEVICE_VSYNC_SHARE;
+
+    // Same order as at runtime: optional work goes before pixels
+    if (scale < 1.0f || slow || profile->text_ms > DEVICE_TEXT_LOW_MS) {
+        profile->quality = QUALITY_LOW;
+    } else if (profile->text_ms > DEVICE_TEXT_MEDIUM_MS) {
+        profile->quality = QUALITY_MEDIUM;
+    } else {
+        profile->quality = QUALITY_HIGH;
+    }
+
+    int workers = SDL_GetCPUCount() - 1;
+    profile->workers = workers < 0 ? 0 : workers > DEVICE_MAX_WORKERS ? DEVICE_MAX_WORKERS : workers;
+}
+
+bool device_profile_calibrate(Renderer* renderer, SDL_Window* window, TTF_Font* font,
+                              DeviceProfile* profile) {
+    printf("Measuring this device (first launch)...\n");
+    memset(profile, 0, sizeof(*profile));
+    profile->magic = DEVICE_PROFILE_MAGIC;
+    profile->version = DEVICE_PROFILE_VERSION;
+    profile->text_ms = device_measure_text(font);
+    profile->tick_us = device_measure_ticks();
+
+    RenderBackendType backend = renderer->type;
+    profile->fill_ms = device_measure_fill(renderer);
+
+    // Some handhelds' GL drivers are slower than filling the window surface
+    if (backend == RENDER_BACKEND_GPU && profile->fill_ms > DEVICE_BUDGET_MS * DEVICE_FILL_SHARE) {
+        render_destroy(renderer);
+        if (render_create(renderer, RENDER_BACKEND_SOFTWARE, window)) {
+            float software_ms = device_measure_fill(renderer);
+            printf("  fill: gpu %.2f ms, software %.2f ms\n", profile->fill_ms, software_ms);
+            if (software_ms < profile->fill_ms) {
+                backend = RENDER_BACKEND_SOFTWARE;
+                profile->fill_ms = software_ms;
+            } else {
+                render_destroy(renderer);
+            }
+        }
+        if (backend == RENDER_BACKEND_GPU && !render_create(renderer, RENDER_BACKEND_GPU, window)) {
+            return false;
+        }
+    }
+
+    device_profile_choose(profile, backend);
+    return true;
+}
+
+void device_profile_print(const DeviceProfile* profile, const char* source) {
+    printf("Device profile (%s): %s renderer, vsync %s, %.0f%% resolution, %d FPS, %s quality, %d workers\n",
+           source, render_backend_name((RenderBackendType)profile->backend), profile->vsync ? "on" : "off",
+           profile->scale * 100.0f, profile->frame_rate,
+           frame_budget_tier_name((QualityTier)profile->quality), profile->workers);
+    if (profile->fill_ms > 0.0f) {
+        printf("  measured: %.2f ms per %d fills, %.2f ms per HUD line, %.1f us per tick\n",
+               profile->fill_ms, DEVICE_CALIBRATE_FILLS, profile->text_ms, profile->tick_us);
+    }
+}
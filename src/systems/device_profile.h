@@ -0,0 +1,69 @@
+#ifndef DEVICE_PROFILE_H
+#define DEVICE_PROFILE_H
+
+#include <stdbool.h>
+#include "render.h"
+#include "frame_budget.h"
+
+#if defined(__EMSCRIPTEN__) || defined(_WIN32)
+#include <SDL_ttf.h>
+#else
+#include <SDL2/SDL_ttf.h>
+#endif
+
+// Device profile
+//
+// The same binary runs on the Vita, ARM handhelds, desktops and browsers.
+// On first launch a short calibration measures fill rate (full-screen fills
+// presented on the real renderer), text rasterization and simulation ticks,
+// picks settings that fit this device and saves them next to the progress
+// file; later launches just load them. Explicit command-line options still
+// win over the profile, and --profile/--recalibrate override it as a whole.
+//
+// The simulation always runs 60 ticks per second; a profile's frame rate
+// only sets how often a frame is drawn and presented.
+
+#define DEVICE_PROFILE_MAGIC 0x4650524Bu    // "KRPF"
+#define DEVICE_PROFILE_VERSION 1
+#define DEVICE_PROFILE_FILE "device_profile.bin"
+
+#define DEVICE_CALIBRATE_FRAMES 30          // Presented frames per fill measurement
+#define DEVICE_CALIBRATE_FILLS 8            // Full-screen fills per frame (game overdraw and then some)
+#define DEVICE_CALIBRATE_TEXTS 20           // HUD strings rasterized
+#define DEVICE_CALIBRATE_TICKS 3000         // Simulation ticks against a full stage
+#define DEVICE_MAX_WORKERS 2                // Optional workers: stage prep, startup jobs
+
+typedef struct {
+    Uint32 magic;
+    Uint16 version;
+    Uint16 reserved;
+    Sint32 backend;             // RenderBackendType: gpu or software
+    Sint32 vsync;
+    float scale;                // Starting internal resolution
+    Sint32 frame_rate;          // Frames drawn per second: 60 or 30
+    Sint32 quality;             // QualityTier to start at
+    Sint32 workers;             // 0: stages and startup jobs run on the main thread
+    float fill_ms;              // Calibration: one frame of DEVICE_CALIBRATE_FILLS fills
+    float text_ms;              // Calibration: one HUD string (0: no font)
+    float tick_us;              // Calibration: one simulation tick
+    Uint32 checksum;            // FNV-1a of the fields above
+} DeviceProfile;
+
+// Built-in profiles for --profile=<name>; false for an unknown name
+bool device_profile_preset(const char* name, DeviceProfile* profile);
+
+// Saved profile (DEVICE_PROFILE_FILE in the pref path); false on first launch
+// or when the file is damaged or holds settings out of range (calibrate again)
+bool device_profile_load(DeviceProfile* profile);
+bool device_profile_save(const DeviceProfile* profile);
+
+// First launch: measure this device (presenting DEVICE_CALIBRATE_FRAMES
+// frames per backend tried) and pick its settings. When the GPU renderer
+// is slow the software renderer is measured too; renderer is left on the
+// chosen backend. False if no renderer could be recreated.
+bool device_profile_calibrate(Renderer* renderer, SDL_Window* window, TTF_Font* font,
+                              DeviceProfile* profile);
+
+void device_profile_print(const DeviceProfile* profile, const char* source);
+
+#endif // DEVICE_PROFILE_H
@@ -0,0 +1,138 @@
+#include "frame_budget.h"
+#include "damage.h"
+#include "log.h"
+#include "metrics.h"
+#include <string.h>
+
+static const QualitySettings s_tiers[QUALITY_TIER_COUNT] = {
+    [QUALITY_HIGH]   = {1, DAMAGE_MAX_RECTS},
+    [QUALITY_MEDIUM] = {4, 8},
+    [QUALITY_LOW]    = {15, 4},     // HUD at 4 Hz, few large rects (one clip pass each)
+};
+
+static const char* tier_names[QUALITY_TIER_COUNT] = {"high", "medium", "low"};
+
+static const Renderer* s_renderer = NULL;
+static bool s_enabled = false;
+static double s_budget_ms = 1000.0 / 60.0;
+static double s_ring[FRAME_BUDGET_WINDOW][FRAME_PHASE_COUNT];
+static double s_sums[FRAME_PHASE_COUNT];
+static int s_next = 0;
+static int s_filled = 0;            // Frames in the ring since the last tier change
+static int s_calm_frames = 0;
+static FrameBudgetStats s_stats;
+
+static void frame_budget_clear_window(void) {
+    memset(s_ring, 0, sizeof(s_ring));
+    memset(s_sums, 0, sizeof(s_sums));
+    s_next = 0;
+    s_filled = 0;
+    s_calm_frames = 0;
+}
+
+static void frame_budget_set_tier(QualityTier tier, double cost_ms) {
+    LOG_INFO(LOG_CAT_RENDER, "Quality tier %s -> %s (%.2f ms per frame: update %.2f, render %.2f, present %.2f)\n",
+             tier_names[s_stats.tier], tier_names[tier], cost_ms,
+             s_stats.phase_ms[FRAME_PHASE_UPDATE], s_stats.phase_ms[FRAME_PHASE_RENDER],
+             s_stats.phase_ms[FRAME_PHASE_PRESENT]);
+
+    if (tier > s_stats.tier) {
+        s_stats.degraded++;
+    } else {
+        s_stats.restored++;
+    }
+    s_stats.tier = tier;
+    if (tier > s_stats.lowest_tier) {
+        s_stats.lowest_tier = tier;
+    }
+    METRICS_GAUGE("quality.tier", tier);
+
+    // The window measured the old tier; judge the new one on its own frames
+    frame_budget_clear_window();
+}
+
+void frame_budget_init(const Renderer* renderer, bool enabled, QualityTier tier, int frame_rate) {
+    s_renderer = renderer;
+    s_enabled = enabled;
+    s_budget_ms = 1000.0 / frame_rate;
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stats.tier = enabled ? tier : QUALITY_HIGH;
+    s_stats.lowest_tier = s_stats.tier;
+    METRICS_GAUGE("quality.tier", s_stats.tier);
+    frame_budget_clear_window();
+}
+
+void frame_budget_shutdown(void) {
+    if (s_stats.degraded > 0) {
+        LOG_INFO(LOG_CAT_RENDER, "Quality tiers: degraded %d times, restored %d, lowest %s, ended at %s\n",
+                 s_stats.degraded, s_stats.restored, tier_names[s_stats.lowest_tier],
+                 tier_names[s_stats.tier]);
+    }
+    s_enabled = false;
+}
+
+void frame_budget_frame(double update_ms, double render_ms) {
+    if (!s_enabled) {
+        return;
+    }
+
+    // Capture readback runs inside render_ms but is no part of the game's cost
+    double ms_per_tick = 1000.0 / SDL_GetPerformanceFrequency();
+    double present_ms = s_renderer->present_ticks * ms_per_tick;
+    double capture_ms = s_renderer->capture_ticks * ms_per_tick;
+    double phases[FRAME_PHASE_COUNT] = {update_ms, render_ms - present_ms - capture_ms, present_ms};
+    for (int i = 0; i < FRAME_PHASE_COUNT; i++) {
+        s_sums[i] += phases[i] - s_ring[s_next][i];
+        s_ring[s_next][i] = phases[i];
+    }
+    s_next = (s_next + 1) % FRAME_BUDGET_WINDOW;
+    if (s_filled < FRAME_BUDGET_WINDOW) {
+        s_filled++;
+    }
+
+    for (int i = 0; i < FRAME_PHASE_COUNT; i++) {
+        s_stats.phase_ms[i] = s_sums[i] / s_filled;
+    }
+    if (s_filled < FRAME_BUDGET_WINDOW) {
+        return;
+    }
+
+    // GPU presents may block on vsync: only count the CPU work before it
+    double cost = s_stats.phase_ms[FRAME_PHASE_UPDATE] + s_stats.phase_ms[FRAME_PHASE_RENDER];
+    if (s_renderer->type != RENDER_BACKEND_GPU) {
+        cost += s_stats.phase_ms[FRAME_PHASE_PRESENT];
+    }
+
+    if (cost > s_budget_ms * FRAME_BUDGET_HIGH) {
+        s_calm_frames = 0;
+        if (s_stats.tier < QUALITY_LOW) {
+            frame_budget_set_tier(s_stats.tier + 1, cost);
+        }
+    } else if (s_stats.tier > QUALITY_HIGH && cost < s_budget_ms * FRAME_BUDGET_LOW) {
+        if (++s_calm_frames >= FRAME_BUDGET_RESTORE_FRAMES) {
+            frame_budget_set_tier(s_stats.tier - 1, cost);
+        }
+    } else {
+        s_calm_frames = 0;
+    }
+}
+
+QualityTier frame_budget_tier(void) {
+    return s_stats.tier;
+}
+
+const QualitySettings* frame_budget_settings(void) {
+    return &s_tiers[s_stats.tier];
+}
+
+bool frame_budget_exhausted(void) {
+    return !s_enabled || s_stats.tier == QUALITY_LOW;
+}
+
+FrameBudgetStats frame_budget_get_stats(void) {
+    return s_stats;
+}
+
+const char* frame_budget_tier_name(QualityTier tier) {
+    return tier >= 0 && tier < QUALITY_TIER_COUNT ? tier_names[tier] : "?";
+}
@@ -0,0 +1,67 @@
+#ifndef FRAME_BUDGET_H
+#define FRAME_BUDGET_H
+
+#include <stdbool.h>
+#include "render.h"
+
+// Frame budget and quality tiers
+//
+// Keeps a rolling average of what each phase of the frame (update, render,
+// present) costs and picks a quality tier for optional work from it: one
+// tier down as soon as the frame uses most of its budget, one tier back up
+// only after a few seconds with plenty of room. Each tier is a settings
+// table (HUD refresh interval, dirty-rect strategy) that the renderer reads
+// every frame. The resolution governor only starts lowering the resolution
+// once the lowest tier is reached.
+
+typedef enum {
+    QUALITY_HIGH = 0,
+    QUALITY_MEDIUM,
+    QUALITY_LOW,
+    QUALITY_TIER_COUNT
+} QualityTier;
+
+typedef enum {
+    FRAME_PHASE_UPDATE = 0,
+    FRAME_PHASE_RENDER,         // Building the frame, not counting the present
+    FRAME_PHASE_PRESENT,
+    FRAME_PHASE_COUNT
+} FramePhase;
+
+typedef struct {
+    int hud_interval;           // Frames between HUD text refreshes
+    int damage_max_rects;       // Dirty rects kept apart before merging (--dirty-rects)
+} QualitySettings;
+
+#define FRAME_BUDGET_WINDOW 30              // Frames in the rolling average
+#define FRAME_BUDGET_HIGH 0.85              // Degrade above this share of the budget
+#define FRAME_BUDGET_LOW 0.60               // Restore below this share...
+#define FRAME_BUDGET_RESTORE_FRAMES 180     // ...held for this many frames (3s)
+
+typedef struct {
+    QualityTier tier;
+    QualityTier lowest_tier;
+    int degraded;
+    int restored;
+    double phase_ms[FRAME_PHASE_COUNT];     // Current rolling averages
+} FrameBudgetStats;
+
+// Budget is one frame at frame_rate; tiers start at tier (the device
+// profile's) and stay QUALITY_HIGH when disabled
+void frame_budget_init(const Renderer* renderer, bool enabled, QualityTier tier, int frame_rate);
+void frame_budget_shutdown(void);
+
+// Feed the frame's update time and render time (present included; the
+// renderer's own present timing is split out)
+void frame_budget_frame(double update_ms, double render_ms);
+
+QualityTier frame_budget_tier(void);
+const QualitySettings* frame_budget_settings(void);
+
+// True when there is no optional work left to shed (or tiers are off)
+bool frame_budget_exhausted(void);
+
+FrameBudgetStats frame_budget_get_stats(void);
+const char* frame_budget_tier_name(QualityTier tier);
+
+#endif // FRAME_BUDGET_H
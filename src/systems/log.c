@@ -0,0 +1,374 @@
+#include "log.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LOG_RING_MASK (LOG_RING_SIZE - 1)
+#define LOG_LINE_BYTES 256
+
+typedef enum {
+    LOG_ARG_NONE = 0,
+    LOG_ARG_INT,
+    LOG_ARG_UINT,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_STRING,
+    LOG_ARG_POINTER,
+    LOG_ARG_PERCENT
+} LogArgKind;
+
+typedef union {
+    long long i;
+    unsigned long long u;
+    double d;
+    const void* p;
+} LogArg;
+
+// Fixed-size record: everything the writer needs to format the message later
+typedef struct {
+    Uint64 ticks;
+    const char* fmt;
+    Uint8 level;
+    Uint8 category;
+    Uint8 text_used;
+    LogArg args[LOG_MAX_ARGS];
+    char text[LOG_TEXT_BYTES];
+} LogRecord;
+
+// Slot sequence: == position when free for that position's writer,
+// == position + 1 once published for the reader
+typedef struct {
+    SDL_atomic_t sequence;
+    LogRecord record;
+} LogSlot;
+
+static LogSlot s_ring[LOG_RING_SIZE];
+static SDL_atomic_t s_tail;         // Next position to claim (producers)
+static Uint32 s_head = 0;           // Next position to read (writer thread only)
+static SDL_atomic_t s_dropped;
+static int s_reported_dropped = 0;
+static SDL_atomic_t s_quit;
+static SDL_Thread* s_thread = NULL;
+
+static int s_min_level = LOG_LEVEL_INFO;
+static Uint32 s_category_mask = (1u << LOG_CAT_COUNT) - 1;
+static Uint64 s_start_ticks = 0;
+
+static const char* level_names[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+static const char* category_names[LOG_CAT_COUNT] = {"game", "render", "save", "system"};
+
+// Parse the conversion at fmt (which points at '%'). Returns its length;
+// *length_mod is 0, 'h', 'l', 'L' (ll) or 'z'.
+static int log_parse_spec(const char* fmt, LogArgKind* kind, char* length_mod) {
+    const char* p = fmt + 1;
+    *length_mod = 0;
+
+    while (*p && strchr("-+ #0", *p)) p++;
+    while (*p >= '0' && *p <= '9') p++;
+    if (*p == '.') {
+        p++;
+        while (*p >= '0' && *p <= '9') p++;
+    }
+
+    if (*p == 'h') {
+        *length_mod = 'h';
+        p++;
+        if (*p == 'h') p++;
+    } else if (*p == 'l') {
+        *length_mod = 'l';
+        p++;
+        if (*p == 'l') {
+            *length_mod = 'L';
+            p++;
+        }
+    } else if (*p == 'z') {
+        *length_mod = 'z';
+        p++;
+    }
+
+    switch (*p) {
+        case 'd': case 'i': case 'c':
+            *kind = LOG_ARG_INT;
+            break;
+        case 'u': case 'x': case 'X': case 'o':
+            *kind = LOG_ARG_UINT;
+            break;
+        case 'f': case 'e': case 'g': case 'E': case 'G':
+            *kind = LOG_ARG_DOUBLE;
+            break;
+        case 's':
+            *kind = LOG_ARG_STRING;
+            break;
+        case 'p':
+            *kind = LOG_ARG_POINTER;
+            break;
+        case '%':
+            *kind = LOG_ARG_PERCENT;
+            break;
+        default:
+            *kind = LOG_ARG_NONE;   // Unsupported: printed literally
+            return *p ? (int)(p - fmt) + 1 : (int)(p - fmt);
+    }
+    return (int)(p - fmt) + 1;
+}
+
+// Pull the arguments named by fmt off the va_list into the record
+static void log_capture(LogRecord* record, LogLevel level, LogCategory category,
+                        const char* fmt, va_list ap) {
+    record->ticks = SDL_GetPerformanceCounter();
+    record->fmt = fmt;
+    record->level = (Uint8)level;
+    record->category = (Uint8)category;
+    record->text_used = 0;
+
+    int argc = 0;
+    for (const char* p = fmt; *p && argc < LOG_MAX_ARGS; p++) {
+        if (*p != '%') {
+            continue;
+        }
+
+        LogArgKind kind;
+        char mod;
+        int length = log_parse_spec(p, &kind, &mod);
+        p += length - 1;
+
+        LogArg* arg = &record->args[argc];
+        switch (kind) {
+            case LOG_ARG_INT:
+                if (mod == 'l') arg->i = va_arg(ap, long);
+                else if (mod == 'L') arg->i = va_arg(ap, long long);
+                else if (mod == 'z') arg->i = (long long)va_arg(ap, size_t);
+                else arg->i = va_arg(ap, int);
+                argc++;
+                break;
+            case LOG_ARG_UINT:
+                if (mod == 'l') arg->u = va_arg(ap, unsigned long);
+                else if (mod == 'L') arg->u = va_arg(ap, unsigned long long);
+                else if (mod == 'z') arg->u = va_arg(ap, size_t);
+                else arg->u = va_arg(ap, unsigned int);
+                argc++;
+                break;
+            case LOG_ARG_DOUBLE:
+                arg->d = va_arg(ap, double);
+                argc++;
+                break;
+            case LOG_ARG_STRING: {
+                // Copy: the caller's buffer may be gone by the time we format
+                const char* s = va_arg(ap, const char*);
+                int room = LOG_TEXT_BYTES - record->text_used;
+                arg->i = record->text_used;
+                if (room > 0) {
+                    int n = (int)strlen(s ? s : "(null)");
+                    if (n > room - 1) n = room - 1;
+                    memcpy(&record->text[record->text_used], s ? s : "(null)", n);
+                    record->text[record->text_used + n] = '\0';
+                    record->text_used += n + 1;
+                } else {
+                    arg->i = -1;
+                }
+                argc++;
+                break;
+            }
+            case LOG_ARG_POINTER:
+                arg->p = va_arg(ap, const void*);
+                argc++;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+// Format a record into one output line
+static void log_emit(const LogRecord* record) {
+    char line[LOG_LINE_BYTES];
+    int used = snprintf(line, sizeof(line), "[%9.3f] %-5s %-6s ",
+                        (record->ticks - s_start_ticks) / (double)SDL_GetPerformanceFrequency(),
+                        level_names[record->level], category_names[record->category]);
+
+    int argc = 0;
+    for (const char* p = record->fmt; *p && used < (int)sizeof(line) - 1; ) {
+        if (*p != '%') {
+            line[used++] = *p++;
+            continue;
+        }
+
+        LogArgKind kind;
+        char mod;
+        int length = log_parse_spec(p, &kind, &mod);
+
+        // Rebuild the spec with a fixed length modifier matching the stored type
+        char spec[32];
+        int spec_len = 0;
+        for (int i = 0; i < length - 1 && spec_len < (int)sizeof(spec) - 4; i++) {
+            if (!strchr("hlz", p[i])) spec[spec_len++] = p[i];
+        }
+        char conversion = p[length - 1];
+        bool is_char = conversion == 'c';
+        if ((kind == LOG_ARG_INT || kind == LOG_ARG_UINT) && !is_char) {
+            spec[spec_len++] = 'l';
+            spec[spec_len++] = 'l';
+        }
+        spec[spec_len++] = conversion;
+        spec[spec_len] = '\0';
+
+        int room = (int)sizeof(line) - 1 - used;
+        const LogArg* arg = argc < LOG_MAX_ARGS ? &record->args[argc] : NULL;
+        int n = 0;
+        if (kind == LOG_ARG_PERCENT) {
+            line[used] = '%';
+            n = 1;
+        } else if (kind == LOG_ARG_NONE || !arg) {
+            n = length < room ? length : room;
+            memcpy(&line[used], p, n);
+        } else {
+            switch (kind) {
+                case LOG_ARG_INT:
+                    // %c takes a plain int; the other conversions were rebuilt with ll
+                    n = is_char ? snprintf(&line[used], room + 1, spec, (int)arg->i)
+                                : snprintf(&line[used], room + 1, spec, arg->i);
+                    break;
+                case LOG_ARG_UINT: n = snprintf(&line[used], room + 1, spec, arg->u); break;
+                case LOG_ARG_DOUBLE: n = snprintf(&line[used], room + 1, spec, arg->d); break;
+                case LOG_ARG_STRING:
+                    n = snprintf(&line[used], room + 1, spec, arg->i >= 0 ? &record->text[arg->i] : "...");
+                    break;
+                case LOG_ARG_POINTER: n = snprintf(&line[used], room + 1, spec, arg->p); break;
+                default: break;
+            }
+            argc++;
+        }
+        used += n < room ? n : room;
+        p += length;
+    }
+
+    // Keep the message on one line; stored format strings end with '\n'
+    while (used > 0 && line[used - 1] == '\n') used--;
+    line[used++] = '\n';
+    fwrite(line, 1, used, stdout);
+}
+
+static int log_drain(void) {
+    int count = 0;
+    while (true) {
+        LogSlot* slot = &s_ring[s_head & LOG_RING_MASK];
+        if ((Uint32)SDL_AtomicGet(&slot->sequence) != s_head + 1) {
+            break;
+        }
+        log_emit(&slot->record);
+        SDL_AtomicSet(&slot->sequence, (int)(s_head + LOG_RING_SIZE));
+        s_head++;
+        count++;
+    }
+
+    int dropped = SDL_AtomicGet(&s_dropped);
+    if (dropped != s_reported_dropped) {
+        printf("[log] %d records dropped (ring full)\n", dropped - s_reported_dropped);
+        s_reported_dropped = dropped;
+        count++;
+    }
+    return count;
+}
+
+static int log_thread(void* unused) {
+    while (true) {
+        bool quitting = SDL_AtomicGet(&s_quit) != 0;
+        if (log_drain() > 0) {
+            fflush(stdout);
+        } else if (quitting) {
+            break;
+        } else {
+            SDL_Delay(LOG_IDLE_MS);
+        }
+    }
+    return 0;
+}
+
+bool log_init(void) {
+    s_start_ticks = SDL_GetPerformanceCounter();
+    for (int i = 0; i < LOG_RING_SIZE; i++) {
+        SDL_AtomicSet(&s_ring[i].sequence, i);
+    }
+    SDL_AtomicSet(&s_tail, 0);
+    SDL_AtomicSet(&s_dropped, 0);
+    SDL_AtomicSet(&s_quit, 0);
+    s_head = 0;
+    s_reported_dropped = 0;
+
+    s_thread = SDL_CreateThread(log_thread, "log", NULL);
+    if (!s_thread) {
+        printf("Log writer thread unavailable, logging synchronously\n");
+        return false;
+    }
+    return true;
+}
+
+void log_shutdown(void) {
+    if (!s_thread) {
+        return;
+    }
+    SDL_AtomicSet(&s_quit, 1);
+    SDL_WaitThread(s_thread, NULL);
+    s_thread = NULL;
+    fflush(stdout);
+}
+
+void log_set_level(LogLevel level) {
+    s_min_level = level;
+}
+
+void log_set_category_enabled(LogCategory category, bool enabled) {
+    if (enabled) {
+        s_category_mask |= 1u << category;
+    } else {
+        s_category_mask &= ~(1u << category);
+    }
+}
+
+void log_write(LogLevel level, LogCategory category, const char* fmt, ...) {
+    if ((int)level < s_min_level || !(s_category_mask & (1u << category))) {
+        return;
+    }
+
+    va_list ap;
+    va_start(ap, fmt);
+
+    if (!s_thread) {
+        if (s_start_ticks == 0) {
+            s_start_ticks = SDL_GetPerformanceCounter();
+        }
+        LogRecord record;
+        log_capture(&record, level, category, fmt, ap);
+        va_end(ap);
+        log_emit(&record);
+        return;
+    }
+
+    // Claim a slot (bounded MPMC queue: producers race on s_tail with CAS)
+    Uint32 pos = (Uint32)SDL_AtomicGet(&s_tail);
+    LogSlot* slot;
+    while (true) {
+        slot = &s_ring[pos & LOG_RING_MASK];
+        Sint32 diff = (Sint32)((Uint32)SDL_AtomicGet(&slot->sequence) - pos);
+        if (diff == 0) {
+            if (SDL_AtomicCAS(&s_tail, (int)pos, (int)(pos + 1))) {
+                break;
+            }
+            pos = (Uint32)SDL_AtomicGet(&s_tail);
+        } else if (diff < 0) {
+            // Full: drop rather than wait for the writer
+            SDL_AtomicAdd(&s_dropped, 1);
+            va_end(ap);
+            return;
+        } else {
+            pos = (Uint32)SDL_AtomicGet(&s_tail);
+        }
+    }
+
+    log_capture(&slot->record, level, category, fmt, ap);
+    va_end(ap);
+    SDL_AtomicSet(&slot->sequence, (int)(pos + 1));
+}
+
+int log_get_dropped(void) {
+    return SDL_AtomicGet(&s_dropped);
+}
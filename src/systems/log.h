@@ -0,0 +1,61 @@
+#ifndef LOG_H
+#define LOG_H
+
+#if defined(__EMSCRIPTEN__) || defined(_WIN32)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+#include <stdbool.h>
+
+// Asynchronous logger
+//
+// log_write() captures the format string pointer and its arguments into a
+// fixed-size record in a lock-free ring and returns; a background thread
+// formats records and writes them to stdout. When the ring is full the
+// record is dropped (and counted) rather than blocking the caller.
+//
+// Format strings must be literals (only the pointer is stored). Supported
+// conversions: d i u x X o c with h/l/ll/z, f e g, s (copied, truncated to
+// LOG_TEXT_BYTES in total), p and %%. At most LOG_MAX_ARGS arguments.
+//
+// Before log_init() and after log_shutdown(), records are written
+// synchronously.
+
+#define LOG_RING_SIZE 1024          // Records; power of two
+#define LOG_MAX_ARGS 6
+#define LOG_TEXT_BYTES 64           // Inline storage for %s arguments
+#define LOG_IDLE_MS 10              // Writer sleep when the ring is empty
+
+typedef enum {
+    LOG_LEVEL_DEBUG = 0,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_ERROR
+} LogLevel;
+
+typedef enum {
+    LOG_CAT_GAME = 0,       // Gameplay events
+    LOG_CAT_RENDER,         // Rendering and frame stats
+    LOG_CAT_SAVE,           // Snapshots and persistence
+    LOG_CAT_SYSTEM,         // Everything else
+    LOG_CAT_COUNT
+} LogCategory;
+
+bool log_init(void);
+void log_shutdown(void);    // Drain the ring and stop the writer
+
+// Filtering happens before anything is captured
+void log_set_level(LogLevel level);
+void log_set_category_enabled(LogCategory category, bool enabled);
+
+void log_write(LogLevel level, LogCategory category, const char* fmt, ...);
+
+int log_get_dropped(void);
+
+#define LOG_DEBUG(cat, ...) log_write(LOG_LEVEL_DEBUG, cat, __VA_ARGS__)
+#define LOG_INFO(cat, ...) log_write(LOG_LEVEL_INFO, cat, __VA_ARGS__)
+#define LOG_WARN(cat, ...) log_write(LOG_LEVEL_WARN, cat, __VA_ARGS__)
+#define LOG_ERROR(cat, ...) log_write(LOG_LEVEL_ERROR, cat, __VA_ARGS__)
+
+#endif // LOG_H
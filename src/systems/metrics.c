@@ -0,0 +1,192 @@
+#include "metrics.h"
+#include "log.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    char name[METRICS_NAME_MAX];
+    MetricType type;
+    Uint64 count;               // Counter total / histogram samples this interval
+    Uint64 last_count;          // Counter total at the previous dump
+    double value;               // Gauge value / histogram sum
+    double min;                 // Histogram range
+    double max;
+    double scale;               // Buckets per unit
+    double low;                 // Smallest and largest sample this interval
+    double high;
+    Uint32 buckets[METRICS_BUCKETS];
+} Metric;
+
+static Metric s_metrics[METRICS_MAX];
+static int s_count = 0;
+static FILE* s_file = NULL;
+static Uint32 s_next_dump = 0;
+static Uint32 s_last_dump = 0;
+static int s_frames = 0;
+
+static MetricId metrics_register(const char* name, MetricType type) {
+    for (int i = 0; i < s_count; i++) {
+        if (strcmp(s_metrics[i].name, name) == 0) {
+            return s_metrics[i].type == type ? i : METRIC_NONE;
+        }
+    }
+    if (s_count == METRICS_MAX) {
+        LOG_WARN(LOG_CAT_SYSTEM, "Metrics registry full, ignoring %s\n", name);
+        return METRIC_NONE;
+    }
+
+    Metric* metric = &s_metrics[s_count];
+    memset(metric, 0, sizeof(*metric));
+    snprintf(metric->name, sizeof(metric->name), "%s", name);
+    metric->type = type;
+    return s_count++;
+}
+
+MetricId metrics_counter(const char* name) {
+    return metrics_register(name, METRIC_COUNTER);
+}
+
+MetricId metrics_gauge(const char* name) {
+    return metrics_register(name, METRIC_GAUGE);
+}
+
+MetricId metrics_histogram(const char* name, double min, double max) {
+    MetricId id = metrics_register(name, METRIC_HISTOGRAM);
+    if (id >= 0 && s_metrics[id].scale == 0.0) {
+        s_metrics[id].min = min;
+        s_metrics[id].max = max;
+        s_metrics[id].scale = METRICS_BUCKETS / (max - min);
+    }
+    return id;
+}
+
+void metrics_add(MetricId id, Uint64 amount) {
+    if (id >= 0) {
+        s_metrics[id].count += amount;
+    }
+}
+
+void metrics_set(MetricId id, double value) {
+    if (id >= 0) {
+        s_metrics[id].value = value;
+    }
+}
+
+void metrics_sample(MetricId id, double value) {
+    if (id < 0) {
+        return;
+    }
+    Metric* metric = &s_metrics[id];
+    if (metric->count == 0 || value < metric->low) metric->low = value;
+    if (metric->count == 0 || value > metric->high) metric->high = value;
+    metric->count++;
+    metric->value += value;
+
+    // Out-of-range samples land in the end buckets
+    int bucket = (int)((value - metric->min) * metric->scale);
+    if (bucket < 0) bucket = 0;
+    if (bucket >= METRICS_BUCKETS) bucket = METRICS_BUCKETS - 1;
+    metric->buckets[bucket]++;
+}
+
+Uint64 metrics_get_count(MetricId id) {
+    return id >= 0 ? s_metrics[id].count : 0;
+}
+
+// Upper edge of the bucket holding the given fraction of samples, clamped to
+// the largest sample seen
+static double metrics_percentile(const Metric* metric, double fraction) {
+    Uint64 target = (Uint64)(metric->count * fraction);
+    Uint64 seen = 0;
+    for (int i = 0; i < METRICS_BUCKETS; i++) {
+        seen += metric->buckets[i];
+        if (seen > target) {
+            double edge = metric->min + (i + 1) / metric->scale;
+            return edge < metric->high ? edge : metric->high;
+        }
+    }
+    return metric->high;
+}
+
+static void metrics_dump(Uint32 now_ms) {
+    fprintf(s_file, "{\"t_ms\":%u,\"interval_ms\":%u,\"frames\":%d", now_ms, now_ms - s_last_dump, s_frames);
+
+    for (int i = 0; i < s_count; i++) {
+        Metric* metric = &s_metrics[i];
+        switch (metric->type) {
+            case METRIC_COUNTER:
+                fprintf(s_file, ",\"%s\":{\"total\":%llu,\"delta\":%llu}", metric->name,
+                        (unsigned long long)metric->count,
+                        (unsigned long long)(metric->count - metric->last_count));
+                metric->last_count = metric->count;
+                break;
+            case METRIC_GAUGE:
+                fprintf(s_file, ",\"%s\":%.6g", metric->name, metric->value);
+                break;
+            case METRIC_HISTOGRAM:
+                if (metric->count == 0) {
+                    fprintf(s_file, ",\"%s\":{\"count\":0}", metric->name);
+                    break;
+                }
+                fprintf(s_file, ",\"%s\":{\"count\":%llu,\"mean\":%.4g,\"min\":%.4g,\"p50\":%.4g,"
+                        "\"p90\":%.4g,\"p99\":%.4g,\"max\":%.4g}", metric->name,
+                        (unsigned long long)metric->count, metric->value / metric->count, metric->low,
+                        metrics_percentile(metric, 0.5), metrics_percentile(metric, 0.9),
+                        metrics_percentile(metric, 0.99), metric->high);
+
+                // Histograms cover one interval
+                metric->count = 0;
+                metric->value = 0.0;
+                memset(metric->buckets, 0, sizeof(metric->buckets));
+                break;
+        }
+    }
+
+    fprintf(s_file, "}\n");
+    fflush(s_file);
+    s_last_dump = now_ms;
+    s_frames = 0;
+}
+
+bool metrics_init(const char* path) {
+    if (!path) {
+        path = METRICS_FILE;
+    }
+    s_file = fopen(path, "w");
+    if (!s_file) {
+        LOG_ERROR(LOG_CAT_SYSTEM, "Failed to open metrics file %s\n", path);
+        return false;
+    }
+
+    // Header line so dumps from different builds and devices can be told apart
+#ifdef PHYSICS_FIXED
+    const char* physics = "fixed";
+#else
+    const char* physics = "float";
+#endif
+    fprintf(s_file, "{\"platform\":\"%s\",\"physics\":\"%s\",\"cpus\":%d,\"ram_mb\":%d}\n",
+            SDL_GetPlatform(), physics, SDL_GetCPUCount(), SDL_GetSystemRAM());
+
+    s_last_dump = SDL_GetTicks();
+    s_next_dump = s_last_dump + METRICS_DUMP_MS;
+    s_frames = 0;
+    LOG_INFO(LOG_CAT_SYSTEM, "Writing metrics to %s\n", path);
+    return true;
+}
+
+void metrics_shutdown(void) {
+    if (!s_file) {
+        return;
+    }
+    metrics_dump(SDL_GetTicks());
+    fclose(s_file);
+    s_file = NULL;
+}
+
+void metrics_frame(Uint32 now_ms) {
+    s_frames++;
+    if (s_file && (Sint32)(now_ms - s_next_dump) >= 0) {
+        metrics_dump(now_ms);
+        s_next_dump = now_ms + METRICS_DUMP_MS;
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#if defined(__EMSCRIPTEN__) || defined(_WIN32)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+#include <stdbool.h>
+
+// Runtime metrics
+//
+// Counters, gauges and histograms registered by name. Registration looks the
+// name up once; updates index a fixed array, so they are cheap enough for
+// hot paths. The METRICS_* macros cache the id in a static at each call
+// site. When a dump file is open, metrics_frame() appends one JSON line per
+// interval with counter totals and deltas, gauge values and histogram
+// percentiles for that interval.
+
+#define METRICS_MAX 64
+#define METRICS_NAME_MAX 32
+#define METRICS_BUCKETS 64              // Linear histogram buckets between min and max
+#define METRICS_DUMP_MS 1000
+#define METRICS_FILE "metrics.jsonl"
+
+#define METRIC_NONE (-1)                // Registry full: updates are ignored
+#define METRIC_UNREGISTERED (-2)
+
+typedef int MetricId;
+
+typedef enum {
+    METRIC_COUNTER = 0,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM
+} MetricType;
+
+// Start dumping to path (NULL: METRICS_FILE). Metrics are collected either way.
+bool metrics_init(const char* path);
+void metrics_shutdown(void);            // Writes a final line and closes the file
+
+MetricId metrics_counter(const char* name);
+MetricId metrics_gauge(const char* name);
+MetricId metrics_histogram(const char* name, double min, double max);
+
+void metrics_add(MetricId id, Uint64 amount);
+void metrics_set(MetricId id, double value);
+void metrics_sample(MetricId id, double value);
+
+Uint64 metrics_get_count(MetricId id);
+
+// Call once per frame; dumps when METRICS_DUMP_MS has passed
+void metrics_frame(Uint32 now_ms);
+
+#define METRICS_COUNT(name, amount) do { \
+        static MetricId metric_id_ = METRIC_UNREGISTERED; \
+        if (metric_id_ == METRIC_UNREGISTERED) metric_id_ = metrics_counter(name); \
+        metrics_add(metric_id_, (amount)); \
+    } while (0)
+
+#define METRICS_GAUGE(name, value) do { \
+        static MetricId metric_id_ = METRIC_UNREGISTERED; \
+        if (metric_id_ == METRIC_UNREGISTERED) metric_id_ = metrics_gauge(name); \
+        metrics_set(metric_id_, (value)); \
+    } while (0)
+
+#define METRICS_SAMPLE(name, min, max, value) do { \
+        static MetricId metric_id_ = METRIC_UNREGISTERED; \
+        if (metric_id_ == METRIC_UNREGISTERED) metric_id_ = metrics_histogram(name, min, max); \
+        metrics_sample(metric_id_, (value)); \
+    } while (0)
+
+#endif // METRICS_H
@@ -0,0 +1,266 @@
+#if !defined(_WIN32) && !defined(__vita__)
+#define _POSIX_C_SOURCE 200809L     // fsync, fileno
+#include <unistd.h>
+#define PERSIST_HAVE_FSYNC 1
+#endif
+
+#include "persist.h"
+#include "log.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+static SaveData s_data;             // Game thread's copy
+static SaveData s_pending_data;     // Handed to the writer (guarded by s_lock)
+static bool s_pending = false;
+static bool s_quit = false;
+static bool s_active = false;       // Between persist_init and persist_shutdown
+#define PERSIST_DIR_MAX 448
+static char s_path[PERSIST_DIR_MAX + 64];
+
+static SDL_Thread* s_thread = NULL;
+static SDL_mutex* s_lock = NULL;
+static SDL_cond* s_wake = NULL;
+
+// Stats (requests/coalesced/enqueue on the game thread, writes/failures under s_lock)
+static PersistStats s_stats;
+static Uint64 s_enqueue_ticks = 0;
+static Uint64 s_enqueue_max_ticks = 0;
+
+static Uint32 persist_checksum(const SaveData* data) {
+    const Uint8* bytes = (const Uint8*)data;
+    Uint32 hash = 2166136261u;
+    for (size_t i = 0; i < offsetof(SaveData, checksum); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void persist_defaults(SaveData* data) {
+    memset(data, 0, sizeof(*data));
+    data->magic = PERSIST_MAGIC;
+    data->version = PERSIST_VERSION;
+}
+
+static bool persist_load(const char* path, SaveData* data) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    bool ok = fread(data, sizeof(*data), 1, file) == 1;
+    fclose(file);
+
+    if (!ok || data->magic != PERSIST_MAGIC || data->version != PERSIST_VERSION ||
+        data->checksum != persist_checksum(data)) {
+        LOG_WARN(LOG_CAT_SAVE, "Ignoring invalid save %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+// Write to path.tmp, flush it to storage, then rename over the real file
+static bool persist_write(const SaveData* data) {
+    char tmp_path[sizeof(s_path) + 4];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", s_path);
+
+    FILE* file = fopen(tmp_path, "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = fwrite(data, sizeof(*data), 1, file) == 1 && fflush(file) == 0;
+#ifdef PERSIST_HAVE_FSYNC
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+    if (fclose(file) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        remove(tmp_path);
+        return false;
+    }
+
+#if defined(_WIN32) || defined(__vita__)
+    remove(s_path);  // rename() does not replace an existing file here
+#endif
+    return rename(tmp_path, s_path) == 0;
+}
+
+static int persist_thread(void* unused) {
+    SDL_LockMutex(s_lock);
+    while (true) {
+        while (!s_pending && !s_quit) {
+            SDL_CondWait(s_wake, s_lock);
+        }
+        if (!s_pending) {
+            break;  // Quitting with nothing left to write
+        }
+
+        // Let a burst of saves settle into one write. New requests signal us
+        // too, so keep waiting until the deadline (or shutdown).
+        Uint32 deadline = SDL_GetTicks() + PERSIST_COALESCE_MS;
+        while (!s_quit) {
+            Uint32 now = SDL_GetTicks();
+            if ((Sint32)(deadline - now) <= 0) {
+                break;
+            }
+            SDL_CondWaitTimeout(s_wake, s_lock, deadline - now);
+        }
+
+        SaveData data = s_pending_data;
+        s_pending = false;
+        SDL_UnlockMutex(s_lock);
+
+        bool ok = persist_write(&data);
+
+        SDL_LockMutex(s_lock);
+        if (ok) {
+            s_stats.writes++;
+        } else {
+            s_stats.failures++;
+            LOG_ERROR(LOG_CAT_SAVE, "Failed to write save %s\n", s_path);
+        }
+    }
+    SDL_UnlockMutex(s_lock);
+    return 0;
+}
+
+static void persist_enqueue(void) {
+    s_data.checksum = persist_checksum(&s_data);
+    s_stats.requests++;
+
+    // No writer thread (e.g. single-threaded web builds): write in place
+    if (!s_thread) {
+        if (persist_write(&s_data)) {
+            s_stats.writes++;
+        } else {
+            s_stats.failures++;
+        }
+        return;
+    }
+
+    // The lock is only ever held for copies, never across file I/O
+    Uint64 start = SDL_GetPerformanceCounter();
+    SDL_LockMutex(s_lock);
+    if (s_pending) {
+        s_stats.coalesced++;
+    }
+    s_pending_data = s_data;
+    s_pending = true;
+    SDL_CondSignal(s_wake);
+    SDL_UnlockMutex(s_lock);
+    Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+
+    s_enqueue_ticks += elapsed;
+    if (elapsed > s_enqueue_max_ticks) {
+        s_enqueue_max_ticks = elapsed;
+    }
+}
+
+const char* persist_pref_dir(void) {
+    static char dir[PERSIST_DIR_MAX];
+    static bool resolved = false;
+    if (!resolved) {
+        char* pref = SDL_GetPrefPath("VitaBreak", "BreakOut");
+        snprintf(dir, sizeof(dir), "%s", pref ? pref : "");
+        SDL_free(pref);
+        resolved = true;
+    }
+    return dir;
+}
+
+bool persist_init(const char* path) {
+    if (path) {
+        snprintf(s_path, sizeof(s_path), "%s", path);
+    } else {
+        snprintf(s_path, sizeof(s_path), "%s%s", persist_pref_dir(), PERSIST_FILE);
+    }
+
+    if (!persist_load(s_path, &s_data)) {
+        persist_defaults(&s_data);
+    }
+
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_enqueue_ticks = 0;
+    s_enqueue_max_ticks = 0;
+    s_pending = false;
+    s_quit = false;
+
+    s_lock = SDL_CreateMutex();
+    s_wake = SDL_CreateCond();
+    s_thread = (s_lock && s_wake) ? SDL_CreateThread(persist_thread, "persist", NULL) : NULL;
+    if (!s_thread) {
+        LOG_WARN(LOG_CAT_SAVE, "Save writer thread unavailable, saving synchronously\n");
+    }
+    s_active = true;
+    return true;
+}
+
+void persist_shutdown(void) {
+    s_active = false;
+    if (s_thread) {
+        SDL_LockMutex(s_lock);
+        s_quit = true;
+        SDL_CondSignal(s_wake);
+        SDL_UnlockMutex(s_lock);
+        SDL_WaitThread(s_thread, NULL);
+        s_thread = NULL;
+    }
+    if (s_wake) {
+        SDL_DestroyCond(s_wake);
+        s_wake = NULL;
+    }
+    if (s_lock) {
+        SDL_DestroyMutex(s_lock);
+        s_lock = NULL;
+    }
+
+    if (s_stats.requests > 0) {
+        PersistStats stats = persist_get_stats();
+        LOG_INFO(LOG_CAT_SAVE, "Saves: %d requested, %d written, %d coalesced, %d failed; enqueue max %.1f us, avg %.2f us\n",
+                 stats.requests, stats.writes, stats.coalesced, stats.failures,
+                 stats.enqueue_max_us, stats.enqueue_avg_us);
+    }
+}
+
+const SaveData* persist_data(void) {
+    return &s_data;
+}
+
+PersistStats persist_get_stats(void) {
+    if (s_lock) {
+        SDL_LockMutex(s_lock);
+    }
+    PersistStats stats = s_stats;
+    if (s_lock) {
+        SDL_UnlockMutex(s_lock);
+    }
+
+    double us = 1000000.0 / (double)SDL_GetPerformanceFrequency();
+    stats.enqueue_max_us = s_enqueue_max_ticks * us;
+    stats.enqueue_avg_us = stats.requests ? s_enqueue_ticks * us / stats.requests : 0.0;
+    return stats;
+}
+
+void persist_record_game(int score, int stage, bool completed) {
+    if (!s_active) {
+        return;
+    }
+    s_data.games_played++;
+    if (completed) {
+        s_data.games_completed++;
+    }
+    if (score > s_data.high_score) {
+        s_data.high_score = score;
+    }
+    if (stage > s_data.best_stage) {
+        s_data.best_stage = stage;
+    }
+    persist_enqueue();
+}
+
+void persist_record_stage(int stage) {
+    if (s_active && stage > s_data.best_stage) {
+        s_data.best_stage = stage;
+        persist_enqueue();
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef PERSIST_H
+#define PERSIST_H
+
+#if defined(__EMSCRIPTEN__) || defined(_WIN32)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+#include <stdbool.h>
+
+// High-score and progress persistence
+//
+// The game thread only updates the in-memory record and hands a copy to a
+// background writer thread. The writer waits a moment so bursts of saves
+// coalesce into one write, then writes a temp file and renames it over the
+// old one so a crash or power loss never leaves a torn save.
+
+#define PERSIST_MAGIC 0x56534B42u       // "BKSV"
+#define PERSIST_VERSION 1
+#define PERSIST_FILE "progress.bin"
+#define PERSIST_COALESCE_MS 250         // Writer waits this long for more saves
+
+typedef struct {
+    Uint32 magic;
+    Uint16 version;
+    Uint16 reserved;
+    Sint32 high_score;
+    Sint32 best_stage;          // Highest stage reached
+    Sint32 games_played;
+    Sint32 games_completed;
+    Uint32 checksum;            // FNV-1a of the fields above
+} SaveData;
+
+typedef struct {
+    int requests;               // Saves enqueued by the game
+    int writes;                 // Files actually written
+    int coalesced;              // Requests folded into a pending save
+    int failures;
+    double enqueue_max_us;      // Worst-case time the game thread spent enqueuing
+    double enqueue_avg_us;
+} PersistStats;
+
+// Load the save (NULL path: PERSIST_FILE in the pref path) and start the writer
+bool persist_init(const char* path);
+
+// Flush any pending save and stop the writer
+void persist_shutdown(void);
+
+const SaveData* persist_data(void);
+PersistStats persist_get_stats(void);
+
+// Both do nothing outside persist_init .. persist_shutdown (headless benches
+// never touch the file system)
+
+// Record a finished game; always saves (games_played goes up every time)
+void persist_record_game(int score, int stage, bool completed);
+
+// Record a stage reached mid-run; saves only on a new best stage
+void persist_record_stage(int stage);
+
+// Per-user writable directory (SDL pref path, with trailing separator)
+const char* persist_pref_dir(void);
+
+#endif // PERSIST_H
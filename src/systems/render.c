@@ -0,0 +1,284 @@
+#include "render.h"
+#include "alloc_track.h"
+#include "capture.h"
+#include "log.h"
+#include <string.h>
+
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+// Command ids mixed into the frame hash
+typedef enum {
+    CMD_COLOR = 1,
+    CMD_CLEAR,
+    CMD_FILL_RECT,
+    CMD_GEOMETRY,
+    CMD_COPY,
+    CMD_TEXT,
+    CMD_CLIP
+} RenderCommand;
+
+static const char* backend_names[] = {"gpu", "software", "null", "record"};
+
+static void render_hash(Renderer* renderer, const void* data, size_t size) {
+    const Uint8* bytes = (const Uint8*)data;
+    Uint64 hash = renderer->frame_hash;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    renderer->frame_hash = hash;
+}
+
+static void render_hash_command(Renderer* renderer, RenderCommand cmd, const void* data, size_t size) {
+    if (renderer->type != RENDER_BACKEND_RECORD) {
+        return;
+    }
+    Uint8 id = (Uint8)cmd;
+    render_hash(renderer, &id, 1);
+    if (data) {
+        render_hash(renderer, data, size);
+    }
+}
+
+static void render_reset_frame(Renderer* renderer) {
+    memset(&renderer->frame, 0, sizeof(renderer->frame));
+    renderer->frame_hash = FNV_OFFSET;
+}
+
+bool render_create(Renderer* renderer, RenderBackendType type, SDL_Window* window) {
+    memset(renderer, 0, sizeof(*renderer));
+    renderer->type = type;
+    renderer->window = window;
+    renderer->scale = 1.0f;
+    render_reset_frame(renderer);
+
+    switch (type) {
+        case RENDER_BACKEND_GPU:
+            renderer->sdl = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+            break;
+        case RENDER_BACKEND_SOFTWARE: {
+            // Draw straight into the window surface: pixels persist between frames,
+            // which partial redraws rely on
+            SDL_Surface* surface = SDL_GetWindowSurface(window);
+            renderer->sdl = surface ? SDL_CreateSoftwareRenderer(surface) : NULL;
+            break;
+        }
+        case RENDER_BACKEND_NULL:
+        case RENDER_BACKEND_RECORD:
+            return true;
+    }
+
+    if (!renderer->sdl) {
+        LOG_ERROR(LOG_CAT_RENDER, "Renderer could not be created! SDL_Error: %s\n", SDL_GetError());
+        return false;
+    }
+    SDL_GetRendererOutputSize(renderer->sdl, &renderer->output_width, &renderer->output_height);
+    return true;
+}
+
+void render_destroy(Renderer* renderer) {
+    if (renderer->target) {
+        SDL_DestroyTexture(renderer->target);
+        renderer->target = NULL;
+    }
+    if (renderer->sdl) {
+        SDL_DestroyRenderer(renderer->sdl);
+        renderer->sdl = NULL;
+    }
+}
+
+// Point drawing at the target, scaled so full-size coordinates fill it
+static void render_bind_target(Renderer* renderer) {
+    int width, height;
+    SDL_QueryTexture(renderer->target, NULL, NULL, &width, &height);
+    SDL_SetRenderTarget(renderer->sdl, renderer->target);
+    SDL_RenderSetScale(renderer->sdl, (float)width / renderer->output_width,
+                       (float)height / renderer->output_height);
+}
+
+bool render_set_scale(Renderer* renderer, float scale) {
+    if (!renderer->sdl || !SDL_RenderTargetSupported(renderer->sdl)) {
+        return false;
+    }
+    if (scale > 1.0f) {
+        scale = 1.0f;
+    }
+    if (scale <= 0.0f || scale == renderer->scale) {
+        return scale > 0.0f;
+    }
+
+    if (renderer->target) {
+        SDL_SetRenderTarget(renderer->sdl, NULL);
+        SDL_DestroyTexture(renderer->target);
+        renderer->target = NULL;
+    }
+    renderer->scale = 1.0f;
+    if (scale == 1.0f) {
+        return true;
+    }
+
+    int width = (int)(renderer->output_width * scale + 0.5f);
+    int height = (int)(renderer->output_height * scale + 0.5f);
+    renderer->target = SDL_CreateTexture(renderer->sdl, SDL_PIXELFORMAT_ARGB8888,
+                                         SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!renderer->target) {
+        LOG_ERROR(LOG_CAT_RENDER, "Could not create %dx%d render target: %s\n",
+                  width, height, SDL_GetError());
+        return false;
+    }
+    renderer->scale = scale;
+    render_bind_target(renderer);
+    return true;
+}
+
+bool render_set_vsync(Renderer* renderer, bool vsync) {
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    if (renderer->type == RENDER_BACKEND_GPU) {
+        return SDL_RenderSetVSync(renderer->sdl, vsync ? 1 : 0) == 0;
+    }
+#endif
+    return !vsync;
+}
+
+// Upscale the target into the output before presenting
+static void render_resolve_target(Renderer* renderer) {
+    SDL_SetRenderTarget(renderer->sdl, NULL);
+    SDL_RenderCopy(renderer->sdl, renderer->target, NULL, NULL);
+}
+
+const char* render_backend_name(RenderBackendType type) {
+    return backend_names[type];
+}
+
+bool render_backend_from_name(const char* name, RenderBackendType* type) {
+    for (int i = 0; i < (int)(sizeof(backend_names) / sizeof(backend_names[0])); i++) {
+        if (strcmp(name, backend_names[i]) == 0) {
+            *type = (RenderBackendType)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void render_set_color(Renderer* renderer, Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+    renderer->color[0] = r;
+    renderer->color[1] = g;
+    renderer->color[2] = b;
+    renderer->color[3] = a;
+    render_hash_command(renderer, CMD_COLOR, renderer->color, sizeof(renderer->color));
+
+    if (renderer->sdl) {
+        SDL_SetRenderDrawColor(renderer->sdl, r, g, b, a);
+    }
+}
+
+void render_clear(Renderer* renderer) {
+    renderer->frame.clears++;
+    renderer->frame.commands++;
+    render_hash_command(renderer, CMD_CLEAR, NULL, 0);
+
+    if (renderer->sdl) {
+        SDL_RenderClear(renderer->sdl);
+    }
+}
+
+void render_fill_rect(Renderer* renderer, const SDL_Rect* rect) {
+    renderer->frame.fill_rects++;
+    renderer->frame.commands++;
+    render_hash_command(renderer, CMD_FILL_RECT, rect, sizeof(*rect));
+
+    if (renderer->sdl) {
+        SDL_RenderFillRect(renderer->sdl, rect);
+    }
+}
+
+void render_geometry(Renderer* renderer, SDL_Texture* texture,
+                     const SDL_Vertex* vertices, int num_vertices,
+                     const int* indices, int num_indices) {
+    renderer->frame.geometry_calls++;
+    renderer->frame.vertices += num_vertices;
+    renderer->frame.commands++;
+    render_hash_command(renderer, CMD_GEOMETRY, vertices, sizeof(SDL_Vertex) * num_vertices);
+
+    if (renderer->sdl) {
+        SDL_RenderGeometry(renderer->sdl, texture, vertices, num_vertices, indices, num_indices);
+    }
+}
+
+void render_copy(Renderer* renderer, SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dst) {
+    renderer->frame.copies++;
+    renderer->frame.commands++;
+    render_hash_command(renderer, CMD_COPY, dst, dst ? sizeof(*dst) : 0);
+
+    if (renderer->sdl) {
+        SDL_RenderCopy(renderer->sdl, texture, src, dst);
+    }
+}
+
+void render_text(Renderer* renderer, const char* text, int x, int y) {
+    int pos[2] = {x, y};
+    renderer->frame.texts++;
+    renderer->frame.commands++;
+    render_hash_command(renderer, CMD_TEXT, pos, sizeof(pos));
+    render_hash_command(renderer, CMD_TEXT, text, strlen(text));
+}
+
+void render_set_clip(Renderer* renderer, const SDL_Rect* rect) {
+    renderer->frame.clip_changes++;
+    renderer->frame.commands++;
+    render_hash_command(renderer, CMD_CLIP, rect, rect ? sizeof(*rect) : 0);
+
+    if (renderer->sdl) {
+        SDL_RenderSetClipRect(renderer->sdl, rect);
+    }
+}
+
+static void render_end_frame(Renderer* renderer, Uint64 present_start, Uint64 capture_ticks) {
+    renderer->present_ticks = SDL_GetPerformanceCounter() - present_start - capture_ticks;
+    renderer->capture_ticks = capture_ticks;
+    renderer->last_frame = renderer->frame;
+    renderer->last_frame_hash = renderer->frame_hash;
+    render_reset_frame(renderer);
+}
+
+void render_present(Renderer* renderer) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    alloc_track_phase(ALLOC_PHASE_PRESENT);
+
+    if (renderer->target) {
+        render_resolve_target(renderer);
+    }
+    // Readback is capture overhead, kept apart so the frame budget can ignore it
+    Uint64 capture_ticks = capture_frame(renderer);
+    if (renderer->type == RENDER_BACKEND_GPU) {
+        SDL_RenderPresent(renderer->sdl);
+    } else if (renderer->type == RENDER_BACKEND_SOFTWARE) {
+        SDL_UpdateWindowSurface(renderer->window);
+    }
+    if (renderer->target) {
+        render_bind_target(renderer);
+    }
+
+    render_end_frame(renderer, start, capture_ticks);
+}
+
+void render_present_rects(Renderer* renderer, const SDL_Rect* rects, int count) {
+    if (renderer->target) {
+        render_present(renderer);   // Rects are in output pixels; the target isn't
+        return;
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    alloc_track_phase(ALLOC_PHASE_PRESENT);
+    Uint64 capture_ticks = capture_frame(renderer);
+
+    if (renderer->type == RENDER_BACKEND_GPU) {
+        // Back buffers are not preserved, so a GPU present is always full
+        SDL_RenderPresent(renderer->sdl);
+    } else if (renderer->type == RENDER_BACKEND_SOFTWARE) {
+        SDL_UpdateWindowSurfaceRects(renderer->window, rects, count);
+    }
+
+    render_end_frame(renderer, start, capture_ticks);
+}
@@ -0,0 +1,89 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <stdbool.h>
+
+#if defined(__EMSCRIPTEN__) || defined(_WIN32)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+
+// Thin render interface
+//
+// All game drawing goes through these calls instead of SDL_Render* so the
+// same render path can run on different backends. Every backend counts the
+// commands it receives; the SDL backends also draw them, and the record
+// backend hashes them so frames can be compared across builds.
+
+typedef enum {
+    RENDER_BACKEND_GPU = 0,     // SDL accelerated renderer
+    RENDER_BACKEND_SOFTWARE,    // SDL software renderer on the window surface
+    RENDER_BACKEND_NULL,        // Count commands only (headless)
+    RENDER_BACKEND_RECORD       // Count and hash commands (headless regression checks)
+} RenderBackendType;
+
+// Commands issued during one frame
+typedef struct {
+    int clears;
+    int fill_rects;
+    int geometry_calls;
+    int vertices;
+    int copies;
+    int texts;          // Text draws seen by backends without an SDL renderer
+    int clip_changes;
+    int commands;       // Total of all the above
+} RenderStats;
+
+typedef struct {
+    RenderBackendType type;
+    SDL_Renderer* sdl;          // NULL for the null and record backends
+    SDL_Window* window;         // Presented directly by the software backend
+
+    RenderStats frame;          // Current frame
+    RenderStats last_frame;     // Last presented frame
+    Uint64 frame_hash;          // Record backend: FNV-1a of the current frame's commands
+    Uint64 last_frame_hash;
+    Uint64 present_ticks;       // Performance counter ticks spent presenting the last frame
+    Uint64 capture_ticks;       // ...and reading it back for --capture (not in present_ticks)
+
+    Uint8 color[4];             // Current draw color
+
+    // Reduced internal resolution (SDL backends): drawing goes to target with
+    // the render scale set, so callers keep using full-size coordinates
+    float scale;                // 1.0: draw straight to the output
+    SDL_Texture* target;
+    int output_width;
+    int output_height;
+} Renderer;
+
+// Create a backend. The null and record backends do not need a window.
+bool render_create(Renderer* renderer, RenderBackendType type, SDL_Window* window);
+void render_destroy(Renderer* renderer);
+
+const char* render_backend_name(RenderBackendType type);
+bool render_backend_from_name(const char* name, RenderBackendType* type);
+
+// Draw at scale times the output resolution (clamped to (0, 1]), upscaled
+// on present. False if the backend can't (headless, no render targets).
+bool render_set_scale(Renderer* renderer, float scale);
+
+// Wait for vertical sync on present (GPU backend, SDL 2.0.18 and later)
+bool render_set_vsync(Renderer* renderer, bool vsync);
+
+// Draw commands
+void render_set_color(Renderer* renderer, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+void render_clear(Renderer* renderer);
+void render_fill_rect(Renderer* renderer, const SDL_Rect* rect);
+void render_geometry(Renderer* renderer, SDL_Texture* texture,
+                     const SDL_Vertex* vertices, int num_vertices,
+                     const int* indices, int num_indices);
+void render_copy(Renderer* renderer, SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dst);
+void render_text(Renderer* renderer, const char* text, int x, int y);
+void render_set_clip(Renderer* renderer, const SDL_Rect* rect);
+
+// End the frame: show everything, or only rects (software backend)
+void render_present(Renderer* renderer);
+void render_present_rects(Renderer* renderer, const SDL_Rect* rects, int count);
+
+#endif // RENDER_H
@@ -0,0 +1,119 @@
+#include "res_governor.h"
+#include "frame_budget.h"
+#include "log.h"
+#include "metrics.h"
+#include <stdio.h>
+#include <string.h>
+
+static Renderer* s_renderer = NULL;
+static bool s_enabled = false;
+static double s_budget_ms = 1000.0 / 60.0;
+static double s_window_ms = 0.0;
+static int s_window_frames = 0;
+static int s_calm_windows = 0;
+static bool s_skip_window = false;  // Window after a change includes the switch itself
+static ResGovernorStats s_stats;
+
+static void res_governor_apply(float scale) {
+    if (!render_set_scale(s_renderer, scale)) {
+        LOG_WARN(LOG_CAT_RENDER, "Dynamic resolution off: can't draw at %.0f%%\n", scale * 100.0f);
+        render_set_scale(s_renderer, 1.0f);
+        s_enabled = false;
+        s_stats.scale = 1.0f;
+        return;
+    }
+
+    if (scale < s_stats.scale) {
+        s_stats.lowered++;
+    } else {
+        s_stats.raised++;
+    }
+    s_stats.scale = scale;
+    if (scale < s_stats.min_scale_used) {
+        s_stats.min_scale_used = scale;
+    }
+    s_skip_window = true;
+    METRICS_GAUGE("render.scale", scale);
+    LOG_DEBUG(LOG_CAT_RENDER, "Internal resolution %dx%d (%.0f%%)\n",
+              (int)(s_renderer->output_width * scale + 0.5f),
+              (int)(s_renderer->output_height * scale + 0.5f), scale * 100.0f);
+}
+
+bool res_governor_init(Renderer* renderer, bool enabled, float scale, int frame_rate) {
+    s_renderer = renderer;
+    s_budget_ms = 1000.0 / frame_rate;
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stats.scale = 1.0f;
+    s_stats.min_scale_used = 1.0f;
+    s_window_ms = 0.0;
+    s_window_frames = 0;
+    s_calm_windows = 0;
+    s_skip_window = false;
+
+    // Probe once so a backend without render targets is ruled out up front
+    bool targets = render_set_scale(renderer, 1.0f);
+    s_enabled = enabled && targets;
+    if (targets && scale < 1.0f && render_set_scale(renderer, scale)) {
+        s_stats.scale = scale;
+        s_stats.min_scale_used = scale;
+        METRICS_GAUGE("render.scale", scale);
+    }
+    return s_enabled;
+}
+
+void res_governor_shutdown(void) {
+    if (s_stats.lowered > 0) {
+        LOG_INFO(LOG_CAT_RENDER, "Dynamic resolution: lowered %d times, raised %d, lowest %.0f%%, ended at %.0f%%\n",
+                 s_stats.lowered, s_stats.raised, s_stats.min_scale_used * 100.0f, s_stats.scale * 100.0f);
+    }
+    s_enabled = false;
+}
+
+void res_governor_frame(double work_ms) {
+    if (!s_enabled) {
+        return;
+    }
+
+    // Capture readback is not the game's work
+    work_ms -= s_renderer->capture_ticks * 1000.0 / SDL_GetPerformanceFrequency();
+
+    // GPU presents may block on vsync: only count the CPU work before it
+    if (s_renderer->type == RENDER_BACKEND_GPU) {
+        work_ms -= s_renderer->present_ticks * 1000.0 / SDL_GetPerformanceFrequency();
+    }
+
+    s_window_ms += work_ms;
+    if (++s_window_frames < RES_GOVERNOR_WINDOW) {
+        return;
+    }
+    double average = s_window_ms / s_window_frames;
+    s_window_ms = 0.0;
+    s_window_frames = 0;
+    if (s_skip_window) {
+        s_skip_window = false;
+        return;
+    }
+
+    float scale = s_stats.scale;
+    float higher = scale + RES_SCALE_STEP > 1.0f ? 1.0f : scale + RES_SCALE_STEP;
+    double growth = (double)(higher * higher) / (scale * scale);
+    if (average > s_budget_ms * RES_GOVERNOR_HIGH) {
+        s_calm_windows = 0;
+        // Optional work goes first; pixels only once the quality tiers are used up
+        if (scale > RES_SCALE_MIN && frame_budget_exhausted()) {
+            float lower = scale - RES_SCALE_STEP;
+            res_governor_apply(lower < RES_SCALE_MIN ? RES_SCALE_MIN : lower);
+        }
+    } else if (scale < 1.0f && average * growth < s_budget_ms * RES_GOVERNOR_LOW) {
+        if (++s_calm_windows >= RES_GOVERNOR_RAISE_WINDOWS) {
+            s_calm_windows = 0;
+            res_governor_apply(higher);
+        }
+    } else {
+        s_calm_windows = 0;
+    }
+}
+
+ResGovernorStats res_governor_get_stats(void) {
+    return s_stats;
+}
@@ -0,0 +1,42 @@
+#ifndef RES_GOVERNOR_H
+#define RES_GOVERNOR_H
+
+#include <stdbool.h>
+#include "render.h"
+
+// Dynamic resolution governor
+//
+// Watches how long each frame's work takes and moves the renderer's internal
+// scale in fixed steps: down as soon as a window of frames averages over
+// budget, up only after several windows in which the next step up would
+// still fit with room to spare (assuming cost grows with the pixel count),
+// so the scale doesn't flip back and forth. It only steps down once the
+// frame budget has no quality tier left to drop. Gameplay keeps using
+// full-size coordinates; only the number of pixels drawn changes.
+
+#define RES_SCALE_MIN 0.5f
+#define RES_SCALE_STEP 0.125f
+#define RES_GOVERNOR_WINDOW 30              // Frames averaged per decision
+#define RES_GOVERNOR_HIGH 0.90              // Step down above this share of the budget
+#define RES_GOVERNOR_LOW 0.75               // Step up if the next scale stays below this share...
+#define RES_GOVERNOR_RAISE_WINDOWS 4        // ...for this many windows in a row
+
+typedef struct {
+    float scale;
+    float min_scale_used;
+    int lowered;
+    int raised;
+} ResGovernorStats;
+
+// Start at scale (the device profile's) with one frame at frame_rate as the
+// budget. Off when disabled or the backend can't draw at a reduced size; the
+// scale then stays where it started.
+bool res_governor_init(Renderer* renderer, bool enabled, float scale, int frame_rate);
+void res_governor_shutdown(void);
+
+// Feed the frame's update + render + present time
+void res_governor_frame(double work_ms);
+
+ResGovernorStats res_governor_get_stats(void);
+
+#endif // RES_GOVERNOR_H
@@ -0,0 +1,345 @@
+#include "snapshot.h"
+#include "../game/score.h"
+#include "persist.h"
+#include "log.h"
+#include <stdio.h>
+#include <string.h>
+
+// Delta token: [zero bytes to skip][literal count][count XOR bytes]
+#define REWIND_RUN_MAX 255
+#define REWIND_DELTA_MAX (sizeof(Snapshot) + 2 * (sizeof(Snapshot) / REWIND_RUN_MAX + 1))
+
+typedef struct {
+    int offset;
+    int size;
+} RewindEntry;
+
+typedef struct {
+    Uint8 data[REWIND_BUFFER_BYTES];
+    RewindEntry entries[REWIND_MAX_TICKS];
+    int first;              // Oldest entry
+    int count;
+    int write;              // Next free offset in data
+    Snapshot current;       // Newest snapshot; deltas lead back from it
+    bool has_current;
+} RewindBuffer;
+
+static RewindBuffer s_rewind;
+static Uint8 s_delta[REWIND_DELTA_MAX];
+
+static Uint32 snapshot_phys_bits(phys_t value) {
+    Uint32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// Read a ball value written by either a float or a fixed-point build
+static phys_t snapshot_phys_value(Uint32 bits, bool fixed) {
+#ifdef PHYSICS_FIXED
+    bool native = fixed;
+#else
+    bool native = !fixed;
+#endif
+    if (native) {
+        phys_t value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    if (fixed) {
+        Sint32 raw;
+        memcpy(&raw, &bits, sizeof(raw));
+        return phys_from_float(raw / 65536.0f);
+    }
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return phys_from_float(value);
+}
+
+void snapshot_capture(const GameContext* ctx, Snapshot* snap) {
+    // Zero everything so unused bits never show up in deltas
+    memset(snap, 0, sizeof(*snap));
+    snap->magic = SNAPSHOT_MAGIC;
+    snap->version = SNAPSHOT_VERSION;
+#ifdef PHYSICS_FIXED
+    snap->flags = SNAPSHOT_FLAG_FIXED;
+#endif
+
+    snap->state = ctx->current_state;
+    snap->score = score_get();
+    snap->lives = ctx->lives;
+    snap->current_stage = ctx->current_stage;
+    snap->score_multiplier = g_score_multiplier;
+    snap->ball_launched = ctx->ball_launched;
+    snap->endless_mode = ctx->endless_mode;
+
+    snap->paddle_x = ctx->paddle->x;
+    snap->paddle_y = ctx->paddle->y;
+    snap->paddle_width = ctx->paddle->width;
+
+    const Ball* ball = ctx->ball;
+    snap->ball_x = snapshot_phys_bits(ball->x);
+    snap->ball_y = snapshot_phys_bits(ball->y);
+    snap->ball_vx = snapshot_phys_bits(ball->vx);
+    snap->ball_vy = snapshot_phys_bits(ball->vy);
+    snap->ball_base_speed = snapshot_phys_bits(ball->base_speed);
+    snap->ball_current_speed = snapshot_phys_bits(ball->current_speed);
+    snap->ball_collision_count = ball->collision_count;
+
+    const Stage* stage = ctx->stage;
+    snap->stage_number = stage->stage_number;
+    snap->stage_seed = stage->seed;
+    for (int i = 0; i < MAX_BRICKS; i++) {
+        const Brick* brick = &stage->bricks[i];
+        if (brick->active) {
+            snap->brick_alive[i / 32] |= 1u << (i % 32);
+        }
+        if (brick->durability > 0 && brick->durability < brick->max_durability) {
+            snap->brick_damaged[i / 32] |= 1u << (i % 32);
+        }
+    }
+
+    if (ctx->entities) {
+        powerup_save_state(ctx->entities, &snap->powerups);
+    }
+}
+
+bool snapshot_apply(GameContext* ctx, const Snapshot* snap) {
+    if (snap->magic != SNAPSHOT_MAGIC || snap->version != SNAPSHOT_VERSION) {
+        LOG_WARN(LOG_CAT_SAVE, "Snapshot rejected (magic %08x, version %d)\n", snap->magic, snap->version);
+        return false;
+    }
+
+    ctx->current_state = (GameStateType)snap->state;
+    ctx->next_state = ctx->current_state;
+    ctx->state_changed = false;
+    ctx->score = snap->score;
+    ctx->lives = snap->lives;
+    ctx->current_stage = snap->current_stage;
+    ctx->ball_launched = snap->ball_launched != 0;
+    ctx->endless_mode = snap->endless_mode != 0;
+    g_score = snap->score;
+    g_score_multiplier = snap->score_multiplier;
+
+    Paddle* paddle = ctx->paddle;
+    paddle->x = snap->paddle_x;
+    paddle->y = snap->paddle_y;
+    paddle->width = snap->paddle_width;
+    paddle_update_bounds(paddle);
+
+    bool fixed = (snap->flags & SNAPSHOT_FLAG_FIXED) != 0;
+    Ball* ball = ctx->ball;
+    ball->x = snapshot_phys_value(snap->ball_x, fixed);
+    ball->y = snapshot_phys_value(snap->ball_y, fixed);
+    ball->vx = snapshot_phys_value(snap->ball_vx, fixed);
+    ball->vy = snapshot_phys_value(snap->ball_vy, fixed);
+    ball->base_speed = snapshot_phys_value(snap->ball_base_speed, fixed);
+    ball->current_speed = snapshot_phys_value(snap->ball_current_speed, fixed);
+    ball->collision_count = snap->ball_collision_count;
+    ball->active = true;
+
+    // Brick layout only depends on the stage number and seed: rebuild it when
+    // those change, then overlay liveness and damage
+    Stage* stage = ctx->stage;
+    if (stage->stage_number != snap->stage_number || stage->seed != snap->stage_seed) {
+        stage->seed = snap->stage_seed;
+        stage_init(stage, snap->stage_number);
+    }
+    for (int i = 0; i < MAX_BRICKS; i++) {
+        Brick* brick = &stage->bricks[i];
+        Uint32 mask = 1u << (i % 32);
+        brick->active = (snap->brick_alive[i / 32] & mask) != 0;
+        if (brick->max_durability > 0) {
+            brick->durability = (snap->brick_damaged[i / 32] & mask)
+                ? brick->max_durability - 1 : brick->max_durability;
+        }
+    }
+    stage_is_cleared(stage);
+    stage->revision++;
+
+    // After the paddle: restoring effects reapplies them to it
+    if (ctx->entities) {
+        powerup_load_state(ctx->entities, paddle, &snap->powerups);
+    }
+
+    if (ctx->dirty_rects) {
+        damage_add_full(&ctx->damage);
+    }
+    return true;
+}
+
+bool snapshot_save(const Snapshot* snap, const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        LOG_ERROR(LOG_CAT_SAVE, "Failed to open %s for writing\n", path);
+        return false;
+    }
+
+    bool ok = fwrite(snap, sizeof(*snap), 1, file) == 1;
+    if (fclose(file) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        LOG_ERROR(LOG_CAT_SAVE, "Failed to write snapshot %s\n", path);
+        remove(path);
+    }
+    return ok;
+}
+
+bool snapshot_load(const char* path, Snapshot* snap) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    // Exactly one snapshot, nothing trailing
+    bool ok = fread(snap, sizeof(*snap), 1, file) == 1 && fgetc(file) == EOF;
+    fclose(file);
+
+    if (!ok || snap->magic != SNAPSHOT_MAGIC || snap->version != SNAPSHOT_VERSION) {
+        LOG_WARN(LOG_CAT_SAVE, "Ignoring invalid snapshot %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+const char* snapshot_resume_path(void) {
+    static char path[512];
+    if (path[0] == '\0') {
+        snprintf(path, sizeof(path), "%s%s", persist_pref_dir(), SNAPSHOT_RESUME_FILE);
+    }
+    return path;
+}
+
+// ===== REWIND =====
+
+// Encode a XOR b; returns the encoded size
+static int rewind_encode(const Uint8* a, const Uint8* b, int size, Uint8* out) {
+    int pos = 0;
+    int length = 0;
+
+    while (pos < size) {
+        int skip = 0;
+        while (pos < size && a[pos] == b[pos] && skip < REWIND_RUN_MAX) {
+            pos++;
+            skip++;
+        }
+        if (pos == size) {
+            break;  // Trailing zeros are implied
+        }
+
+        int start = pos;
+        int count = 0;
+        while (pos < size && a[pos] != b[pos] && count < REWIND_RUN_MAX) {
+            pos++;
+            count++;
+        }
+
+        out[length++] = (Uint8)skip;
+        out[length++] = (Uint8)count;
+        for (int i = 0; i < count; i++) {
+            out[length++] = a[start + i] ^ b[start + i];
+        }
+    }
+
+    // An unchanged tick still takes one empty token, so every entry holds ring space
+    if (length == 0) {
+        out[length++] = 0;
+        out[length++] = 0;
+    }
+    return length;
+}
+
+// XOR an encoded delta into target
+static void rewind_decode(const Uint8* delta, int length, Uint8* target) {
+    int pos = 0;
+    int i = 0;
+    while (i < length) {
+        pos += delta[i++];
+        int count = delta[i++];
+        for (int j = 0; j < count; j++) {
+            target[pos++] ^= delta[i++];
+        }
+    }
+}
+
+static void rewind_drop_oldest(void) {
+    s_rewind.first = (s_rewind.first + 1) % REWIND_MAX_TICKS;
+    s_rewind.count--;
+    if (s_rewind.count == 0) {
+        s_rewind.write = 0;
+    }
+}
+
+void rewind_reset(void) {
+    s_rewind.first = 0;
+    s_rewind.count = 0;
+    s_rewind.write = 0;
+    s_rewind.has_current = false;
+}
+
+void rewind_push(const Snapshot* snap) {
+    if (!s_rewind.has_current) {
+        s_rewind.current = *snap;
+        s_rewind.has_current = true;
+        return;
+    }
+
+    int size = rewind_encode((const Uint8*)&s_rewind.current, (const Uint8*)snap,
+                             (int)sizeof(Snapshot), s_delta);
+    s_rewind.current = *snap;
+
+    // Place the delta contiguously, wrapping to the start when the tail is too short.
+    // Entries past the write position are the oldest; wrapping abandons them.
+    int offset = s_rewind.write;
+    if (offset + size > REWIND_BUFFER_BYTES) {
+        while (s_rewind.count > 0 && s_rewind.entries[s_rewind.first].offset >= offset) {
+            rewind_drop_oldest();
+        }
+        offset = 0;
+    }
+
+    // Entries are laid out oldest-first around the ring, so evicting from the
+    // front frees exactly the region we are about to overwrite
+    while (s_rewind.count > 0) {
+        const RewindEntry* oldest = &s_rewind.entries[s_rewind.first];
+        bool overlaps = oldest->offset < offset + size && offset < oldest->offset + oldest->size;
+        if (!overlaps && s_rewind.count < REWIND_MAX_TICKS) {
+            break;
+        }
+        rewind_drop_oldest();
+    }
+
+    RewindEntry* entry = &s_rewind.entries[(s_rewind.first + s_rewind.count) % REWIND_MAX_TICKS];
+    entry->offset = offset;
+    entry->size = size;
+    memcpy(&s_rewind.data[offset], s_delta, size);
+    s_rewind.count++;
+    s_rewind.write = offset + size;
+}
+
+bool rewind_pop(Snapshot* snap) {
+    if (s_rewind.count == 0) {
+        return false;
+    }
+
+    int newest = (s_rewind.first + s_rewind.count - 1) % REWIND_MAX_TICKS;
+    const RewindEntry* entry = &s_rewind.entries[newest];
+    rewind_decode(&s_rewind.data[entry->offset], entry->size, (Uint8*)&s_rewind.current);
+    s_rewind.write = entry->offset;
+    s_rewind.count--;
+
+    *snap = s_rewind.current;
+    return true;
+}
+
+int rewind_depth(void) {
+    return s_rewind.count;
+}
+
+int rewind_bytes_used(void) {
+    int total = 0;
+    for (int i = 0; i < s_rewind.count; i++) {
+        total += s_rewind.entries[(s_rewind.first + i) % REWIND_MAX_TICKS].size;
+    }
+    return total;
+}
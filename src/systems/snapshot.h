@@ -0,0 +1,91 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#if defined(__EMSCRIPTEN__) || defined(_WIN32)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+#include <stdbool.h>
+#include "../states/game_state.h"
+#include "../game/powerup.h"
+
+// Game-state snapshots
+//
+// A Snapshot is a flat, fixed-size copy of everything gameplay needs to
+// continue: session counters, paddle, ball, stage, and running power-ups
+// with their falling capsules. Bricks are stored as liveness/damage
+// bitsets; positions and types are rebuilt from the stage number and seed.
+// Snapshots back suspend/resume (written to the pref path on quit or
+// backgrounding) and the rewind ring below.
+//
+// Files use native byte order: they are only ever read back on the device
+// that wrote them.
+
+#define SNAPSHOT_MAGIC 0x534B5242u      // "BRKS"
+#define SNAPSHOT_VERSION 2
+#define SNAPSHOT_FLAG_FIXED 0x0001      // Ball values are Q16.16 (PHYSICS_FIXED build)
+#define SNAPSHOT_BRICK_WORDS ((MAX_BRICKS + 31) / 32)
+#define SNAPSHOT_RESUME_FILE "resume.bin"
+
+// Rewind ring: XOR deltas between consecutive ticks, run-length encoded
+#define REWIND_BUFFER_BYTES (32 * 1024)
+#define REWIND_MAX_TICKS 900            // 15s at 60 ticks per second
+
+typedef struct {
+    // Header
+    Uint32 magic;
+    Uint16 version;
+    Uint16 flags;
+
+    // Session
+    Sint32 state;
+    Sint32 score;
+    Sint32 lives;
+    Sint32 current_stage;
+    float score_multiplier;
+    Uint8 ball_launched;
+    Uint8 endless_mode;
+    Uint8 reserved[2];
+
+    // Paddle
+    float paddle_x;
+    float paddle_y;
+    float paddle_width;
+
+    // Ball (phys_t bits, see SNAPSHOT_FLAG_FIXED)
+    Uint32 ball_x;
+    Uint32 ball_y;
+    Uint32 ball_vx;
+    Uint32 ball_vy;
+    Uint32 ball_base_speed;
+    Uint32 ball_current_speed;
+    Sint32 ball_collision_count;
+
+    // Stage
+    Sint32 stage_number;
+    Uint32 stage_seed;
+    Uint32 brick_alive[SNAPSHOT_BRICK_WORDS];
+    Uint32 brick_damaged[SNAPSHOT_BRICK_WORDS];    // Multi-hit bricks that took a hit
+
+    // Power-ups
+    PowerupState powerups;
+} Snapshot;
+
+// Capture / restore gameplay state
+void snapshot_capture(const GameContext* ctx, Snapshot* snap);
+bool snapshot_apply(GameContext* ctx, const Snapshot* snap);
+
+// Suspend/resume files
+bool snapshot_save(const Snapshot* snap, const char* path);
+bool snapshot_load(const char* path, Snapshot* snap);
+const char* snapshot_resume_path(void);
+
+// Rewind ring (one snapshot per gameplay tick, oldest dropped when full)
+void rewind_reset(void);
+void rewind_push(const Snapshot* snap);
+bool rewind_pop(Snapshot* snap);    // Step back one tick; false when empty
+int rewind_depth(void);             // Ticks that can be rewound
+int rewind_bytes_used(void);
+
+#endif // SNAPSHOT_H
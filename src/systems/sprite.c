@@ -0,0 +1,285 @@
+#include "sprite.h"
+#include "log.h"
+#include "texture_cache.h"
+#include <stdio.h>
+#include <string.h>
+
+// Names matched against atlas manifests, indexed by SpriteId
+static const char* sprite_names[SPRITE_ID_COUNT] = {
+    "paddle",
+    "ball",
+    "brick_normal",
+    "brick_multi",
+    "brick_unbreakable",
+    "brick_special"
+};
+
+typedef struct {
+    SDL_Texture* texture;
+    Uint64 key;                 // Texture cache key (the image path)
+    int width;
+    int height;
+} SpriteAtlas;
+
+// Queued quad (dst in pixels, UVs from the handle)
+typedef struct {
+    SpriteHandle sprite;
+    SDL_Rect dst;
+    SDL_Color color;
+} SpriteQuad;
+
+static SpriteAtlas atlases[SPRITE_MAX_ATLASES];
+static int atlas_count = 0;
+static SpriteHandle sprite_table[SPRITE_ID_COUNT];
+
+// Batch storage (static so submission never allocates)
+static SpriteQuad batch[SPRITE_BATCH_MAX];
+static SpriteQuad sorted[SPRITE_BATCH_MAX];
+static int batch_count = 0;
+static SDL_Vertex vertices[SPRITE_BATCH_MAX * 4];
+static int indices[SPRITE_BATCH_MAX * 6];
+
+// Stats
+static SpriteStats frame_stats;
+static SpriteStats last_frame_stats;
+static SpriteStats report_totals;
+static int report_frames = 0;
+static int last_atlas = SPRITE_ATLAS_NONE - 1;
+
+// Atlas image read ahead by sprite_prefetch, consumed by the first load of that path
+static SDL_Surface* prefetched = NULL;
+static char prefetched_path[256];
+
+static SpriteHandle sprite_solid(void) {
+    SpriteHandle handle = {SPRITE_ATLAS_NONE, 0.0f, 0.0f, 0.0f, 0.0f};
+    return handle;
+}
+
+void sprite_init(Renderer* renderer) {
+    atlas_count = 0;
+    batch_count = 0;
+    memset(&frame_stats, 0, sizeof(frame_stats));
+    memset(&last_frame_stats, 0, sizeof(last_frame_stats));
+    memset(&report_totals, 0, sizeof(report_totals));
+    report_frames = 0;
+
+    for (int i = 0; i < SPRITE_ID_COUNT; i++) {
+        sprite_table[i] = sprite_solid();
+    }
+
+    // Quad index pattern never changes, build it once
+    for (int i = 0; i < SPRITE_BATCH_MAX; i++) {
+        indices[i * 6 + 0] = i * 4 + 0;
+        indices[i * 6 + 1] = i * 4 + 1;
+        indices[i * 6 + 2] = i * 4 + 2;
+        indices[i * 6 + 3] = i * 4 + 2;
+        indices[i * 6 + 4] = i * 4 + 3;
+        indices[i * 6 + 5] = i * 4 + 0;
+    }
+
+    if (sprite_atlas_load(renderer, SPRITE_GAME_ATLAS) < 0) {
+        LOG_INFO(LOG_CAT_RENDER, "No sprite atlas found, using solid color sprites\n");
+    }
+}
+
+void sprite_cleanup(void) {
+    for (int i = 0; i < atlas_count; i++) {
+        if (atlases[i].texture) {
+            texture_cache_release(atlases[i].key);
+            atlases[i].texture = NULL;
+        }
+    }
+    atlas_count = 0;
+
+    if (prefetched) {
+        SDL_FreeSurface(prefetched);
+        prefetched = NULL;
+    }
+}
+
+bool sprite_prefetch(void) {
+    snprintf(prefetched_path, sizeof(prefetched_path), "%s.bmp", SPRITE_GAME_ATLAS);
+    prefetched = SDL_LoadBMP(prefetched_path);
+    return prefetched != NULL;
+}
+
+static SDL_Surface* sprite_load_image(void* userdata) {
+    const char* path = (const char*)userdata;
+    if (prefetched && strcmp(path, prefetched_path) == 0) {
+        SDL_Surface* surface = prefetched;
+        prefetched = NULL;
+        return surface;
+    }
+
+    SDL_Surface* surface = SDL_LoadBMP(path);
+    if (!surface) {
+        LOG_WARN(LOG_CAT_RENDER, "Failed to load atlas image %s: %s\n", path, SDL_GetError());
+    }
+    return surface;
+}
+
+int sprite_atlas_load(Renderer* renderer, const char* base_path) {
+    if (!renderer->sdl) {
+        return -1;
+    }
+    if (atlas_count >= SPRITE_MAX_ATLASES) {
+        LOG_WARN(LOG_CAT_RENDER, "Sprite atlas limit reached, skipping %s\n", base_path);
+        return -1;
+    }
+
+    char path[256];
+    snprintf(path, sizeof(path), "%s.atlas", base_path);
+    FILE* manifest = fopen(path, "r");
+    if (!manifest) {
+        return -1;
+    }
+
+    // The atlas holds its cache reference until sprite_cleanup
+    snprintf(path, sizeof(path), "%s.bmp", base_path);
+    Uint64 key = texture_cache_key(path, 0);
+    int width, height;
+    SDL_Texture* texture = texture_cache_acquire(key, sprite_load_image, path, &width, &height);
+    if (!texture) {
+        fclose(manifest);
+        return -1;
+    }
+
+    int index = atlas_count++;
+    atlases[index].texture = texture;
+    atlases[index].key = key;
+    atlases[index].width = width;
+    atlases[index].height = height;
+
+    // Manifest: "name x y w h" per line, '#' starts a comment
+    char line[128];
+    int loaded = 0;
+    while (fgets(line, sizeof(line), manifest) && loaded < SPRITE_MAX_PER_ATLAS) {
+        char name[64];
+        int x, y, w, h;
+        if (line[0] == '#' || sscanf(line, "%63s %d %d %d %d", name, &x, &y, &w, &h) != 5) {
+            continue;
+        }
+
+        for (int id = 0; id < SPRITE_ID_COUNT; id++) {
+            if (strcmp(name, sprite_names[id]) == 0) {
+                SpriteHandle* handle = &sprite_table[id];
+                handle->atlas = index;
+                handle->u0 = (float)x / width;
+                handle->v0 = (float)y / height;
+                handle->u1 = (float)(x + w) / width;
+                handle->v1 = (float)(y + h) / height;
+            }
+        }
+        loaded++;
+    }
+    fclose(manifest);
+
+    LOG_INFO(LOG_CAT_RENDER, "Loaded sprite atlas %s (%dx%d, %d sprites)\n", base_path, width, height, loaded);
+    return index;
+}
+
+SpriteHandle sprite_get(SpriteId id) {
+    if (id < 0 || id >= SPRITE_ID_COUNT) {
+        return sprite_solid();
+    }
+    return sprite_table[id];
+}
+
+void sprite_frame_begin(void) {
+    last_frame_stats = frame_stats;
+    report_totals.sprites += frame_stats.sprites;
+    report_totals.draw_calls += frame_stats.draw_calls;
+    report_totals.texture_switches += frame_stats.texture_switches;
+    report_frames++;
+
+    if (report_frames >= SPRITE_REPORT_INTERVAL) {
+        LOG_INFO(LOG_CAT_RENDER, "Sprites/frame: %.1f quads, %.2f draw calls, %.2f texture switches\n",
+                 (float)report_totals.sprites / report_frames,
+                 (float)report_totals.draw_calls / report_frames,
+                 (float)report_totals.texture_switches / report_frames);
+        memset(&report_totals, 0, sizeof(report_totals));
+        report_frames = 0;
+    }
+
+    memset(&frame_stats, 0, sizeof(frame_stats));
+    last_atlas = SPRITE_ATLAS_NONE - 1;
+}
+
+void sprite_batch_add(SpriteHandle sprite, const SDL_Rect* dst, SDL_Color color) {
+    if (batch_count >= SPRITE_BATCH_MAX) {
+        return;
+    }
+
+    SpriteQuad* quad = &batch[batch_count++];
+    quad->sprite = sprite;
+    quad->dst = *dst;
+    quad->color = color;
+}
+
+// Emit one draw call for quads[0..count) which all share an atlas
+static void sprite_submit(Renderer* renderer, int atlas, const SpriteQuad* quads, int count) {
+    for (int i = 0; i < count; i++) {
+        const SpriteQuad* quad = &quads[i];
+        SDL_Vertex* v = &vertices[i * 4];
+        float x0 = (float)quad->dst.x;
+        float y0 = (float)quad->dst.y;
+        float x1 = (float)(quad->dst.x + quad->dst.w);
+        float y1 = (float)(quad->dst.y + quad->dst.h);
+
+        v[0].position.x = x0; v[0].position.y = y0;
+        v[1].position.x = x1; v[1].position.y = y0;
+        v[2].position.x = x1; v[2].position.y = y1;
+        v[3].position.x = x0; v[3].position.y = y1;
+
+        v[0].tex_coord.x = quad->sprite.u0; v[0].tex_coord.y = quad->sprite.v0;
+        v[1].tex_coord.x = quad->sprite.u1; v[1].tex_coord.y = quad->sprite.v0;
+        v[2].tex_coord.x = quad->sprite.u1; v[2].tex_coord.y = quad->sprite.v1;
+        v[3].tex_coord.x = quad->sprite.u0; v[3].tex_coord.y = quad->sprite.v1;
+
+        v[0].color = v[1].color = v[2].color = v[3].color = quad->color;
+    }
+
+    SDL_Texture* texture = atlas >= 0 ? atlases[atlas].texture : NULL;
+    render_geometry(renderer, texture, vertices, count * 4, indices, count * 6);
+
+    frame_stats.draw_calls++;
+    if (atlas != last_atlas) {
+        frame_stats.texture_switches++;
+        last_atlas = atlas;
+    }
+}
+
+void sprite_batch_flush(Renderer* renderer) {
+    if (batch_count == 0) {
+        return;
+    }
+
+    // Counting sort by atlas (bucket 0 = solid color): stable and O(n)
+    int bucket_start[SPRITE_MAX_ATLASES + 2] = {0};
+    for (int i = 0; i < batch_count; i++) {
+        bucket_start[batch[i].sprite.atlas + 2]++;
+    }
+    for (int b = 1; b < SPRITE_MAX_ATLASES + 2; b++) {
+        bucket_start[b] += bucket_start[b - 1];
+    }
+    for (int i = 0; i < batch_count; i++) {
+        sorted[bucket_start[batch[i].sprite.atlas + 1]++] = batch[i];
+    }
+
+    // bucket_start[b] now holds the end of bucket b
+    int start = 0;
+    for (int b = 0; b < SPRITE_MAX_ATLASES + 1; b++) {
+        int end = bucket_start[b];
+        if (end > start) {
+            sprite_submit(renderer, b - 1, &sorted[start], end - start);
+        }
+        start = end;
+    }
+
+    frame_stats.sprites += batch_count;
+    batch_count = 0;
+}
+
+SpriteStats sprite_get_frame_stats(void) {
+    return last_frame_stats;
+}
@@ -0,0 +1,85 @@
+#ifndef SPRITE_H
+#define SPRITE_H
+
+#include <stdbool.h>
+
+#if defined(__EMSCRIPTEN__) || defined(_WIN32)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+#include "render.h"
+
+// Sprite atlas and batched sprite submission
+//
+// Sprite sheets are packed offline into one BMP per atlas plus a text
+// manifest next to it (assets/sprites/<name>.atlas), one sprite per line:
+//
+//     # name x y w h
+//     paddle 0 0 100 20
+//
+// Entities store a SpriteHandle (atlas index + UV rect) instead of a texture
+// pointer. Each frame's sprites are queued, grouped by atlas and submitted as
+// one SDL_RenderGeometry call per atlas.
+
+#define SPRITE_GAME_ATLAS "assets/sprites/game"
+#define SPRITE_MAX_ATLASES 8
+#define SPRITE_MAX_PER_ATLAS 64
+#define SPRITE_BATCH_MAX 512
+#define SPRITE_ATLAS_NONE -1            // Untextured (solid color) quad
+#define SPRITE_REPORT_INTERVAL 600      // Frames between stats reports (10s at 60 FPS)
+
+// Sprite reference stored on entities
+typedef struct {
+    int atlas;                  // Atlas index, SPRITE_ATLAS_NONE for solid color
+    float u0, v0, u1, v1;       // Normalized UV rect inside the atlas
+} SpriteHandle;
+
+// Well-known sprites, resolved by name when atlases load
+typedef enum {
+    SPRITE_PADDLE = 0,
+    SPRITE_BALL,
+    SPRITE_BRICK_NORMAL,
+    SPRITE_BRICK_MULTI,
+    SPRITE_BRICK_UNBREAKABLE,
+    SPRITE_BRICK_SPECIAL,
+    SPRITE_ID_COUNT
+} SpriteId;
+
+// Per-frame submission stats
+typedef struct {
+    int sprites;            // Quads queued
+    int draw_calls;         // SDL_RenderGeometry calls
+    int texture_switches;   // Atlas changes between draw calls
+} SpriteStats;
+
+// Load the game atlas (assets/sprites/game.bmp + game.atlas).
+// A missing atlas is not an error: sprites fall back to solid color quads.
+void sprite_init(Renderer* renderer);
+void sprite_cleanup(void);
+
+// Read the game atlas image ahead of sprite_init; needs no renderer, so it
+// can run on a startup worker. sprite_init then uploads it without reading
+// the file again. False if there is no atlas image.
+bool sprite_prefetch(void);
+
+// Load one atlas (<base>.bmp + <base>.atlas). Returns atlas index or -1.
+// Headless backends have no textures, so nothing is loaded for them.
+int sprite_atlas_load(Renderer* renderer, const char* base_path);
+
+// Handle for a well-known sprite (solid color handle if no atlas provides it)
+SpriteHandle sprite_get(SpriteId id);
+
+// Frame bookkeeping: resets counters, reports stats every SPRITE_REPORT_INTERVAL frames
+void sprite_frame_begin(void);
+
+// Queue a sprite; queued sprites are drawn by sprite_batch_flush
+void sprite_batch_add(SpriteHandle sprite, const SDL_Rect* dst, SDL_Color color);
+
+// Submit queued sprites sorted by atlas (draw order is kept within an atlas)
+void sprite_batch_flush(Renderer* renderer);
+
+// Stats for the last completed frame
+SpriteStats sprite_get_frame_stats(void);
+
+#endif // SPRITE_H
@@ -0,0 +1,155 @@
+#include "stage_prep.h"
+#include "log.h"
+#include <string.h>
+
+static SDL_Thread* s_thread = NULL;
+static SDL_mutex* s_lock = NULL;
+static SDL_cond* s_wake = NULL;
+static bool s_quit = false;
+
+// Request and result (guarded by s_lock)
+static int s_want_number = 0;
+static Uint32 s_want_seed = 0;
+static Uint32 s_want_revision = 0;
+static bool s_ready = false;
+static Stage s_ready_stage;
+
+// Game thread's view of the last request, so repeated requests skip the lock
+static int s_last_number = 0;
+static Uint32 s_last_seed = 0;
+static Uint32 s_last_revision = 0;
+
+// Worker only
+static Stage s_build_stage;
+static int s_build_scratch[STAGE_SCRATCH_INTS];
+
+static StagePrepStats s_stats;
+
+static int stage_prep_thread(void* unused) {
+    SDL_LockMutex(s_lock);
+    while (!s_quit) {
+        if (s_want_number == 0 || s_ready) {
+            SDL_CondWait(s_wake, s_lock);
+            continue;
+        }
+
+        int number = s_want_number;
+        Uint32 seed = s_want_seed;
+        Uint32 revision = s_want_revision;
+        SDL_UnlockMutex(s_lock);
+
+        Uint64 start = SDL_GetPerformanceCounter();
+        s_build_stage.seed = seed;
+        stage_build(&s_build_stage, number, s_build_scratch);
+        double us = (SDL_GetPerformanceCounter() - start) * 1000000.0 / SDL_GetPerformanceFrequency();
+
+        SDL_LockMutex(s_lock);
+        if (us > s_stats.build_max_us) {
+            s_stats.build_max_us = us;
+        }
+        // A newer request replaces this one: build again
+        if (s_want_number == number && s_want_seed == seed && s_want_revision == revision) {
+            s_ready_stage = s_build_stage;
+            s_ready = true;
+        }
+    }
+    SDL_UnlockMutex(s_lock);
+    return 0;
+}
+
+bool stage_prep_init(void) {
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_want_number = 0;
+    s_ready = false;
+    s_last_number = 0;
+    s_quit = false;
+
+    s_lock = SDL_CreateMutex();
+    s_wake = SDL_CreateCond();
+    s_thread = (s_lock && s_wake) ? SDL_CreateThread(stage_prep_thread, "stage_prep", NULL) : NULL;
+    if (!s_thread) {
+        LOG_WARN(LOG_CAT_GAME, "Stage preparation thread unavailable, loading stages synchronously\n");
+        return false;
+    }
+    return true;
+}
+
+void stage_prep_shutdown(void) {
+    if (s_thread) {
+        SDL_LockMutex(s_lock);
+        s_quit = true;
+        SDL_CondSignal(s_wake);
+        SDL_UnlockMutex(s_lock);
+        SDL_WaitThread(s_thread, NULL);
+        s_thread = NULL;
+    }
+    if (s_wake) {
+        SDL_DestroyCond(s_wake);
+        s_wake = NULL;
+    }
+    if (s_lock) {
+        SDL_DestroyMutex(s_lock);
+        s_lock = NULL;
+    }
+
+    if (s_stats.requests > 0) {
+        LOG_INFO(LOG_CAT_GAME, "Stage prep: %d requested, %d taken, %d built synchronously (%d stale); "
+                 "build max %.1f us\n",
+                 s_stats.requests, s_stats.taken, s_stats.misses, s_stats.stale, s_stats.build_max_us);
+    }
+}
+
+void stage_prep_request(int stage_number, Uint32 seed, Uint32 revision) {
+    if (!s_thread || (stage_number == s_last_number && seed == s_last_seed &&
+                      revision == s_last_revision)) {
+        return;
+    }
+    s_last_number = stage_number;
+    s_last_seed = seed;
+    s_last_revision = revision;
+
+    SDL_LockMutex(s_lock);
+    s_want_number = stage_number;
+    s_want_seed = seed;
+    s_want_revision = revision;
+    s_ready = false;
+    s_stats.requests++;
+    SDL_CondSignal(s_wake);
+    SDL_UnlockMutex(s_lock);
+}
+
+bool stage_prep_take(Stage* stage, int stage_number, Uint32 seed, Uint32 revision) {
+    if (!s_thread) {
+        return false;
+    }
+
+    bool taken = false;
+    SDL_LockMutex(s_lock);
+    bool stale = s_want_revision != revision;
+    if (s_ready && s_want_number == stage_number && s_want_seed == seed && !stale) {
+        Uint32 stage_revision = stage->revision;   // Keep it increasing for caches
+        *stage = s_ready_stage;
+        stage->revision = stage_revision + 1;
+        taken = true;
+    }
+    // Either way this stage is used up: don't keep building it
+    s_want_number = 0;
+    s_ready = false;
+    if (taken) {
+        s_stats.taken++;
+    } else {
+        s_stats.misses++;
+        s_stats.stale += stale;
+    }
+    SDL_UnlockMutex(s_lock);
+
+    s_last_number = 0;
+    return taken;
+}
+
+StagePrepStats stage_prep_get_stats(void) {
+    SDL_LockMutex(s_lock);
+    StagePrepStats stats = s_stats;
+    SDL_UnlockMutex(s_lock);
+    return stats;
+}
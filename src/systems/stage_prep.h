@@ -0,0 +1,44 @@
+#ifndef STAGE_PREP_H
+#define STAGE_PREP_H
+
+#include <stdbool.h>
+
+#if defined(__EMSCRIPTEN__) || defined(_WIN32)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+#include "../game/stage.h"
+
+// Next-stage preparation
+//
+// A worker thread builds the next stage (layout file or generator, bricks)
+// while the current one is played, so clearing a stage only copies the
+// finished Stage instead of loading it inside a fixed step. Without the
+// worker (or if it hasn't finished) stage_prep_take fails and the caller
+// builds the stage itself, so the result is the same either way. Requests
+// carry the stage file's watch revision (stage_watch_revision): a stage
+// whose file was edited after the request is thrown away and rebuilt.
+
+typedef struct {
+    int requests;               // Stages handed to the worker
+    int taken;                  // Transitions served from a prepared stage
+    int misses;                 // Transitions that had to build synchronously
+    int stale;                  // ...of those, because the file changed after the request
+    double build_max_us;        // Worst time the worker spent on one stage
+} StagePrepStats;
+
+bool stage_prep_init(void);
+void stage_prep_shutdown(void);
+
+// Start preparing a stage unless it's already prepared or in progress.
+// Cheap enough to call every tick.
+void stage_prep_request(int stage_number, Uint32 seed, Uint32 revision);
+
+// Copy the prepared stage into stage if it matches (revision included);
+// false if it isn't ready or is out of date
+bool stage_prep_take(Stage* stage, int stage_number, Uint32 seed, Uint32 revision);
+
+StagePrepStats stage_prep_get_stats(void);
+
+#endif // STAGE_PREP_H
@@ -0,0 +1,143 @@
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#define _POSIX_C_SOURCE 200809L     // read, close
+#include <sys/inotify.h>
+#include <unistd.h>
+#define STAGE_WATCH_INOTIFY 1
+#elif !defined(__EMSCRIPTEN__) && !defined(__vita__)
+#include <sys/stat.h>
+#include <time.h>
+#define STAGE_WATCH_STAT 1
+#endif
+
+#include "stage_watch.h"
+#include "log.h"
+#include <stdio.h>
+#include <string.h>
+
+static bool s_active = false;
+static Uint32 s_changed = 0;        // Bit per stage number with an unreported change
+static Uint32 s_revisions[STAGE_WATCH_MAX_STAGE + 1];
+static char s_dir[256];
+
+static void stage_watch_note(int stage_number) {
+    s_changed |= 1u << stage_number;
+    s_revisions[stage_number]++;
+}
+
+#ifdef STAGE_WATCH_INOTIFY
+static int s_fd = -1;
+
+static void stage_watch_read_events(void) {
+    // Aligned for struct inotify_event, room for a burst of editor saves
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    while (true) {
+        ssize_t length = read(s_fd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            return;     // EAGAIN: nothing pending
+        }
+        for (char* p = buffer; p < buffer + length; ) {
+            const struct inotify_event* event = (const struct inotify_event*)p;
+            int stage_number;
+            char extra;
+            if (event->len > 0 &&
+                sscanf(event->name, "stage%d.txt%c", &stage_number, &extra) == 1 &&
+                stage_number > 0 && stage_number <= STAGE_WATCH_MAX_STAGE) {
+                stage_watch_note(stage_number);
+            }
+            p += sizeof(struct inotify_event) + event->len;
+        }
+    }
+}
+#endif
+
+#ifdef STAGE_WATCH_STAT
+static time_t s_mtimes[STAGE_WATCH_MAX_STAGE + 1];
+static Uint32 s_next_poll = 0;
+
+static time_t stage_watch_mtime(int stage_number) {
+    char path[sizeof(s_dir) + 32];
+    snprintf(path, sizeof(path), "%s/stage%d.txt", s_dir, stage_number);
+    struct stat info;
+    return stat(path, &info) == 0 ? info.st_mtime : 0;
+}
+
+static void stage_watch_check(int stage_number) {
+    time_t mtime = stage_watch_mtime(stage_number);
+    if (mtime != s_mtimes[stage_number]) {
+        s_mtimes[stage_number] = mtime;
+        stage_watch_note(stage_number);
+    }
+}
+#endif
+
+bool stage_watch_init(const char* dir) {
+    snprintf(s_dir, sizeof(s_dir), "%s", dir);
+    s_changed = 0;
+    memset(s_revisions, 0, sizeof(s_revisions));
+
+#if defined(STAGE_WATCH_INOTIFY)
+    s_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    // Editors either rewrite the file or rename a temp file over it
+    if (s_fd < 0 || inotify_add_watch(s_fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        LOG_WARN(LOG_CAT_GAME, "Can't watch %s for stage changes\n", dir);
+        if (s_fd >= 0) {
+            close(s_fd);
+            s_fd = -1;
+        }
+        return false;
+    }
+#elif defined(STAGE_WATCH_STAT)
+    for (int i = 1; i <= STAGE_WATCH_MAX_STAGE; i++) {
+        s_mtimes[i] = stage_watch_mtime(i);
+    }
+    s_next_poll = SDL_GetTicks() + STAGE_WATCH_POLL_MS;
+#else
+    LOG_WARN(LOG_CAT_GAME, "Stage watching is not supported on this platform\n");
+    return false;
+#endif
+
+    s_active = true;
+    LOG_INFO(LOG_CAT_GAME, "Watching %s for stage changes\n", dir);
+    return true;
+}
+
+void stage_watch_shutdown(void) {
+#ifdef STAGE_WATCH_INOTIFY
+    if (s_fd >= 0) {
+        close(s_fd);
+        s_fd = -1;
+    }
+#endif
+    s_active = false;
+}
+
+bool stage_watch_poll(int stage_number) {
+    if (!s_active || stage_number <= 0 || stage_number > STAGE_WATCH_MAX_STAGE) {
+        return false;
+    }
+
+#if defined(STAGE_WATCH_INOTIFY)
+    stage_watch_read_events();
+#elif defined(STAGE_WATCH_STAT)
+    Uint32 now = SDL_GetTicks();
+    if ((Sint32)(now - s_next_poll) >= 0) {
+        s_next_poll = now + STAGE_WATCH_POLL_MS;
+        stage_watch_check(stage_number);
+        if (stage_number < STAGE_WATCH_MAX_STAGE) {
+            stage_watch_check(stage_number + 1);    // Prepared in the background
+        }
+    }
+#endif
+
+    Uint32 bit = 1u << stage_number;
+    bool changed = (s_changed & bit) != 0;
+    s_changed &= ~bit;
+    return changed;
+}
+
+Uint32 stage_watch_revision(int stage_number) {
+    if (!s_active || stage_number <= 0 || stage_number > STAGE_WATCH_MAX_STAGE) {
+        return 0;
+    }
+    return s_revisions[stage_number];
+}
@@ -0,0 +1,31 @@
+#ifndef STAGE_WATCH_H
+#define STAGE_WATCH_H
+
+#include <stdbool.h>
+
+#if defined(__EMSCRIPTEN__) || defined(_WIN32)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+
+// Watches the stage layout directory so edits show up while the game runs.
+// Linux uses inotify; other desktop platforms poll file modification times.
+
+#define STAGE_WATCH_POLL_MS 250     // Polling interval without inotify
+#define STAGE_WATCH_MAX_STAGE 31    // Highest stage number tracked
+
+bool stage_watch_init(const char* dir);
+void stage_watch_shutdown(void);
+
+// Non-blocking; true if stage_number's file changed since it was last reported.
+// Without inotify the files are only checked every STAGE_WATCH_POLL_MS: this
+// stage's and the next one's.
+bool stage_watch_poll(int stage_number);
+
+// Number of changes to stage_number's file seen by stage_watch_poll (no file
+// system access, cheap every tick); 0 when not watching. A stage built from
+// the file is current while this stays the same.
+Uint32 stage_watch_revision(int stage_number);
+
+#endif // STAGE_WATCH_H
@@ -0,0 +1,148 @@
+#include "startup.h"
+#include "metrics.h"
+#include "log.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    const char* name;
+    const char* thread;         // "main" or the job's name
+    Uint64 start;
+    Uint64 end;
+} StartupStep;
+
+typedef struct {
+    const char* name;
+    SDL_ThreadFunction fn;
+    void* data;
+    SDL_Thread* thread;         // NULL: runs inline on join
+    char wait_name[32];         // Main thread's step while joining
+    int result;
+    bool joined;
+} StartupJobSlot;
+
+static Uint64 s_start = 0;
+static Uint64 s_first_frame = 0;
+static SDL_atomic_t s_step_count;
+static StartupStep s_steps[STARTUP_MAX_STEPS];
+static StartupJobSlot s_jobs[STARTUP_MAX_JOBS];
+static int s_job_count = 0;
+static bool s_use_threads = true;
+
+static double startup_ms(Uint64 ticks) {
+    return ticks * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+static int startup_record(const char* name, const char* thread) {
+    int step = SDL_AtomicAdd(&s_step_count, 1);
+    if (step >= STARTUP_MAX_STEPS) {
+        return -1;
+    }
+    s_steps[step].name = name;
+    s_steps[step].thread = thread;
+    s_steps[step].start = SDL_GetPerformanceCounter();
+    s_steps[step].end = 0;
+    return step;
+}
+
+static int startup_job_thread(void* data) {
+    StartupJobSlot* job = (StartupJobSlot*)data;
+    int step = startup_record(job->name, job->name);
+    int result = job->fn(job->data);
+    startup_step_end(step);
+    return result;
+}
+
+void startup_begin(void) {
+    s_start = SDL_GetPerformanceCounter();
+    s_first_frame = 0;
+    SDL_AtomicSet(&s_step_count, 0);
+    s_job_count = 0;
+}
+
+int startup_step_begin(const char* name) {
+    return startup_record(name, "main");
+}
+
+void startup_step_end(int step) {
+    if (step >= 0) {
+        s_steps[step].end = SDL_GetPerformanceCounter();
+    }
+}
+
+void startup_use_threads(bool use_threads) {
+    s_use_threads = use_threads;
+}
+
+StartupJob startup_spawn(const char* name, SDL_ThreadFunction fn, void* data) {
+    if (s_job_count == STARTUP_MAX_JOBS) {
+        return -1;
+    }
+
+    StartupJobSlot* job = &s_jobs[s_job_count];
+    job->name = name;
+    job->fn = fn;
+    job->data = data;
+    job->result = 0;
+    job->joined = false;
+    snprintf(job->wait_name, sizeof(job->wait_name), "wait %s", name);
+    job->thread = s_use_threads ? SDL_CreateThread(startup_job_thread, name, job) : NULL;
+    return s_job_count++;
+}
+
+int startup_join(StartupJob job) {
+    if (job < 0 || job >= s_job_count) {
+        return 0;
+    }
+
+    StartupJobSlot* slot = &s_jobs[job];
+    if (!slot->joined) {
+        int step = startup_step_begin(slot->thread ? slot->wait_name : slot->name);
+        if (slot->thread) {
+            SDL_WaitThread(slot->thread, &slot->result);
+            slot->thread = NULL;
+        } else {
+            slot->result = slot->fn(slot->data);
+        }
+        startup_step_end(step);
+        slot->joined = true;
+    }
+    return slot->result;
+}
+
+void startup_first_frame(void) {
+    if (s_first_frame == 0) {
+        s_first_frame = SDL_GetPerformanceCounter();
+        METRICS_GAUGE("startup.first_frame_ms", startup_first_frame_ms());
+        LOG_INFO(LOG_CAT_SYSTEM, "Startup: first frame after %.1f ms\n", startup_first_frame_ms());
+    }
+}
+
+double startup_first_frame_ms(void) {
+    return s_first_frame ? startup_ms(s_first_frame - s_start) : 0.0;
+}
+
+void startup_finish(bool print_timeline) {
+    for (int i = 0; i < s_job_count; i++) {
+        startup_join(i);
+    }
+    Uint64 now = SDL_GetPerformanceCounter();
+
+    LOG_INFO(LOG_CAT_SYSTEM, "Startup: ready after %.1f ms\n", startup_ms(now - s_start));
+    if (!print_timeline) {
+        return;
+    }
+
+    int count = SDL_AtomicGet(&s_step_count);
+    if (count > STARTUP_MAX_STEPS) {
+        count = STARTUP_MAX_STEPS;
+    }
+    LOG_INFO(LOG_CAT_SYSTEM, "  %-20s %-8s %9s %9s %9s\n", "step", "thread", "start ms", "end ms", "ms");
+    for (int i = 0; i < count; i++) {
+        const StartupStep* step = &s_steps[i];
+        double start = startup_ms(step->start - s_start);
+        double end = step->end ? startup_ms(step->end - s_start) : start;
+        LOG_INFO(LOG_CAT_SYSTEM, "  %-20s %-8s %9.2f %9.2f %9.2f\n",
+                 step->name, step->thread, start, end, end - start);
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <stdbool.h>
+
+#if defined(__EMSCRIPTEN__) || defined(_WIN32)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+
+// Startup pipeline and timeline
+//
+// Startup steps are timed from the first line of main. Steps that don't need
+// the window (font loading, reading assets from storage) run as jobs on their
+// own threads while the main thread creates the window and renderer; the
+// main thread joins a job right before it needs the result. Without thread
+// support a job runs inline when it's joined, so the order of side effects
+// is the same either way.
+//
+// The timeline records every step with the thread it ran on; time to the
+// first presented frame is the number to track.
+
+#define STARTUP_MAX_STEPS 32
+#define STARTUP_MAX_JOBS 4
+
+typedef int StartupJob;
+
+// Start the clock (first thing in main)
+void startup_begin(void);
+
+// Time a step on the calling thread; step_end takes what step_begin returned
+int startup_step_begin(const char* name);
+void startup_step_end(int step);
+
+// Off: later jobs run inline when joined (devices with no core to spare)
+void startup_use_threads(bool use_threads);
+
+// Run fn(data) on a worker thread as a traced step; join returns its result
+StartupJob startup_spawn(const char* name, SDL_ThreadFunction fn, void* data);
+int startup_join(StartupJob job);
+
+// End of startup (just before the main loop), then the first presented
+// frame; each prints its time since startup_begin
+void startup_finish(bool print_timeline);
+void startup_first_frame(void);
+
+double startup_first_frame_ms(void);
+
+#endif // STARTUP_H
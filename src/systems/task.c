@@ -0,0 +1,248 @@
+#include "task.h"
+#include <string.h>
+
+#define TASK_NIL -1
+
+static TaskHandle task_make_handle(const TaskScheduler* sched, int index) {
+    return (sched->tasks[index].generation << TASK_INDEX_BITS) | (Uint32)index;
+}
+
+// Task index of a live task, -1 otherwise
+static int task_resolve(const TaskScheduler* sched, TaskHandle handle) {
+    int index = (int)(handle & (TASK_MAX - 1));
+    if (handle == TASK_NONE || !sched->tasks[index].alive ||
+        sched->tasks[index].generation != handle >> TASK_INDEX_BITS) {
+        return -1;
+    }
+    return index;
+}
+
+static void task_queue_reset(TaskQueue* queue) {
+    queue->head = TASK_NIL;
+    queue->tail = TASK_NIL;
+}
+
+static void task_enqueue(TaskScheduler* sched, TaskQueue* queue, int index) {
+    Task* task = &sched->tasks[index];
+    task->queue = queue;
+    task->prev = queue->tail;
+    task->next = TASK_NIL;
+    if (queue->tail != TASK_NIL) {
+        sched->tasks[queue->tail].next = index;
+    } else {
+        queue->head = index;
+    }
+    queue->tail = index;
+}
+
+static void task_unlink(TaskScheduler* sched, int index) {
+    Task* task = &sched->tasks[index];
+    TaskQueue* queue = task->queue;
+    if (task->prev != TASK_NIL) {
+        sched->tasks[task->prev].next = task->next;
+    } else {
+        queue->head = task->next;
+    }
+    if (task->next != TASK_NIL) {
+        sched->tasks[task->next].prev = task->prev;
+    } else {
+        queue->tail = task->prev;
+    }
+    task->queue = NULL;
+}
+
+// Move a whole queue into a local one (killing a task unlinks it from there)
+static void task_take_queue(TaskScheduler* sched, TaskQueue* from, TaskQueue* to) {
+    *to = *from;
+    task_queue_reset(from);
+    for (int index = to->head; index != TASK_NIL; index = sched->tasks[index].next) {
+        sched->tasks[index].queue = to;
+    }
+}
+
+// Back to the free list; the generation bump makes old handles stale
+static void task_release(TaskScheduler* sched, int index) {
+    Task* task = &sched->tasks[index];
+    task->alive = false;
+    if (task->generation == TASK_GENERATION_MAX) {
+        task->generation = 0;   // Wrapping would bring old handles back
+        sched->stats.retired++;
+    } else {
+        task->generation++;
+        task->next = sched->free_head;
+        sched->free_head = index;
+    }
+    sched->stats.active--;
+}
+
+static void task_wake(void* userdata, int index) {
+    TaskScheduler* sched = userdata;
+    sched->tasks[index].timer = TIMER_NONE;
+    task_enqueue(sched, &sched->ready, index);
+}
+
+// Run the task up to its next wait and file it where that wait says
+static void task_resume(TaskScheduler* sched, int index, int event, const void* data) {
+    Task* task = &sched->tasks[index];
+    task->event = event;
+    task->event_data = data;
+    sched->stats.resumed++;
+    TaskStatus status = task->fn(sched, task);
+    task->event = -1;
+    task->event_data = NULL;
+
+    if (!task->alive) {
+        task_release(sched, index);     // Killed while it ran
+        return;
+    }
+    switch (status) {
+        case TASK_FINISHED:
+            sched->stats.finished++;
+            task_release(sched, index);
+            break;
+        case TASK_YIELDED:
+            task_enqueue(sched, &sched->ready, index);
+            break;
+        case TASK_SLEEPING:
+            if (task->wait == 0) {
+                task_enqueue(sched, &sched->ready, index);
+            } else {
+                // Never refused while no wheel node has retired: the wheel has a
+                // timer for every task
+                task->timer = timer_wheel_schedule(&sched->wheel, task->wait, task_wake, sched, index);
+            }
+            break;
+        case TASK_WAITING:
+            task_enqueue(sched, &sched->waiting, index);
+            sched->waiting_mask |= task->wait;
+            break;
+    }
+}
+
+// Running tasks only lose their handle here; they are released when they return
+static void task_stop(TaskScheduler* sched, int index) {
+    Task* task = &sched->tasks[index];
+    sched->stats.killed++;
+    if (task->queue) {
+        task_unlink(sched, index);
+        task_release(sched, index);
+    } else if (task->timer != TIMER_NONE) {
+        timer_wheel_cancel(&sched->wheel, task->timer);
+        task->timer = TIMER_NONE;
+        task_release(sched, index);
+    } else {
+        task->alive = false;
+    }
+}
+
+void task_scheduler_init(TaskScheduler* sched) {
+    memset(sched, 0, sizeof(*sched));
+    timer_wheel_init(&sched->wheel);
+    task_queue_reset(&sched->ready);
+    task_queue_reset(&sched->waiting);
+    sched->free_head = TASK_NIL;
+    for (int i = TASK_MAX - 1; i >= 0; i--) {
+        sched->tasks[i].generation = 1;
+        sched->tasks[i].timer = TIMER_NONE;
+        sched->tasks[i].next = sched->free_head;
+        sched->free_head = i;
+    }
+}
+
+void task_scheduler_clear(TaskScheduler* sched) {
+    for (int i = 0; i < TASK_MAX; i++) {
+        if (sched->tasks[i].alive) {
+            task_stop(sched, i);
+        }
+    }
+    sched->waiting_mask = 0;
+}
+
+TaskHandle task_spawn(TaskScheduler* sched, TaskFn fn, void* userdata, int arg) {
+    if (sched->free_head == TASK_NIL) {
+        sched->stats.full++;
+        return TASK_NONE;
+    }
+    int index = sched->free_head;
+    Task* task = &sched->tasks[index];
+    sched->free_head = task->next;
+
+    task->fn = fn;
+    task->userdata = userdata;
+    task->arg = arg;
+    memset(task->locals, 0, sizeof(task->locals));
+    task->line = 0;
+    task->wait = 0;
+    task->event = -1;
+    task->event_data = NULL;
+    task->timer = TIMER_NONE;
+    task->alive = true;
+    task_enqueue(sched, &sched->ready, index);
+
+    sched->stats.spawned++;
+    if (++sched->stats.active > sched->stats.peak) {
+        sched->stats.peak = sched->stats.active;
+    }
+    return task_make_handle(sched, index);
+}
+
+bool task_kill(TaskScheduler* sched, TaskHandle handle) {
+    int index = task_resolve(sched, handle);
+    if (index < 0) {
+        return false;
+    }
+    task_stop(sched, index);
+    return true;
+}
+
+bool task_alive(const TaskScheduler* sched, TaskHandle handle) {
+    return task_resolve(sched, handle) >= 0;
+}
+
+TaskHandle task_handle(const TaskScheduler* sched, const Task* task) {
+    return task_make_handle(sched, (int)(task - sched->tasks));
+}
+
+void task_scheduler_tick(TaskScheduler* sched) {
+    // Sleepers due on this tick join the ready queue first
+    timer_wheel_tick(&sched->wheel);
+
+    // Tasks queued while these run (yields, spawns) wait for the next tick
+    TaskQueue run;
+    task_take_queue(sched, &sched->ready, &run);
+    while (run.head != TASK_NIL) {
+        int index = run.head;
+        task_unlink(sched, index);
+        task_resume(sched, index, -1, NULL);
+    }
+}
+
+// Walks every waiting task, but only for event types some task waits for
+void task_scheduler_notify(TaskScheduler* sched, int type, const void* data) {
+    if (type < 0 || type >= TASK_MAX_EVENT_TYPES) {
+        return;
+    }
+    Uint32 bit = 1u << type;
+    if (!(sched->waiting_mask & bit)) {
+        return;
+    }
+
+    // The rest go back (and tasks that wait again join) with a fresh mask
+    TaskQueue pending;
+    task_take_queue(sched, &sched->waiting, &pending);
+    sched->waiting_mask = 0;
+    while (pending.head != TASK_NIL) {
+        int index = pending.head;
+        task_unlink(sched, index);
+        if (sched->tasks[index].wait & bit) {
+            task_resume(sched, index, type, data);
+        } else {
+            task_enqueue(sched, &sched->waiting, index);
+            sched->waiting_mask |= sched->tasks[index].wait;
+        }
+    }
+}
+
+TaskStats task_scheduler_get_stats(const TaskScheduler* sched) {
+    return sched->stats;
+}
@@ -0,0 +1,146 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include <stdbool.h>
+#include "timer_wheel.h"
+
+#if defined(__EMSCRIPTEN__) || defined(_WIN32)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+
+// Cooperative task scheduler on fixed ticks
+//
+// A task is a stackless coroutine: a function that is called again from
+// the top every time the task resumes and jumps to where it left off with
+// the TASK_* macros below (a switch on the line it stopped at). Tasks wait
+// for a number of ticks, for the next tick, or for an event, and cost
+// nothing while they wait: sleepers sit on a timer wheel, event waiters on
+// a list that is only walked when an event someone waits for happens.
+//
+// C locals do not survive a wait; keep state in userdata, arg or locals.
+// Only one TASK_* wait per source line (the line number is the resume
+// point), and no waits inside a nested switch.
+//
+// Tasks live in a fixed pool; spawning and finishing never allocate.
+// Handles carry a generation like timer and entity handles: once a task has
+// finished or been killed its handle stops resolving. Generations never
+// wrap; a slot whose generation is used up (1M tasks) is retired.
+
+#define TASK_INDEX_BITS TIMER_WHEEL_INDEX_BITS
+#define TASK_MAX TIMER_WHEEL_MAX            // Concurrent tasks (every one can sleep at once)
+#define TASK_GENERATION_MAX ((1u << (32 - TASK_INDEX_BITS)) - 1)
+#define TASK_LOCALS 4                       // Ints kept across waits
+#define TASK_MAX_EVENT_TYPES 32
+#define TASK_NONE 0u
+
+typedef Uint32 TaskHandle;
+
+typedef enum {
+    TASK_FINISHED = 0,
+    TASK_YIELDED,               // Run again next tick
+    TASK_SLEEPING,              // Run again after task->wait ticks
+    TASK_WAITING                // Run again on an event in the task->wait mask
+} TaskStatus;
+
+// FIFO of task indices linked through the tasks themselves
+typedef struct {
+    int head;
+    int tail;
+} TaskQueue;
+
+typedef struct TaskScheduler TaskScheduler;
+typedef struct Task Task;
+
+typedef TaskStatus (*TaskFn)(TaskScheduler* sched, Task* task);
+
+struct Task {
+    TaskFn fn;
+    void* userdata;
+    int arg;
+    int locals[TASK_LOCALS];    // Zeroed on spawn
+    int line;                   // Resume point, 0 before the first run
+    Uint32 wait;                // Ticks or event mask, set by the wait macros
+    int event;                  // Event type that resumed the task, -1 otherwise
+    const void* event_data;     // Its payload, valid until the task waits again
+    TaskQueue* queue;           // Queue it is linked into, NULL while sleeping or running
+    int prev;
+    int next;                   // Doubles as the free list
+    TimerHandle timer;          // While sleeping
+    bool alive;                 // Spawned and not yet finished or killed
+    Uint32 generation;          // 0 once retired
+};
+
+typedef struct {
+    Uint64 spawned;
+    Uint64 finished;
+    Uint64 killed;
+    Uint64 resumed;
+    Uint64 full;                // Spawns refused: pool exhausted
+    int active;
+    int peak;
+    int retired;                // Slots whose generations ran out
+} TaskStats;
+
+struct TaskScheduler {
+    Task tasks[TASK_MAX];
+    int free_head;
+    TaskQueue ready;            // Runs on the next tick
+    TaskQueue waiting;          // Waiting for events
+    Uint32 waiting_mask;        // Union of the waiting tasks' masks
+    TimerWheel wheel;           // Sleeping tasks
+    TaskStats stats;
+};
+
+// Body of a task function:
+//
+//     TaskStatus blink(TaskScheduler* sched, Task* task) {
+//         Sprite* sprite = task->userdata;
+//         TASK_BEGIN(task);
+//         for (task->locals[0] = 0; task->locals[0] < 6; task->locals[0]++) {
+//             sprite->visible = !sprite->visible;
+//             TASK_WAIT_TICKS(task, 10);
+//         }
+//         TASK_END(task);
+//     }
+#define TASK_BEGIN(task) switch ((task)->line) { case 0:
+#define TASK_END(task) } (task)->line = -1; return TASK_FINISHED
+
+#define TASK_EXIT(task) do { (task)->line = -1; return TASK_FINISHED; } while (0)
+
+#define TASK_YIELD(task) \
+    do { (task)->line = __LINE__; return TASK_YIELDED; case __LINE__:; } while (0)
+
+// Resume ticks later (0 behaves like TASK_YIELD)
+#define TASK_WAIT_TICKS(task, ticks) \
+    do { (task)->wait = (Uint32)(ticks); (task)->line = __LINE__; return TASK_SLEEPING; \
+         case __LINE__:; } while (0)
+
+// Resume on the next task_scheduler_notify with a type in mask (bit per type)
+#define TASK_WAIT_EVENT(task, mask) \
+    do { (task)->wait = (Uint32)(mask); (task)->line = __LINE__; return TASK_WAITING; \
+         case __LINE__:; } while (0)
+
+void task_scheduler_init(TaskScheduler* sched);
+void task_scheduler_clear(TaskScheduler* sched);    // Kills everything
+
+// New task, first run on the next tick; TASK_NONE when the pool is exhausted
+TaskHandle task_spawn(TaskScheduler* sched, TaskFn fn, void* userdata, int arg);
+
+// False if the task already finished or was killed; a task may kill itself
+bool task_kill(TaskScheduler* sched, TaskHandle handle);
+bool task_alive(const TaskScheduler* sched, TaskHandle handle);
+TaskHandle task_handle(const TaskScheduler* sched, const Task* task);
+
+// Move time forward one tick: wake sleepers that are due, then run every
+// task that yielded, woke or was spawned since the last tick
+void task_scheduler_tick(TaskScheduler* sched);
+
+// Event type (0 .. TASK_MAX_EVENT_TYPES - 1) happened: resume the tasks
+// waiting for it right away, in the order they started waiting
+void task_scheduler_notify(TaskScheduler* sched, int type, const void* data);
+
+TaskStats task_scheduler_get_stats(const TaskScheduler* sched);
+
+#endif // TASK_H
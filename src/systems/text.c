@@ -1,14 +1,31 @@
 #include "text.h"
-#include <stdio.h>
+#include "log.h"
+#include "texture_cache.h"
+#include <stdint.h>
 
 #define SCREEN_WIDTH 960
 
+static void text_close_fonts(TextRenderer* text_renderer) {
+    if (text_renderer->font_large) {
+        TTF_CloseFont(text_renderer->font_large);
+        text_renderer->font_large = NULL;
+    }
+    if (text_renderer->font_medium) {
+        TTF_CloseFont(text_renderer->font_medium);
+        text_renderer->font_medium = NULL;
+    }
+    if (text_renderer->font_small) {
+        TTF_CloseFont(text_renderer->font_small);
+        text_renderer->font_small = NULL;
+    }
+}
+
 // Initialize text rendering system
-bool text_init(TextRenderer* text_renderer, SDL_Renderer* renderer) {
+bool text_init(TextRenderer* text_renderer, Renderer* renderer) {
     text_renderer->renderer = renderer;
 
     if (TTF_Init() == -1) {
-        printf("TTF_Init failed: %s\n", TTF_GetError());
+        LOG_ERROR(LOG_CAT_RENDER, "TTF_Init failed: %s\n", TTF_GetError());
         return false;
     }
 
@@ -22,99 +39,119 @@ bool text_init(TextRenderer* text_renderer, SDL_Renderer* renderer) {
         NULL
     };
 
-    TTF_Font* test_font = NULL;
+    // Each size is parsed once; a file TTF can't read falls through to the next path
     const char* loaded_path = NULL;
 
-    for (int i = 0; font_paths[i] != NULL; i++) {
-        test_font = TTF_OpenFont(font_paths[i], 24);
-        if (test_font) {
+    for (int i = 0; font_paths[i] != NULL && !loaded_path; i++) {
+        SDL_RWops* file = SDL_RWFromFile(font_paths[i], "rb");
+        if (!file) {
+            continue;
+        }
+        SDL_RWclose(file);
+
+        text_renderer->font_large = TTF_OpenFont(font_paths[i], 60);
+        text_renderer->font_medium = TTF_OpenFont(font_paths[i], 40);
+        text_renderer->font_small = TTF_OpenFont(font_paths[i], 24);
+        if (text_renderer->font_large && text_renderer->font_medium && text_renderer->font_small) {
             loaded_path = font_paths[i];
-            TTF_CloseFont(test_font);
-            break;
+        } else {
+            LOG_WARN(LOG_CAT_RENDER, "Failed to load font %s: %s\n", font_paths[i], TTF_GetError());
+            text_close_fonts(text_renderer);
         }
     }
 
     if (!loaded_path) {
-        printf("Warning: No font file found. Text rendering will not work.\n");
-        printf("Please add a TrueType font to assets/fonts/font.ttf\n");
-        text_renderer->font_large = NULL;
-        text_renderer->font_medium = NULL;
-        text_renderer->font_small = NULL;
+        LOG_WARN(LOG_CAT_RENDER, "No usable font file found. Text rendering will not work.\n");
+        LOG_WARN(LOG_CAT_RENDER, "Please add a TrueType font to assets/fonts/font.ttf\n");
         return false;
     }
 
-    // Load fonts at different sizes
-    text_renderer->font_large = TTF_OpenFont(loaded_path, 60);
-    text_renderer->font_medium = TTF_OpenFont(loaded_path, 40);
-    text_renderer->font_small = TTF_OpenFont(loaded_path, 24);
-
-    if (!text_renderer->font_large || !text_renderer->font_medium || !text_renderer->font_small) {
-        printf("Failed to load fonts: %s\n", TTF_GetError());
-        text_cleanup(text_renderer);
-        return false;
-    }
-
-    printf("Text rendering initialized with font: %s\n", loaded_path);
+    LOG_INFO(LOG_CAT_RENDER, "Text rendering initialized with font: %s\n", loaded_path);
     return true;
 }
 
 // Cleanup text rendering system
 void text_cleanup(TextRenderer* text_renderer) {
-    if (text_renderer->font_large) {
-        TTF_CloseFont(text_renderer->font_large);
-        text_renderer->font_large = NULL;
-    }
-    if (text_renderer->font_medium) {
-        TTF_CloseFont(text_renderer->font_medium);
-        text_renderer->font_medium = NULL;
+    text_close_fonts(text_renderer);
+    TTF_Quit();
+}
+
+typedef struct {
+    TTF_Font* font;
+    const char* text;
+    SDL_Color color;
+} TextLoad;
+
+static SDL_Surface* text_load_surface(void* userdata) {
+    const TextLoad* load = (const TextLoad*)userdata;
+    SDL_Surface* surface = TTF_RenderText_Blended(load->font, load->text, load->color);
+    if (!surface) {
+        LOG_WARN(LOG_CAT_RENDER, "Failed to render text surface: %s\n", TTF_GetError());
     }
-    if (text_renderer->font_small) {
-        TTF_CloseFont(text_renderer->font_small);
-        text_renderer->font_small = NULL;
+    return surface;
+}
+
+// Same string, font and color share one cached texture
+static Uint64 text_key(const char* text, TTF_Font* font, SDL_Color color) {
+    Uint64 salt = (Uint64)(uintptr_t)font ^
+                  ((Uint64)(color.r | color.g << 8 | color.b << 16 | (Uint32)color.a << 24) << 32);
+    return texture_cache_key(text, salt);
+}
+
+// Draw the cached texture for text with its top-left at x, or centered on the screen
+static void text_draw(TextRenderer* text_renderer, const char* text, int x, int y, bool centered,
+                      TTF_Font* font, SDL_Color color) {
+    TextLoad load = {font, text, color};
+    Uint64 key = text_key(text, font, color);
+    int width, height;
+    SDL_Texture* texture = texture_cache_acquire(key, text_load_surface, &load, &width, &height);
+    if (!texture) {
+        return;
     }
-    TTF_Quit();
+
+    SDL_Rect dest = {centered ? (SCREEN_WIDTH - width) / 2 : x, y, width, height};
+    render_copy(text_renderer->renderer, texture, NULL, &dest);
+
+    // The renderer is done with it once queued; the cache keeps it for next frame
+    texture_cache_release(key);
 }
 
 // Render text at position (left-aligned)
 void text_render(TextRenderer* text_renderer, const char* text, int x, int y, TTF_Font* font, SDL_Color color) {
-    if (!font || !text || !text[0]) {
+    if (!text || !text[0]) {
         return;
     }
 
-    SDL_Surface* surface = TTF_RenderText_Blended(font, text, color);
-    if (!surface) {
-        printf("Failed to render text surface: %s\n", TTF_GetError());
+    // Headless backends only record the draw, independent of installed fonts
+    if (!text_renderer->renderer->sdl) {
+        render_text(text_renderer->renderer, text, x, y);
         return;
     }
 
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(text_renderer->renderer, surface);
-    if (!texture) {
-        printf("Failed to create text texture: %s\n", SDL_GetError());
-        SDL_FreeSurface(surface);
+    if (!font) {
         return;
     }
 
-    SDL_Rect dest = {x, y, surface->w, surface->h};
-    SDL_RenderCopy(text_renderer->renderer, texture, NULL, &dest);
-
-    SDL_DestroyTexture(texture);
-    SDL_FreeSurface(surface);
+    text_draw(text_renderer, text, x, y, false, font, color);
 }
 
 // Render text centered horizontally at y position
 void text_render_centered(TextRenderer* text_renderer, const char* text, int y, TTF_Font* font, SDL_Color color) {
-    if (!font || !text || !text[0]) {
+    if (!text || !text[0]) {
+        return;
+    }
+
+    if (!text_renderer->renderer->sdl) {
+        render_text(text_renderer->renderer, text, SCREEN_WIDTH / 2, y);
         return;
     }
 
-    int text_width, text_height;
-    if (TTF_SizeText(font, text, &text_width, &text_height) != 0) {
-        printf("Failed to get text size: %s\n", TTF_GetError());
+    if (!font) {
         return;
     }
 
-    int x = (SCREEN_WIDTH - text_width) / 2;
-    text_render(text_renderer, text, x, y, font, color);
+    // The cached texture's width replaces a TTF_SizeText call per frame
+    text_draw(text_renderer, text, 0, y, true, font, color);
 }
 
 // Get font by size
@@ -10,17 +10,18 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #endif
+#include "render.h"
 
 // Text rendering system
 typedef struct {
     TTF_Font* font_large;   // For titles (60pt)
     TTF_Font* font_medium;  // For menu items (40pt)
     TTF_Font* font_small;   // For HUD/UI (24pt)
-    SDL_Renderer* renderer;
+    Renderer* renderer;
 } TextRenderer;
 
 // Initialize text rendering system
-bool text_init(TextRenderer* text_renderer, SDL_Renderer* renderer);
+bool text_init(TextRenderer* text_renderer, Renderer* renderer);
 
 // Cleanup text rendering system
 void text_cleanup(TextRenderer* text_renderer);
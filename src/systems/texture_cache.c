@@ -0,0 +1,213 @@
+#include "texture_cache.h"
+#include "metrics.h"
+#include "log.h"
+#include <string.h>
+
+#define TEXTURE_NONE -1
+
+typedef struct {
+    Uint64 key;
+    SDL_Texture* texture;       // NULL when the slot is free
+    int width;
+    int height;
+    size_t bytes;
+    int refs;
+    int newer;                  // LRU list neighbours (slot indices)
+    int older;
+} TextureEntry;
+
+static TextureEntry s_entries[TEXTURE_CACHE_MAX_ENTRIES];
+static int s_newest = TEXTURE_NONE;
+static int s_oldest = TEXTURE_NONE;
+static Renderer* s_renderer = NULL;
+static TextureCacheStats s_stats;
+
+static void texture_cache_unlink(int index) {
+    TextureEntry* entry = &s_entries[index];
+    if (entry->newer != TEXTURE_NONE) {
+        s_entries[entry->newer].older = entry->older;
+    } else {
+        s_newest = entry->older;
+    }
+    if (entry->older != TEXTURE_NONE) {
+        s_entries[entry->older].newer = entry->newer;
+    } else {
+        s_oldest = entry->newer;
+    }
+}
+
+static void texture_cache_push_newest(int index) {
+    TextureEntry* entry = &s_entries[index];
+    entry->newer = TEXTURE_NONE;
+    entry->older = s_newest;
+    if (s_newest != TEXTURE_NONE) {
+        s_entries[s_newest].newer = index;
+    } else {
+        s_oldest = index;
+    }
+    s_newest = index;
+}
+
+static void texture_cache_destroy(int index) {
+    TextureEntry* entry = &s_entries[index];
+    texture_cache_unlink(index);
+    SDL_DestroyTexture(entry->texture);
+    s_stats.bytes -= entry->bytes;
+    s_stats.entries--;
+    memset(entry, 0, sizeof(*entry));
+}
+
+// Evict unreferenced entries, oldest first, until bytes fit (and a slot is free)
+static void texture_cache_make_room(size_t bytes) {
+    int index = s_oldest;
+    while (index != TEXTURE_NONE &&
+           (s_stats.bytes + bytes > s_stats.budget || s_stats.entries == TEXTURE_CACHE_MAX_ENTRIES)) {
+        int newer = s_entries[index].newer;
+        if (s_entries[index].refs == 0) {
+            texture_cache_destroy(index);
+            s_stats.evictions++;
+            METRICS_COUNT("texture.evictions", 1);
+        }
+        index = newer;
+    }
+}
+
+static int texture_cache_find(Uint64 key) {
+    for (int i = 0; i < TEXTURE_CACHE_MAX_ENTRIES; i++) {
+        if (s_entries[i].texture && s_entries[i].key == key) {
+            return i;
+        }
+    }
+    return TEXTURE_NONE;
+}
+
+static int texture_cache_free_slot(void) {
+    for (int i = 0; i < TEXTURE_CACHE_MAX_ENTRIES; i++) {
+        if (!s_entries[i].texture) {
+            return i;
+        }
+    }
+    return TEXTURE_NONE;
+}
+
+bool texture_cache_init(Renderer* renderer, size_t budget_bytes) {
+    s_renderer = renderer;
+    memset(s_entries, 0, sizeof(s_entries));
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stats.budget = budget_bytes;
+    s_newest = TEXTURE_NONE;
+    s_oldest = TEXTURE_NONE;
+    return true;
+}
+
+void texture_cache_shutdown(void) {
+    if (s_stats.misses > 0) {
+        LOG_INFO(LOG_CAT_RENDER, "Textures: %d uploads, %d hits, %d evictions; peak %.1f of %.1f MB\n",
+                 s_stats.misses, s_stats.hits, s_stats.evictions,
+                 s_stats.peak_bytes / 1048576.0, s_stats.budget / 1048576.0);
+    }
+    if (s_stats.full > 0 || s_stats.failed > 0) {
+        LOG_WARN(LOG_CAT_RENDER, "Textures: %d refused (cache full), %d failed to create\n",
+                 s_stats.full, s_stats.failed);
+    }
+    while (s_newest != TEXTURE_NONE) {
+        texture_cache_destroy(s_newest);
+    }
+    s_renderer = NULL;
+}
+
+SDL_Texture* texture_cache_acquire(Uint64 key, TextureLoadFn load, void* userdata,
+                                   int* width, int* height) {
+    if (!s_renderer || !s_renderer->sdl) {
+        return NULL;
+    }
+
+    int index = texture_cache_find(key);
+    if (index != TEXTURE_NONE) {
+        s_stats.hits++;
+        texture_cache_unlink(index);
+        texture_cache_push_newest(index);
+    } else {
+        SDL_Surface* surface = load(userdata);
+        if (!surface) {
+            return NULL;
+        }
+
+        size_t bytes = (size_t)surface->w * surface->h * TEXTURE_CACHE_BYTES_PER_PIXEL;
+        texture_cache_make_room(bytes);
+        if (s_stats.entries == TEXTURE_CACHE_MAX_ENTRIES) {
+            // Once: this repeats every frame until something is released
+            if (s_stats.full++ == 0) {
+                LOG_WARN(LOG_CAT_RENDER, "Texture cache full, all %d entries referenced\n",
+                         TEXTURE_CACHE_MAX_ENTRIES);
+            }
+            SDL_FreeSurface(surface);
+            return NULL;
+        }
+        if (s_stats.bytes + bytes > s_stats.budget) {
+            s_stats.over_budget++;  // Everything left is in use; draw anyway
+        }
+
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(s_renderer->sdl, surface);
+        int w = surface->w;
+        int h = surface->h;
+        SDL_FreeSurface(surface);
+        if (!texture) {
+            if (s_stats.failed++ == 0) {
+                LOG_WARN(LOG_CAT_RENDER, "Failed to create texture: %s\n", SDL_GetError());
+            }
+            return NULL;
+        }
+
+        index = texture_cache_free_slot();
+        TextureEntry* entry = &s_entries[index];
+        entry->key = key;
+        entry->texture = texture;
+        entry->width = w;
+        entry->height = h;
+        entry->bytes = bytes;
+        entry->refs = 0;
+        texture_cache_push_newest(index);
+
+        s_stats.misses++;
+        s_stats.entries++;
+        s_stats.bytes += bytes;
+        if (s_stats.bytes > s_stats.peak_bytes) {
+            s_stats.peak_bytes = s_stats.bytes;
+        }
+        METRICS_COUNT("texture.uploads", 1);
+        METRICS_GAUGE("texture.bytes", (double)s_stats.bytes);
+    }
+
+    TextureEntry* entry = &s_entries[index];
+    entry->refs++;
+    if (width) *width = entry->width;
+    if (height) *height = entry->height;
+    return entry->texture;
+}
+
+void texture_cache_release(Uint64 key) {
+    int index = texture_cache_find(key);
+    if (index != TEXTURE_NONE && s_entries[index].refs > 0) {
+        s_entries[index].refs--;
+    }
+}
+
+Uint64 texture_cache_key(const char* text, Uint64 salt) {
+    Uint64 hash = 14695981039346656037ull ^ salt;
+    for (const char* p = text; *p; p++) {
+        hash = (hash ^ (Uint8)*p) * 1099511628211ull;
+    }
+    return hash;
+}
+
+TextureCacheStats texture_cache_get_stats(void) {
+    TextureCacheStats stats = s_stats;
+    stats.referenced = 0;
+    for (int i = 0; i < TEXTURE_CACHE_MAX_ENTRIES; i++) {
+        if (s_entries[i].texture && s_entries[i].refs > 0) {
+            stats.referenced++;
+        }
+    }
+    return stats;
+}
@@ -0,0 +1,58 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#if defined(__EMSCRIPTEN__) || defined(_WIN32)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+#include "render.h"
+
+// Texture cache
+//
+// Owns every texture the game creates. Textures are keyed by a 64-bit id
+// (asset path or content hash) and reference counted: acquire returns the
+// cached texture or uploads it through the caller's loader, release drops
+// the reference. Unreferenced textures stay cached until the byte budget
+// needs their space, oldest first, so text that is drawn every frame is
+// uploaded once instead of once per frame.
+
+#define TEXTURE_CACHE_MAX_ENTRIES 256
+#define TEXTURE_CACHE_BUDGET_MB 16          // Default budget; --texture-budget=<MB>
+#define TEXTURE_CACHE_BYTES_PER_PIXEL 4     // Estimate for budget accounting
+
+typedef struct {
+    int hits;
+    int misses;                 // Each miss is an upload
+    int evictions;
+    int entries;
+    int referenced;             // Entries with at least one reference
+    size_t bytes;
+    size_t peak_bytes;
+    size_t budget;
+    int over_budget;            // Uploads that couldn't fit even after evicting
+    int full;                   // Acquires refused: every entry referenced
+    int failed;                 // Textures SDL couldn't create
+} TextureCacheStats;
+
+// Build the surface for a missing texture (the cache frees it)
+typedef SDL_Surface* (*TextureLoadFn)(void* userdata);
+
+bool texture_cache_init(Renderer* renderer, size_t budget_bytes);
+void texture_cache_shutdown(void);      // Destroys everything, referenced or not
+
+// Returns the texture with a new reference, or NULL if it can't be loaded.
+// width/height may be NULL.
+SDL_Texture* texture_cache_acquire(Uint64 key, TextureLoadFn load, void* userdata,
+                                   int* width, int* height);
+void texture_cache_release(Uint64 key);
+
+// Keys: FNV-1a of a string, mixed with a salt (e.g. font and color)
+Uint64 texture_cache_key(const char* text, Uint64 salt);
+
+TextureCacheStats texture_cache_get_stats(void);
+
+#endif // TEXTURE_CACHE_H
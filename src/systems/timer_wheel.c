@@ -0,0 +1,200 @@
+#include "timer_wheel.h"
+#include <string.h>
+
+#define TIMER_NIL -1
+#define TIMER_L1_BASE TIMER_WHEEL_L0_SIZE
+#define TIMER_L2_BASE (TIMER_WHEEL_L0_SIZE + TIMER_WHEEL_LN_SIZE)
+#define TIMER_L1_SHIFT TIMER_WHEEL_L0_BITS
+#define TIMER_L2_SHIFT (TIMER_WHEEL_L0_BITS + TIMER_WHEEL_LN_BITS)
+
+static TimerHandle timer_make_handle(const TimerWheel* wheel, int index) {
+    return (wheel->nodes[index].generation << TIMER_WHEEL_INDEX_BITS) | (Uint32)index;
+}
+
+// Node index of a pending timer, -1 otherwise
+static int timer_resolve(const TimerWheel* wheel, TimerHandle handle) {
+    int index = (int)(handle & (TIMER_WHEEL_MAX - 1));
+    if (handle == TIMER_NONE || wheel->nodes[index].bucket < 0 ||
+        wheel->nodes[index].generation != handle >> TIMER_WHEEL_INDEX_BITS) {
+        return -1;
+    }
+    return index;
+}
+
+// Finest level whose span still reaches the due tick
+static int timer_bucket(const TimerWheel* wheel, Uint32 due) {
+    Uint32 delta = due - wheel->now;
+    if (delta < (1u << TIMER_L1_SHIFT)) {
+        return (int)(due & (TIMER_WHEEL_L0_SIZE - 1));
+    }
+    if (delta < (1u << TIMER_L2_SHIFT)) {
+        return TIMER_L1_BASE + (int)((due >> TIMER_L1_SHIFT) & (TIMER_WHEEL_LN_SIZE - 1));
+    }
+    return TIMER_L2_BASE + (int)((due >> TIMER_L2_SHIFT) & (TIMER_WHEEL_LN_SIZE - 1));
+}
+
+static void timer_link(TimerWheel* wheel, int index, int bucket) {
+    TimerNode* node = &wheel->nodes[index];
+    node->bucket = bucket;
+    node->prev = TIMER_NIL;
+    node->next = wheel->heads[bucket];
+    if (node->next != TIMER_NIL) {
+        wheel->nodes[node->next].prev = index;
+    }
+    wheel->heads[bucket] = index;
+}
+
+static void timer_unlink(TimerWheel* wheel, int index) {
+    TimerNode* node = &wheel->nodes[index];
+    if (node->prev != TIMER_NIL) {
+        wheel->nodes[node->prev].next = node->next;
+    } else {
+        wheel->heads[node->bucket] = node->next;
+    }
+    if (node->next != TIMER_NIL) {
+        wheel->nodes[node->next].prev = node->prev;
+    }
+}
+
+// The generation bump makes old handles stale; false if the node is retired
+static bool timer_bump_generation(TimerWheel* wheel, TimerNode* node) {
+    if (node->generation == TIMER_WHEEL_GENERATION_MAX) {
+        node->generation = 0;   // Wrapping would bring old handles back
+        wheel->stats.retired++;
+        return false;
+    }
+    node->generation++;
+    return true;
+}
+
+// Back to the free list
+static void timer_release(TimerWheel* wheel, int index) {
+    TimerNode* node = &wheel->nodes[index];
+    node->bucket = -1;
+    if (timer_bump_generation(wheel, node)) {
+        node->next = wheel->free_head;
+        wheel->free_head = index;
+    }
+    wheel->stats.active--;
+}
+
+// Re-file a coarse bucket's timers now that they are closer
+static void timer_cascade(TimerWheel* wheel, int bucket) {
+    int index = wheel->heads[bucket];
+    wheel->heads[bucket] = TIMER_NIL;
+    while (index != TIMER_NIL) {
+        int next = wheel->nodes[index].next;
+        timer_link(wheel, index, timer_bucket(wheel, wheel->nodes[index].due));
+        wheel->stats.cascaded++;
+        index = next;
+    }
+}
+
+void timer_wheel_init(TimerWheel* wheel) {
+    memset(wheel, 0, sizeof(*wheel));
+    for (int i = 0; i < TIMER_WHEEL_MAX; i++) {
+        wheel->nodes[i].generation = 1;
+        wheel->nodes[i].bucket = -1;
+    }
+    timer_wheel_clear(wheel);
+}
+
+void timer_wheel_clear(TimerWheel* wheel) {
+    for (int i = 0; i < TIMER_WHEEL_BUCKETS; i++) {
+        wheel->heads[i] = TIMER_NIL;
+    }
+    wheel->free_head = TIMER_NIL;
+    for (int i = TIMER_WHEEL_MAX - 1; i >= 0; i--) {
+        TimerNode* node = &wheel->nodes[i];
+        if (node->bucket >= 0) {
+            node->bucket = -1;
+            timer_bump_generation(wheel, node);
+            wheel->stats.cancelled++;
+        }
+        if (node->generation != 0) {
+            node->next = wheel->free_head;
+            wheel->free_head = i;
+        }
+    }
+    wheel->stats.active = 0;
+}
+
+TimerHandle timer_wheel_schedule(TimerWheel* wheel, Uint32 delay, TimerFn fn, void* userdata, int arg) {
+    if (wheel->free_head == TIMER_NIL) {
+        wheel->stats.full++;
+        return TIMER_NONE;
+    }
+    if (delay < 1) {
+        delay = 1;
+    } else if (delay > TIMER_WHEEL_MAX_DELAY) {
+        delay = TIMER_WHEEL_MAX_DELAY;
+    }
+
+    int index = wheel->free_head;
+    TimerNode* node = &wheel->nodes[index];
+    wheel->free_head = node->next;
+    node->due = wheel->now + delay;
+    node->fn = fn;
+    node->userdata = userdata;
+    node->arg = arg;
+    timer_link(wheel, index, timer_bucket(wheel, node->due));
+
+    wheel->stats.scheduled++;
+    if (++wheel->stats.active > wheel->stats.peak) {
+        wheel->stats.peak = wheel->stats.active;
+    }
+    return timer_make_handle(wheel, index);
+}
+
+bool timer_wheel_cancel(TimerWheel* wheel, TimerHandle handle) {
+    int index = timer_resolve(wheel, handle);
+    if (index < 0) {
+        return false;
+    }
+    timer_unlink(wheel, index);
+    timer_release(wheel, index);
+    wheel->stats.cancelled++;
+    return true;
+}
+
+bool timer_wheel_pending(const TimerWheel* wheel, TimerHandle handle) {
+    return timer_resolve(wheel, handle) >= 0;
+}
+
+Uint32 timer_wheel_remaining(const TimerWheel* wheel, TimerHandle handle) {
+    int index = timer_resolve(wheel, handle);
+    return index >= 0 ? wheel->nodes[index].due - wheel->now : 0;
+}
+
+void timer_wheel_tick(TimerWheel* wheel) {
+    wheel->now++;
+
+    // Every 256 ticks the next coarse bucket moves down (the top level first,
+    // so its timers can continue straight into the level below)
+    if ((wheel->now & (TIMER_WHEEL_L0_SIZE - 1)) == 0) {
+        Uint32 l1 = (wheel->now >> TIMER_L1_SHIFT) & (TIMER_WHEEL_LN_SIZE - 1);
+        if (l1 == 0) {
+            timer_cascade(wheel, TIMER_L2_BASE + (int)((wheel->now >> TIMER_L2_SHIFT) & (TIMER_WHEEL_LN_SIZE - 1)));
+        }
+        timer_cascade(wheel, TIMER_L1_BASE + (int)l1);
+    }
+
+    // Callbacks may schedule (never into this bucket) or cancel timers
+    int bucket = (int)(wheel->now & (TIMER_WHEEL_L0_SIZE - 1));
+    while (wheel->heads[bucket] != TIMER_NIL) {
+        int index = wheel->heads[bucket];
+        TimerNode* node = &wheel->nodes[index];
+        TimerFn fn = node->fn;
+        void* userdata = node->userdata;
+        int arg = node->arg;
+
+        timer_unlink(wheel, index);
+        timer_release(wheel, index);
+        wheel->stats.fired++;
+        fn(userdata, arg);
+    }
+}
+
+TimerWheelStats timer_wheel_get_stats(const TimerWheel* wheel) {
+    return wheel->stats;
+}
@@ -0,0 +1,89 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdbool.h>
+
+#if defined(__EMSCRIPTEN__) || defined(_WIN32)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+
+// Hierarchical timer wheel on fixed ticks
+//
+// Timers due within 256 ticks sit in a bucket per tick; later ones sit in
+// coarser buckets of 256 and 16384 ticks and move down a level when their
+// bucket comes up. Scheduling and cancelling are O(1), and advancing one
+// tick touches only the timers that fire (plus a cascade every 256 ticks
+// that moves each timer at most twice in its life), no matter how many
+// are pending. Timers live in a fixed pool; nothing is allocated.
+//
+// Handles carry a generation like entity handles: once a timer has fired
+// or been cancelled its handle stops resolving. Generations never wrap; a
+// node whose generation is used up (1M timers) is retired.
+
+#define TIMER_WHEEL_INDEX_BITS 12
+#define TIMER_WHEEL_MAX (1 << TIMER_WHEEL_INDEX_BITS)  // Concurrent timers
+#define TIMER_WHEEL_GENERATION_MAX ((1u << (32 - TIMER_WHEEL_INDEX_BITS)) - 1)
+#define TIMER_WHEEL_L0_BITS 8               // 256 one-tick buckets
+#define TIMER_WHEEL_LN_BITS 6               // 64 buckets in each coarser level
+#define TIMER_WHEEL_MAX_DELAY ((1u << (TIMER_WHEEL_L0_BITS + 2 * TIMER_WHEEL_LN_BITS)) - 1)
+#define TIMER_NONE 0u
+
+#define TIMER_WHEEL_L0_SIZE (1 << TIMER_WHEEL_L0_BITS)
+#define TIMER_WHEEL_LN_SIZE (1 << TIMER_WHEEL_LN_BITS)
+#define TIMER_WHEEL_BUCKETS (TIMER_WHEEL_L0_SIZE + 2 * TIMER_WHEEL_LN_SIZE)
+
+typedef Uint32 TimerHandle;
+
+// Runs when the timer fires; the timer is already gone (its handle is stale)
+typedef void (*TimerFn)(void* userdata, int arg);
+
+typedef struct {
+    Uint32 due;                 // Tick it fires on
+    TimerFn fn;
+    void* userdata;
+    int arg;
+    int prev;                   // Bucket list neighbours; next doubles as the free list
+    int next;
+    int bucket;                 // -1 while free
+    Uint32 generation;          // 0 once retired
+} TimerNode;
+
+typedef struct {
+    Uint64 scheduled;
+    Uint64 fired;
+    Uint64 cancelled;
+    Uint64 cascaded;            // Timers moved down a level
+    Uint64 full;                // Schedules refused: pool exhausted
+    int active;
+    int peak;
+    int retired;                // Nodes whose generations ran out
+} TimerWheelStats;
+
+typedef struct {
+    Uint32 now;                 // Current tick
+    int heads[TIMER_WHEEL_BUCKETS];
+    TimerNode nodes[TIMER_WHEEL_MAX];
+    int free_head;
+    TimerWheelStats stats;
+} TimerWheel;
+
+void timer_wheel_init(TimerWheel* wheel);
+void timer_wheel_clear(TimerWheel* wheel);  // Cancels everything without firing
+
+// Fire fn(userdata, arg) delay ticks from now (at least 1, at most
+// TIMER_WHEEL_MAX_DELAY). TIMER_NONE when the pool is exhausted.
+TimerHandle timer_wheel_schedule(TimerWheel* wheel, Uint32 delay, TimerFn fn, void* userdata, int arg);
+
+// False if the timer already fired or was cancelled
+bool timer_wheel_cancel(TimerWheel* wheel, TimerHandle handle);
+bool timer_wheel_pending(const TimerWheel* wheel, TimerHandle handle);
+Uint32 timer_wheel_remaining(const TimerWheel* wheel, TimerHandle handle);   // 0 if not pending
+
+// Move time forward one tick and fire the timers due on it
+void timer_wheel_tick(TimerWheel* wheel);
+
+TimerWheelStats timer_wheel_get_stats(const TimerWheel* wheel);
+
+#endif // TIMER_WHEEL_H